@@ -0,0 +1,315 @@
+//Renders the binary logs of SC2API::EventLog as text or CSV. Standalone, so logs copied off a bot machine decode on
+//any Linux box without the game or the API:
+//
+//  g++ -std=c++14 -O2 -I.. -I../ZyCore EventLogDecoder.cpp -o sc2api-eventlog
+//  sc2api-eventlog [--csv] [--event Name] events.bin
+//
+//Text prints one line per event with the text of its format; CSV prints time, event name and the field values, with
+//points split into x and y columns. --event keeps one event, and in CSV mode adds a header row with its field names.
+
+#include "SC2API/include/SC2APIEventLogFormat.h"
+#include <zycore/BinaryStream.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace SC2API;
+
+namespace
+{
+	struct EventField
+	{
+		EventFieldType Type;
+		std::string Name;
+	};
+
+	struct EventFormat
+	{
+		std::string Name;
+		std::string Text;
+		std::vector<EventField> Fields;
+	};
+
+	struct Options
+	{
+		bool Csv = false;
+		std::string Event;
+		std::string Path;
+	};
+
+	std::string ReadString(zycore::IBinaryStream& in)
+	{
+		uint16_t length;
+		in >> length;
+		std::string text(length, '\0');
+		if (length != 0)
+		{
+			in.rawRead(in.rpos(), length, reinterpret_cast<uint8_t*>(&text[0]));
+		}
+		in.rpos(in.rpos() + length);
+		return text;
+	}
+
+	std::string FormatNumber(double value)
+	{
+		char text[32];
+		std::snprintf(text, sizeof(text), "%.6g", value);
+		return text;
+	}
+
+	//Reads one field; points give two values, so CSV gets a column per coordinate
+	std::vector<std::string> ReadField(zycore::IBinaryStream& in, EventFieldType type, const std::vector<std::string>& unitTypes)
+	{
+		switch (type)
+		{
+		case EventFieldType::Bool: { uint8_t value; in >> value; return{ value != 0 ? "true" : "false" }; }
+		case EventFieldType::Int32: { int32_t value; in >> value; return{ std::to_string(value) }; }
+		case EventFieldType::UInt32: { uint32_t value; in >> value; return{ std::to_string(value) }; }
+		case EventFieldType::Int64: { int64_t value; in >> value; return{ std::to_string(value) }; }
+		case EventFieldType::UInt64: { uint64_t value; in >> value; return{ std::to_string(value) }; }
+		case EventFieldType::Float: { float value; in >> value; return{ FormatNumber(value) }; }
+		case EventFieldType::Double: { double value; in >> value; return{ FormatNumber(value) }; }
+		case EventFieldType::Unit:
+		{
+			uint32_t id;
+			in >> id;
+			return{ id != 0 ? std::to_string(id) : "none" };
+		}
+		case EventFieldType::UnitType:
+		{
+			uint16_t id;
+			in >> id;
+			return{ id < unitTypes.size() ? unitTypes[id] : "Invalid" };
+		}
+		case EventFieldType::Point:
+		{
+			double x, y;
+			in >> x >> y;
+			return{ FormatNumber(x), FormatNumber(y) };
+		}
+		default:
+			//Sizes of unknown types are unknown too, so nothing after them can be read
+			throw std::runtime_error("unknown field type " + std::to_string(static_cast<int>(type)));
+		}
+	}
+
+	std::string RenderText(const EventFormat& format, const std::vector<std::vector<std::string>>& values)
+	{
+		const auto render = [](const EventField& field, const std::vector<std::string>& value)
+		{
+			if (field.Type == EventFieldType::Point)
+			{
+				return "(" + value[0] + ", " + value[1] + ")";
+			}
+			if (field.Type == EventFieldType::Unit && value[0] != "none")
+			{
+				return "Unit " + value[0];
+			}
+			return value[0];
+		};
+		std::string line;
+		if (format.Text.empty())
+		{
+			line = format.Name;
+			for (size_t i = 0; i < format.Fields.size(); ++i)
+			{
+				line += " " + format.Fields[i].Name + "=" + render(format.Fields[i], values[i]);
+			}
+			return line;
+		}
+		size_t field = 0;
+		for (size_t i = 0; i < format.Text.size(); ++i)
+		{
+			if (format.Text.compare(i, 2, "{}") == 0 && field < format.Fields.size())
+			{
+				line += render(format.Fields[field], values[field]);
+				++field;
+				++i;
+			}
+			else
+			{
+				line += format.Text[i];
+			}
+		}
+		return line;
+	}
+
+	std::string EscapeCsv(const std::string& value)
+	{
+		if (value.find_first_of(",\"\n") == std::string::npos)
+		{
+			return value;
+		}
+		std::string escaped = "\"";
+		for (const char c : value)
+		{
+			escaped += c;
+			if (c == '"')
+			{
+				escaped += '"';
+			}
+		}
+		return escaped + "\"";
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--csv") == 0)
+			{
+				options.Csv = true;
+			}
+			else if (std::strcmp(argv[i], "--event") == 0 && i + 1 < argc)
+			{
+				options.Event = argv[++i];
+			}
+			else if (argv[i][0] != '-' && options.Path.empty())
+			{
+				options.Path = argv[i];
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return !options.Path.empty();
+	}
+
+	int Decode(const Options& options, zycore::IBinaryStream& in, size_t size)
+	{
+		uint32_t magic;
+		uint16_t version, unitTypeCount;
+		in >> magic >> version >> unitTypeCount;
+		if (magic != EventLogMagic || version != EventLogVersion)
+		{
+			std::fprintf(stderr, "%s: not an event log of version %u\n", options.Path.c_str(), static_cast<unsigned>(EventLogVersion));
+			return 1;
+		}
+		std::vector<std::string> unitTypes;
+		for (uint16_t i = 0; i < unitTypeCount; ++i)
+		{
+			unitTypes.push_back(ReadString(in));
+		}
+
+		std::unordered_map<uint16_t, EventFormat> formats;
+		double time = 0.0;
+		bool headerWritten = false;
+		while (in.rpos() < size)
+		{
+			const size_t offset = in.rpos();
+			uint16_t id;
+			in >> id;
+			if (id == static_cast<uint16_t>(EventRecordId::Format))
+			{
+				uint16_t formatId;
+				uint8_t count;
+				in >> formatId;
+				EventFormat& format = formats[formatId];
+				format.Name = ReadString(in);
+				format.Text = ReadString(in);
+				in >> count;
+				format.Fields.clear();
+				for (uint8_t i = 0; i < count; ++i)
+				{
+					uint8_t type;
+					in >> type;
+					format.Fields.push_back(EventField{ static_cast<EventFieldType>(type), ReadString(in) });
+				}
+				continue;
+			}
+			if (id == static_cast<uint16_t>(EventRecordId::Time))
+			{
+				in >> time;
+				continue;
+			}
+			if (id == static_cast<uint16_t>(EventRecordId::Gap))
+			{
+				uint32_t blocks;
+				in >> blocks;
+				std::fprintf(stderr, "warning: %u blocks of events dropped before %.3f\n", blocks, time);
+				continue;
+			}
+			const auto it = formats.find(id);
+			if (it == formats.end())
+			{
+				std::fprintf(stderr, "%s: unknown event id %u at offset %zu\n", options.Path.c_str(), static_cast<unsigned>(id), offset);
+				return 1;
+			}
+			const EventFormat& format = it->second;
+			std::vector<std::vector<std::string>> values;
+			for (const EventField& field : format.Fields)
+			{
+				values.push_back(ReadField(in, field.Type, unitTypes));
+			}
+			if (!options.Event.empty() && format.Name != options.Event)
+			{
+				continue;
+			}
+			if (!options.Csv)
+			{
+				std::printf("[%10.3f] %s: %s\n", time, format.Name.c_str(), RenderText(format, values).c_str());
+				continue;
+			}
+			if (!options.Event.empty() && !headerWritten)
+			{
+				std::string header = "time,event";
+				for (const EventField& field : format.Fields)
+				{
+					const std::string name = EscapeCsv(field.Name);
+					header += field.Type == EventFieldType::Point ? "," + name + ".x," + name + ".y" : "," + name;
+				}
+				std::printf("%s\n", header.c_str());
+				headerWritten = true;
+			}
+			std::string row = FormatNumber(time) + "," + EscapeCsv(format.Name);
+			for (const std::vector<std::string>& value : values)
+			{
+				for (const std::string& column : value)
+				{
+					row += "," + EscapeCsv(column);
+				}
+			}
+			std::printf("%s\n", row.c_str());
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::fprintf(stderr, "usage: %s [--csv] [--event Name] file\n", argv[0]);
+		return 2;
+	}
+	std::ifstream file(options.Path, std::ios::in | std::ios::binary);
+	if (!file)
+	{
+		std::fprintf(stderr, "%s: cannot open\n", options.Path.c_str());
+		return 1;
+	}
+	zycore::IBinaryStream::Buffer buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	zycore::IBinaryStream in(&buffer);
+	try
+	{
+		return Decode(options, in, buffer.size());
+	}
+	catch (const zycore::OutOfBounds&)
+	{
+		//A bot that crashed leaves the last block cut off; everything before it has been printed
+		std::fprintf(stderr, "%s: truncated at offset %zu\n", options.Path.c_str(), static_cast<size_t>(in.rpos()));
+		return 1;
+	}
+	catch (const std::exception& error)
+	{
+		std::fprintf(stderr, "%s: %s\n", options.Path.c_str(), error.what());
+		return 1;
+	}
+}
@@ -14,5 +14,8 @@ extern "C"
 	__declspec(dllexport) void __cdecl CleanupAI()
 	{
 		ExampleAI::GameInstance::freeInstance();
+
+		//Writes the pending lines; the logger thread must not outlive the DLL
+		Logger::Get().Stop();
 	}
 }
\ No newline at end of file
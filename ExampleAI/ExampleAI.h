@@ -14,47 +14,47 @@ namespace ExampleAI
 
         void OnUnitCreated(Unit eventUnit, int eventPlayerId)
         {
-            LogLoader("Unit is created: " + eventUnit.ToString());
+            SC2API_LOG("Unit is created: ", eventUnit, " (", eventUnit.GetType(), ", player ", eventUnit.GetOwner(), ") at ", eventUnit.GetPosition());
         }
 
         void OnUnitDestroyed(Unit eventUnit, Optional<Unit> killerUnit)
         {
             if (killerUnit.hasValue())
             {
-                LogLoader("Unit " + eventUnit.ToString() + " is killed by " + killerUnit.value().ToString());
+                SC2API_LOG(eventUnit, " (", eventUnit.GetType(), ", player ", eventUnit.GetOwner(), ") is killed by ", killerUnit.value(), " (", killerUnit.value().GetType(), ", player ", killerUnit.value().GetOwner(), ")");
             }
             else
             {
-                LogLoader("Unit " + eventUnit.ToString() + " is destroyed");
+                SC2API_LOG(eventUnit, " (", eventUnit.GetType(), ", player ", eventUnit.GetOwner(), ") is destroyed");
             }
         }
 
         void OnUnitEnterVision(Unit eventUnit)
         {
-            LogLoader("Unit enters vision: " + eventUnit.ToString());
+            SC2API_LOG("Unit enters vision: ", eventUnit, " (", eventUnit.GetType(), ", player ", eventUnit.GetOwner(), ") at ", eventUnit.GetPosition());
         }
 
         void OnUnitLeaveVision(Unit eventUnit)
         {
-            LogLoader("Unit leaves vision: " + eventUnit.ToString());
+            SC2API_LOG("Unit leaves vision: ", eventUnit, " (", eventUnit.GetType(), ", player ", eventUnit.GetOwner(), ") at ", eventUnit.GetPosition());
         }
 
         GameInstance()
         {
-            LogLoader("Game has started.");
+            SC2API_LOG("Game has started.");
 
             Unit::SignalUnitCreated().connect(this, &GameInstance::OnUnitCreated);
             Unit::SignalUnitDestroyed().connect(this, &GameInstance::OnUnitDestroyed);
             Unit::SignalUnitEnterVision().connect(this, &GameInstance::OnUnitEnterVision);
             Unit::SignalUnitLeaveVision().connect(this, &GameInstance::OnUnitLeaveVision);
 
-            LogLoader("Player 1 race: " + PlayerLobbyRace(1));
-            //LogLoader("Player 2 race: " + PlayerLobbyRace(2));//TODO crash when not available
+            SC2API_LOG("Player 1 race: ", PlayerLobbyRace(1));
+            //SC2API_LOG("Player 2 race: ", PlayerLobbyRace(2));//TODO crash when not available
         }
 
         ~GameInstance()
         {
-            LogLoader("Game has ended.");
+            SC2API_LOG("Game has ended.");
         }
     };
 }
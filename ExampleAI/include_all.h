@@ -7,6 +7,24 @@
 #include "SC2API/include/SC2APIOrder.h"
 #include "SC2API/include/SC2APIPlayer.h"
 #include "SC2API/include/SC2APIPoint.h"
+#include "SC2API/include/SC2APIPointBatch.h"
+#include "SC2API/include/SC2APIInfluenceMap.h"
+#include "SC2API/include/SC2APIPathing.h"
+#include "SC2API/include/SC2APIFlowField.h"
+#include "SC2API/include/SC2APICombatSimulator.h"
+#include "SC2API/include/SC2APIUnitStats.h"
+#include "SC2API/include/SC2APIBuildOrder.h"
+#include "SC2API/include/SC2APIWorkerPool.h"
+#include "SC2API/include/SC2APITechTree.h"
+#include "SC2API/include/SC2APIHandleMap.h"
+#include "SC2API/include/SC2APIUnitMemory.h"
+#include "SC2API/include/SC2APIUnitMotion.h"
+#include "SC2API/include/SC2APIEconomy.h"
+#include "SC2API/include/SC2APIProfiler.h"
+#include "SC2API/include/SC2APITraceWriter.h"
+#include "SC2API/include/SC2APICallCounters.h"
 #include "SC2API/include/SC2APIUnitGroup.h"
 #include "SC2API/include/SC2APICommand.h"
-#include "SC2API/include/Utils.h"
\ No newline at end of file
+#include "SC2API/include/Utils.h"
+#include "SC2API/include/SC2APILogger.h"
+#include "SC2API/include/SC2APIEventLog.h"
\ No newline at end of file
@@ -0,0 +1,1134 @@
+#include "SC2APIHeadless.h"
+#include "SC2API/include/SC2APIGame.h"
+#include "SC2API/include/SC2APIPlayer.h"
+#include "SC2API/include/SC2APIUnitGroup.h"
+#include "SC2API/include/SC2APIOrder.h"
+#include "SC2API/include/SC2APICommand.h"
+#include "SC2API/include/SC2APIUnitStats.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/Cheats.h"
+#include "SC2API/include/Utils.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace SC2API
+{
+	class Order_Impl
+	{
+	public:
+		enum TargetType
+		{
+			NoTarget,
+			PointTarget,
+			UnitTarget,
+		};
+
+		Command OrderCommand = {};
+		TargetType Target = NoTarget;
+		Point TargetPoint = {};
+		Unit TargetUnit;
+
+		static const Order_Impl& Of(const Order& order)
+		{
+			return *order._impl;
+		}
+	};
+
+	#pragma region World
+	namespace
+	{
+		struct UnitData
+		{
+			std::string Type;
+			UnitTypeId TypeId = UnitTypeId::Invalid;
+			int Owner = 0;
+			Point Position = {};
+			double Life = 0.0;
+			double Shield = 0.0;
+			double Energy = 0.0;
+			double Cooldown = 0.0;
+			bool UnderConstruction = false;
+			bool Visible = false;
+			bool OrderStarted = false;
+			std::deque<Order> Orders;
+			Optional<Unit> LastAttacker;
+		};
+
+		struct Timer
+		{
+			double Due;
+			double Interval;
+			bool Loop;
+			bool Expired;
+			std::unique_ptr<Signal<>> Fired;
+		};
+
+		struct RegisteredTest
+		{
+			std::string Name;
+			Creator<UnitTestBase> Create;
+		};
+
+		struct World
+		{
+			Headless::Settings Config;
+			double Time = 0.0;
+			uint64_t Ticks = 0;
+			HandleId NextId = 1;
+			std::map<HandleId, UnitData> Units;
+			std::vector<Timer> Timers;
+			//LogLoader is called from the logger thread
+			std::mutex LogMutex;
+			std::vector<std::string> Log;
+			std::vector<RegisteredTest> Tests;
+		};
+
+		World& GetWorld()
+		{
+			static World world;
+			return world;
+		}
+
+		UnitData* Find(const Unit& unit)
+		{
+			World& world = GetWorld();
+			const auto it = world.Units.find(unit.id);
+			return it != world.Units.end() ? &it->second : nullptr;
+		}
+
+		UnitData* FindAccessible(const Unit& unit)
+		{
+			UnitData* data = Find(unit);
+			return data != nullptr && data->Visible ? data : nullptr;
+		}
+
+		void WriteLog(std::string line)
+		{
+			World& world = GetWorld();
+			std::lock_guard<std::mutex> lock(world.LogMutex);
+			if (world.Config.PrintLog)
+			{
+				std::cout << line << std::endl;
+			}
+			world.Log.push_back(std::move(line));
+		}
+
+		double Distance(const Point& a, const Point& b)
+		{
+			return std::sqrt((a.X - b.X) * (a.X - b.X) + (a.Y - b.Y) * (a.Y - b.Y));
+		}
+
+		const UnitTypeStats* GetStats(const UnitData& data)
+		{
+			return data.TypeId != UnitTypeId::Invalid ? &GetUnitStats(data.TypeId) : nullptr;
+		}
+
+		bool IsResource(const std::string& type)
+		{
+			return type.find("MineralField") != std::string::npos || type.find("VespeneGeyser") != std::string::npos
+				|| type.find("SpacePlatformGeyser") != std::string::npos || type.find("RichVespeneGeyser") != std::string::npos;
+		}
+
+		bool IsEnemy(int owner)
+		{
+			const World& world = GetWorld();
+			return owner != 0 && owner != world.Config.LocalPlayer;
+		}
+
+		bool AreHostile(const UnitData& a, const UnitData& b)
+		{
+			return a.Owner != 0 && b.Owner != 0 && a.Owner != b.Owner;
+		}
+
+		UnitFilterFlag GetFlags(const UnitData& data)
+		{
+			const World& world = GetWorld();
+			UnitFilterFlag flags = UnitFilterFlag::Visible;
+			const UnitTypeStats* stats = GetStats(data);
+			if (stats != nullptr)
+			{
+				flags |= stats->Attributes;
+				if (stats->Shield > 0.0f)
+				{
+					flags |= UnitFilterFlag::CanHaveShields;
+				}
+			}
+			else if (IsResource(data.Type))
+			{
+				flags |= UnitFilterFlag::Ground | UnitFilterFlag::Structure | UnitFilterFlag::RawResource;
+			}
+			if (data.Owner == 0)
+			{
+				flags |= UnitFilterFlag::Neutral;
+			}
+			else
+			{
+				flags |= UnitFilterFlag::Player;
+				flags |= data.Owner == world.Config.LocalPlayer ? UnitFilterFlag::Self : UnitFilterFlag::Enemy;
+			}
+			if (data.UnderConstruction)
+			{
+				flags |= UnitFilterFlag::UnderConstruction;
+			}
+			if (data.Shield > 0.0)
+			{
+				flags |= UnitFilterFlag::HasShields;
+			}
+			if (data.Energy > 0.0)
+			{
+				flags |= UnitFilterFlag::HasEnergy;
+			}
+			return flags;
+		}
+
+		bool MatchesFlags(const UnitData& data, UnitFilterFlag requiredFlags, UnitFilterFlag excludedFlags)
+		{
+			const UnitFilterFlag flags = GetFlags(data);
+			return (flags & requiredFlags) == requiredFlags && !(flags & excludedFlags);
+		}
+
+		bool SeesPosition(int player, const Point& position)
+		{
+			const World& world = GetWorld();
+			for (const auto& entry : world.Units)
+			{
+				if (entry.second.Owner == player && Distance(entry.second.Position, position) <= world.Config.SightRange)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool ComputeVisible(const UnitData& data)
+		{
+			return !IsEnemy(data.Owner) || SeesPosition(GetWorld().Config.LocalPlayer, data.Position);
+		}
+
+		//Moves towards a point; returns true once there
+		bool MoveTowards(UnitData& data, const Point& target, double range, double seconds)
+		{
+			const UnitTypeStats* stats = GetStats(data);
+			const double distance = Distance(data.Position, target);
+			if (distance <= range)
+			{
+				return true;
+			}
+			if (stats != nullptr && stats->Is(UnitFilterFlag::Structure))
+			{
+				return false;
+			}
+			const double step = std::min(GetWorld().Config.UnitSpeed * seconds, distance - range);
+			data.Position.X += (target.X - data.Position.X) / distance * step;
+			data.Position.Y += (target.Y - data.Position.Y) / distance * step;
+			return Distance(data.Position, target) <= range + 1e-9;
+		}
+
+		//Weapon of the attacker against the target: damage, cooldown and range
+		bool GetWeapon(const UnitData& attacker, const UnitData& target, double& damage, double& cooldown, double& range)
+		{
+			const UnitTypeStats* stats = GetStats(attacker);
+			const UnitTypeStats* targetStats = GetStats(target);
+			if (stats == nullptr)
+			{
+				return false;
+			}
+			const bool air = targetStats != nullptr && targetStats->Is(UnitFilterFlag::Air);
+			damage = air ? stats->AirDamage : stats->GroundDamage;
+			cooldown = air ? stats->AirCooldown : stats->GroundCooldown;
+			//Ranges are between unit edges in the game; half a cell stands in for the radii
+			range = (air ? stats->AirRange : stats->GroundRange) + 0.5;
+			return damage > 0.0 && cooldown > 0.0;
+		}
+
+		//Attacks or closes in on the target; returns false if the unit cannot attack it
+		bool Attack(HandleId id, UnitData& data, HandleId /*targetId*/, UnitData& target, double seconds, bool chase)
+		{
+			double damage, cooldown, range;
+			if (!GetWeapon(data, target, damage, cooldown, range))
+			{
+				return false;
+			}
+			if (Distance(data.Position, target.Position) > range)
+			{
+				if (chase)
+				{
+					MoveTowards(data, target.Position, range, seconds);
+				}
+				return chase;
+			}
+			if (data.Cooldown <= 0.0)
+			{
+				const UnitTypeStats* targetStats = GetStats(target);
+				double dealt = std::max(0.5, damage - (targetStats != nullptr ? targetStats->Armor : 0.0));
+				const double absorbed = std::min(target.Shield, dealt);
+				target.Shield -= absorbed;
+				target.Life -= dealt - absorbed;
+				Unit attacker;
+				attacker.id = id;
+				target.LastAttacker = attacker;
+				data.Cooldown = cooldown;
+			}
+			return true;
+		}
+
+		//Nearest hostile unit the unit can attack within the distance, lowest handle first on ties
+		HandleId FindTarget(HandleId id, const UnitData& data, double within)
+		{
+			World& world = GetWorld();
+			HandleId best = 0;
+			double bestDistance = within;
+			for (const auto& entry : world.Units)
+			{
+				double damage, cooldown, range;
+				if (entry.first == id || !AreHostile(data, entry.second) || !GetWeapon(data, entry.second, damage, cooldown, range))
+				{
+					continue;
+				}
+				const double distance = Distance(data.Position, entry.second.Position);
+				if (distance <= std::max(bestDistance, range) && (best == 0 || distance < bestDistance))
+				{
+					best = entry.first;
+					bestDistance = distance;
+				}
+			}
+			return best;
+		}
+
+		void ExecuteOrders(HandleId id, UnitData& data, double seconds)
+		{
+			World& world = GetWorld();
+			data.Cooldown = std::max(0.0, data.Cooldown - seconds);
+			if (data.UnderConstruction)
+			{
+				return;
+			}
+			if (data.Orders.empty())
+			{
+				//Idle units return fire within weapon range
+				const HandleId target = FindTarget(id, data, 0.0);
+				if (target != 0)
+				{
+					Attack(id, data, target, world.Units.at(target), seconds, false);
+				}
+				return;
+			}
+
+			const Order_Impl& order = Order_Impl::Of(data.Orders.front());
+			const std::string& ability = order.OrderCommand.Ability;
+			bool done = false;
+			if (ability == Abils::Stop)
+			{
+				data.Orders.clear();
+				return;
+			}
+			else if (ability == Abils::Move)
+			{
+				if (order.Target == Order_Impl::UnitTarget)
+				{
+					const UnitData* target = Find(order.TargetUnit);
+					done = target == nullptr || MoveTowards(data, target->Position, 1.0, seconds);
+				}
+				else
+				{
+					done = order.Target == Order_Impl::NoTarget || MoveTowards(data, order.TargetPoint, 0.0, seconds);
+				}
+			}
+			else if (ability == Abils::Attack)
+			{
+				if (order.Target == Order_Impl::UnitTarget)
+				{
+					UnitData* target = Find(order.TargetUnit);
+					done = target == nullptr || !Attack(id, data, order.TargetUnit.id, *target, seconds, true);
+				}
+				else
+				{
+					//Attack move: fight anything in sight on the way
+					const HandleId target = FindTarget(id, data, world.Config.SightRange);
+					if (target != 0)
+					{
+						Attack(id, data, target, world.Units.at(target), seconds, true);
+					}
+					else
+					{
+						done = order.Target == Order_Impl::NoTarget || MoveTowards(data, order.TargetPoint, 0.0, seconds);
+					}
+				}
+			}
+			else
+			{
+				//Abilities without simulation stay current for one tick
+				done = data.OrderStarted;
+			}
+			data.OrderStarted = true;
+			if (done)
+			{
+				data.Orders.pop_front();
+				data.OrderStarted = false;
+			}
+		}
+
+		void RemoveUnit(HandleId id, Optional<Unit> killer)
+		{
+			World& world = GetWorld();
+			if (world.Units.erase(id) == 0)
+			{
+				return;
+			}
+			Unit unit;
+			unit.id = id;
+			Unit::SignalUnitDestroyed().emit(unit, killer);
+		}
+
+		void UpdateVision()
+		{
+			World& world = GetWorld();
+			std::vector<Unit> entered;
+			std::vector<Unit> left;
+			for (auto& entry : world.Units)
+			{
+				const bool visible = ComputeVisible(entry.second);
+				if (visible != entry.second.Visible)
+				{
+					entry.second.Visible = visible;
+					Unit unit;
+					unit.id = entry.first;
+					(visible ? entered : left).push_back(unit);
+				}
+			}
+			for (const Unit& unit : left)
+			{
+				Unit::SignalUnitLeaveVision().emit(unit);
+			}
+			for (const Unit& unit : entered)
+			{
+				Unit::SignalUnitEnterVision().emit(unit);
+			}
+		}
+
+		void FireTimers()
+		{
+			World& world = GetWorld();
+			//By index: slots may create timers
+			for (size_t i = 0; i < world.Timers.size(); ++i)
+			{
+				if (world.Timers[i].Expired || world.Timers[i].Due > world.Time + 1e-9)
+				{
+					continue;
+				}
+				Timer& timer = world.Timers[i];
+				if (timer.Loop)
+				{
+					//At most once per tick, even if the interval is shorter
+					timer.Due = std::max(timer.Due + timer.Interval, world.Time + 1e-6);
+				}
+				else
+				{
+					timer.Expired = true;
+				}
+				Signal<>& fired = *timer.Fired;
+				fired.emit();
+			}
+		}
+	}
+	#pragma endregion
+
+	#pragma region Headless
+	namespace Headless
+	{
+		void Reset(const Settings& settings)
+		{
+			World& world = GetWorld();
+			world.Config = settings;
+			world.Time = 0.0;
+			world.Ticks = 0;
+			world.NextId = 1;
+			world.Units.clear();
+			world.Timers.clear();
+			{
+				std::lock_guard<std::mutex> lock(world.LogMutex);
+				world.Log.clear();
+			}
+			world.Tests.clear();
+		}
+
+		void StartMatch()
+		{
+			SignalMatchStarted().emit();
+			SignalRegisterUnitTests().emit();
+		}
+
+		void EndMatch()
+		{
+			SignalMatchEnded().emit();
+		}
+
+		void Step(double seconds)
+		{
+			World& world = GetWorld();
+			world.Time += seconds;
+			++world.Ticks;
+
+			std::vector<HandleId> ids;
+			ids.reserve(world.Units.size());
+			for (const auto& entry : world.Units)
+			{
+				ids.push_back(entry.first);
+			}
+			for (const HandleId id : ids)
+			{
+				const auto it = world.Units.find(id);
+				if (it != world.Units.end())
+				{
+					ExecuteOrders(id, it->second, seconds);
+				}
+			}
+
+			std::vector<std::pair<HandleId, Optional<Unit>>> dead;
+			for (const auto& entry : world.Units)
+			{
+				if (entry.second.Life <= 0.0)
+				{
+					dead.emplace_back(entry.first, entry.second.LastAttacker);
+				}
+			}
+			for (const auto& entry : dead)
+			{
+				RemoveUnit(entry.first, entry.second);
+			}
+
+			UpdateVision();
+			FireTimers();
+		}
+
+		void Run(double seconds, double tick)
+		{
+			const double end = GetTime() + seconds - tick * 0.5;
+			while (GetTime() < end)
+			{
+				Step(tick);
+			}
+		}
+
+		double GetTime()
+		{
+			return GetWorld().Time;
+		}
+
+		uint64_t GetTickCount()
+		{
+			return GetWorld().Ticks;
+		}
+
+		Unit SpawnUnit(const std::string& unitType, Point position, int player, bool underConstruction)
+		{
+			World& world = GetWorld();
+			UnitData data;
+			data.Type = unitType;
+			const Optional<UnitTypeId> typeId = UnitTypeIdFromName(unitType);
+			data.TypeId = typeId.hasValue() ? typeId.value() : UnitTypeId::Invalid;
+			data.Owner = player;
+			data.Position = position;
+			const UnitTypeStats* stats = GetStats(data);
+			data.Life = stats != nullptr ? stats->Life : 100.0;
+			data.Shield = stats != nullptr ? stats->Shield : 0.0;
+			data.Energy = stats != nullptr && stats->Is(UnitFilterFlag::CanHaveEnergy) ? 50.0 : 0.0;
+			data.UnderConstruction = underConstruction;
+			data.Visible = ComputeVisible(data);
+
+			Unit unit;
+			unit.id = world.NextId++;
+			const bool visible = data.Visible;
+			world.Units.emplace(unit.id, std::move(data));
+			Unit::SignalUnitCreated().emit(unit, player);
+			if (visible && IsEnemy(player))
+			{
+				Unit::SignalUnitEnterVision().emit(unit);
+			}
+			return unit;
+		}
+
+		void FinishConstruction(const Unit& unit)
+		{
+			UnitData* data = Find(unit);
+			if (data != nullptr)
+			{
+				data->UnderConstruction = false;
+			}
+		}
+
+		void MorphUnit(const Unit& unit, const std::string& unitType)
+		{
+			UnitData* data = Find(unit);
+			if (data != nullptr)
+			{
+				data->Type = unitType;
+				const Optional<UnitTypeId> typeId = UnitTypeIdFromName(unitType);
+				data->TypeId = typeId.hasValue() ? typeId.value() : UnitTypeId::Invalid;
+			}
+		}
+
+		void KillUnit(const Unit& unit, Optional<Unit> killer)
+		{
+			RemoveUnit(unit.id, killer);
+		}
+
+		void SetLife(const Unit& unit, double life)
+		{
+			UnitData* data = Find(unit);
+			if (data != nullptr)
+			{
+				data->Life = life;
+			}
+		}
+
+		void SetPosition(const Unit& unit, Point position)
+		{
+			UnitData* data = Find(unit);
+			if (data != nullptr)
+			{
+				data->Position = position;
+			}
+		}
+
+		std::vector<std::string> GetLog()
+		{
+			World& world = GetWorld();
+			std::lock_guard<std::mutex> lock(world.LogMutex);
+			return world.Log;
+		}
+
+		std::vector<UnitTestResult> RunUnitTests(const UnitTestFilter& filter, double tick)
+		{
+			World& world = GetWorld();
+			//Regional tests run side by side from the town position on; the others run alone
+			UnitTestScheduler scheduler(GetUnitTestRegionGrid(world.Config.TownPosition, 4, 2, 40.0), tick);
+			for (const RegisteredTest& entry : world.Tests)
+			{
+				scheduler.Add(entry.Name.c_str(), entry.Create);
+			}
+			scheduler.SetFilter(filter);
+			scheduler.Run();
+			while (!scheduler.IsDone())
+			{
+				Step(tick);
+			}
+			return scheduler.GetResults();
+		}
+	}
+	#pragma endregion
+
+	#pragma region Game, player and utils
+	bool GameIsReplay()
+	{
+		return false;
+	}
+
+	bool GameIsSinglePlayer()
+	{
+		return GetWorld().Config.SinglePlayer;
+	}
+
+	void OutputScreen(std::string Message)
+	{
+		WriteLog(std::move(Message));
+	}
+
+	Signal<>& SignalMatchStarted()
+	{
+		static Signal<> signal;
+		return signal;
+	}
+
+	Signal<>& SignalMatchEnded()
+	{
+		static Signal<> signal;
+		return signal;
+	}
+
+	Signal<>& SignalTimer(double timeOut, bool loop)
+	{
+		World& world = GetWorld();
+		world.Timers.push_back(Timer{ world.Time + timeOut, timeOut, loop, false, std::unique_ptr<Signal<>>(new Signal<>()) });
+		return *world.Timers.back().Fired;
+	}
+
+	int PlayerLocal()
+	{
+		return GetWorld().Config.LocalPlayer;
+	}
+
+	std::string PlayerLocalRace()
+	{
+		return GetWorld().Config.LocalRace;
+	}
+
+	std::string PlayerLobbyRace(int inPlayer)
+	{
+		const World& world = GetWorld();
+		if (inPlayer == world.Config.LocalPlayer)
+		{
+			return world.Config.LocalRace;
+		}
+		return inPlayer == world.Config.EnemyPlayer ? world.Config.EnemyRace : std::string();
+	}
+
+	void LogLoader(std::string message)
+	{
+		WriteLog(std::move(message));
+	}
+	#pragma endregion
+
+	#pragma region Cheats
+	void CheatSetGameSpeed(float /*factor*/)
+	{
+		//The headless world runs as fast as it is stepped
+	}
+
+	Unit CheatCreateUnit(const std::string& inUnitType, Point inLocation)
+	{
+		return Headless::SpawnUnit(inUnitType, inLocation, GetWorld().Config.LocalPlayer);
+	}
+
+	void CheatRemoveUnit(const Unit& inUnit)
+	{
+		RemoveUnit(inUnit.id, Optional<Unit>());
+	}
+
+	void CheatSupply(int /*amount*/)
+	{
+		//Supply is not simulated
+	}
+	#pragma endregion
+
+	#pragma region Unit test system
+	void UnitTestBase::ReportError(std::string const& errorMessage)
+	{
+		WriteLog("ERROR: " + errorMessage);
+	}
+
+	Point GetTownCandidatePositionStandard()
+	{
+		return GetWorld().Config.TownPosition;
+	}
+
+	Signal<>& SignalRegisterUnitTests()
+	{
+		static Signal<> signal;
+		return signal;
+	}
+
+	void RegisterUnitTest(const char* name, Creator<UnitTestBase> unitTestCreator)
+	{
+		GetWorld().Tests.push_back(RegisteredTest{ name, std::move(unitTestCreator) });
+	}
+	#pragma endregion
+
+	#pragma region Point
+	std::string Point::ToString() const
+	{
+		std::ostringstream stream;
+		stream << "(" << X << ", " << Y << ")";
+		return stream.str();
+	}
+
+	double Point::Dist(const Point& pointA, const Point& pointB)
+	{
+		return Distance(pointA, pointB);
+	}
+	#pragma endregion
+
+	#pragma region Unit
+	bool Unit::IsAccessible() const
+	{
+		return FindAccessible(*this) != nullptr;
+	}
+
+	Optional<std::string> Unit::GetType() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		return data != nullptr ? Optional<std::string>(data->Type) : Optional<std::string>();
+	}
+
+	Optional<Point> Unit::GetPosition() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		return data != nullptr ? Optional<Point>(data->Position) : Optional<Point>();
+	}
+
+	int Unit::GetOwner() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		return data != nullptr ? data->Owner : -1;
+	}
+
+	bool Unit::IsOwnedByLocalPlayer() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		return data != nullptr && data->Owner == GetWorld().Config.LocalPlayer;
+	}
+
+	bool Unit::IsOwnedByEnemyPlayer() const
+	{
+		//Known even in fog of war, like the game
+		const UnitData* data = Find(*this);
+		return data != nullptr && IsEnemy(data->Owner);
+	}
+
+	Optional<double> Unit::GetLife() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		return data != nullptr ? Optional<double>(data->Life) : Optional<double>();
+	}
+
+	Optional<double> Unit::GetShield() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		return data != nullptr ? Optional<double>(data->Shield) : Optional<double>();
+	}
+
+	Optional<double> Unit::GetEnergy() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		return data != nullptr ? Optional<double>(data->Energy) : Optional<double>();
+	}
+
+	void Unit::SendOrder(Order& order)
+	{
+		UnitData* data = FindAccessible(*this);
+		if (data != nullptr && data->Owner == GetWorld().Config.LocalPlayer)
+		{
+			data->Orders.clear();
+			data->Orders.push_back(order);
+			data->OrderStarted = false;
+		}
+	}
+
+	void Unit::QueueOrder(Order& order)
+	{
+		UnitData* data = FindAccessible(*this);
+		if (data != nullptr && data->Owner == GetWorld().Config.LocalPlayer)
+		{
+			data->Orders.push_back(order);
+		}
+	}
+
+	Optional<Order> Unit::GetCurrentOrder() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		if (data == nullptr || data->Orders.empty())
+		{
+			return{};
+		}
+		return data->Orders.front();
+	}
+
+	std::string Unit::ToString() const
+	{
+		const UnitData* data = FindAccessible(*this);
+		std::ostringstream stream;
+		stream << "Unit " << id;
+		if (data != nullptr)
+		{
+			stream << " (" << data->Type << ", player " << data->Owner << ")";
+		}
+		return stream.str();
+	}
+
+	Signal<Unit, int>& Unit::SignalUnitCreated()
+	{
+		static Signal<Unit, int> signal;
+		return signal;
+	}
+
+	Signal<Unit, Optional<Unit>>& Unit::SignalUnitDestroyed()
+	{
+		static Signal<Unit, Optional<Unit>> signal;
+		return signal;
+	}
+
+	Signal<Unit>& Unit::SignalUnitEnterVision()
+	{
+		static Signal<Unit> signal;
+		return signal;
+	}
+
+	Signal<Unit>& Unit::SignalUnitLeaveVision()
+	{
+		static Signal<Unit> signal;
+		return signal;
+	}
+
+	Signal<Unit, std::string>& Unit::SignalUnitTrainingStarted()
+	{
+		static Signal<Unit, std::string> signal;
+		return signal;
+	}
+
+	Signal<Unit, std::string>& Unit::SignalUnitTrainingPaused()
+	{
+		static Signal<Unit, std::string> signal;
+		return signal;
+	}
+
+	Signal<Unit, std::string>& Unit::SignalUnitTrainingResumed()
+	{
+		static Signal<Unit, std::string> signal;
+		return signal;
+	}
+
+	Signal<Unit, std::string>& Unit::SignalUnitTrainingCanceled()
+	{
+		static Signal<Unit, std::string> signal;
+		return signal;
+	}
+
+	Signal<Unit, Unit>& Unit::SignalUnitTrainingCompleted()
+	{
+		static Signal<Unit, Unit> signal;
+		return signal;
+	}
+
+	bool operator < (const Unit& lhs, const Unit& rhs)
+	{
+		return lhs.id < rhs.id;
+	}
+
+	bool operator > (const Unit& lhs, const Unit& rhs)
+	{
+		return lhs.id > rhs.id;
+	}
+
+	bool operator == (const Unit& lhs, const Unit& rhs)
+	{
+		return lhs.id == rhs.id;
+	}
+
+	bool operator != (const Unit& lhs, const Unit& rhs)
+	{
+		return lhs.id != rhs.id;
+	}
+	#pragma endregion
+
+	#pragma region UnitGroup
+	std::string UnitGroup::ToString() const
+	{
+		std::ostringstream stream;
+		stream << "UnitGroup [";
+		for (const Unit& unit : Container)
+		{
+			stream << (&unit == &*Container.begin() ? "" : ", ") << unit.id;
+		}
+		stream << "]";
+		return stream.str();
+	}
+
+	void UnitGroup::Add(Unit inUnit)
+	{
+		Container.insert(inUnit);
+	}
+
+	void UnitGroup::Add(const UnitGroup& inUnitGroup)
+	{
+		Container.insert(inUnitGroup.Container.begin(), inUnitGroup.Container.end());
+	}
+
+	void UnitGroup::Remove(Unit inUnit)
+	{
+		Container.erase(inUnit);
+	}
+
+	void UnitGroup::Remove(const UnitGroup& inUnitGroup)
+	{
+		for (const Unit& unit : inUnitGroup.Container)
+		{
+			Container.erase(unit);
+		}
+	}
+
+	bool UnitGroup::Has(Unit inUnit) const
+	{
+		return Container.count(inUnit) != 0;
+	}
+
+	int UnitGroup::Count() const
+	{
+		return static_cast<int>(Container.size());
+	}
+
+	Optional<Unit> UnitGroup::First() const
+	{
+		if (Container.empty())
+		{
+			return{};
+		}
+		return *Container.begin();
+	}
+
+	void UnitGroup::SendOrder(Order& order) const
+	{
+		for (Unit unit : Container)
+		{
+			unit.SendOrder(order);
+		}
+	}
+
+	void UnitGroup::QueueOrder(Order& order) const
+	{
+		for (Unit unit : Container)
+		{
+			unit.QueueOrder(order);
+		}
+	}
+
+	void UnitGroup::Filter(UnitFilterFlag requiredFlags, UnitFilterFlag excludedFlags)
+	{
+		for (auto it = Container.begin(); it != Container.end();)
+		{
+			const UnitData* data = FindAccessible(*it);
+			it = data != nullptr && MatchesFlags(*data, requiredFlags, excludedFlags) ? std::next(it) : Container.erase(it);
+		}
+	}
+
+	void UnitGroup::Filter(const std::set<std::string>& possibleUnitTypes)
+	{
+		for (auto it = Container.begin(); it != Container.end();)
+		{
+			const UnitData* data = FindAccessible(*it);
+			it = data != nullptr && possibleUnitTypes.count(data->Type) != 0 ? std::next(it) : Container.erase(it);
+		}
+	}
+
+	UnitGroup UnitGroup::GetAccessibleUnits()
+	{
+		return GetAccessibleUnits(UnitFilterFlag::Null);
+	}
+
+	UnitGroup UnitGroup::GetAccessibleUnits(UnitFilterFlag requiredFlags, UnitFilterFlag excludedFlags)
+	{
+		UnitGroup group;
+		for (const auto& entry : GetWorld().Units)
+		{
+			if (entry.second.Visible && MatchesFlags(entry.second, requiredFlags, excludedFlags))
+			{
+				Unit unit;
+				unit.id = entry.first;
+				group.Container.insert(group.Container.end(), unit);
+			}
+		}
+		return group;
+	}
+
+	UnitGroup UnitGroup::GetUnitsOfType(std::string unitType)
+	{
+		return GetUnitsOfType(std::set<std::string>{ unitType }, UnitFilterFlag::Null);
+	}
+
+	UnitGroup UnitGroup::GetUnitsOfType(std::string unitType, UnitFilterFlag requiredFlags, UnitFilterFlag excludedFlags)
+	{
+		return GetUnitsOfType(std::set<std::string>{ unitType }, requiredFlags, excludedFlags);
+	}
+
+	UnitGroup UnitGroup::GetUnitsOfType(std::set<std::string> possibleUnitTypes)
+	{
+		return GetUnitsOfType(possibleUnitTypes, UnitFilterFlag::Null);
+	}
+
+	UnitGroup UnitGroup::GetUnitsOfType(const std::set<std::string>& possibleUnitTypes, UnitFilterFlag requiredFlags, UnitFilterFlag excludedFlags)
+	{
+		UnitGroup group = GetAccessibleUnits(requiredFlags, excludedFlags);
+		group.Filter(possibleUnitTypes);
+		return group;
+	}
+	#pragma endregion
+
+	#pragma region Order
+	Order Order::OrderWithNoTarget(Command command)
+	{
+		Order order;
+		order._impl->OrderCommand = command;
+		return order;
+	}
+
+	Order Order::OrderTargetingPoint(Command command, Point targetPoint)
+	{
+		Order order;
+		order._impl->OrderCommand = command;
+		order._impl->Target = Order_Impl::PointTarget;
+		order._impl->TargetPoint = targetPoint;
+		return order;
+	}
+
+	Order Order::OrderTargetingUnit(Command command, Unit targetUnit)
+	{
+		Order order;
+		order._impl->OrderCommand = command;
+		order._impl->Target = Order_Impl::UnitTarget;
+		order._impl->TargetUnit = targetUnit;
+		return order;
+	}
+
+	Optional<Point> Order::GetTargetPoint() const
+	{
+		if (_impl->Target == Order_Impl::PointTarget)
+		{
+			return _impl->TargetPoint;
+		}
+		if (_impl->Target == Order_Impl::UnitTarget)
+		{
+			return _impl->TargetUnit.GetPosition();
+		}
+		return{};
+	}
+
+	Order::Order()
+		: _impl(new Order_Impl())
+	{
+	}
+
+	Order::~Order()
+	{
+		delete _impl;
+	}
+
+	Order::Order(const Order& other)
+		: _impl(new Order_Impl(*other._impl))
+	{
+	}
+
+	Order::Order(Order&& src)
+		: _impl(src._impl)
+	{
+		src._impl = new Order_Impl();
+	}
+
+	Order& Order::operator= (const Order& other)
+	{
+		*_impl = *other._impl;
+		return *this;
+	}
+
+	Order& Order::operator= (Order&& src)
+	{
+		std::swap(_impl, src._impl);
+		return *this;
+	}
+
+	bool operator== (const Order& lhs, const Order& rhs)
+	{
+		return lhs._impl->OrderCommand.Ability == rhs._impl->OrderCommand.Ability
+			&& lhs._impl->OrderCommand.CommandIndex == rhs._impl->OrderCommand.CommandIndex
+			&& lhs._impl->Target == rhs._impl->Target
+			&& lhs._impl->TargetPoint.X == rhs._impl->TargetPoint.X
+			&& lhs._impl->TargetPoint.Y == rhs._impl->TargetPoint.Y
+			&& lhs._impl->TargetUnit == rhs._impl->TargetUnit;
+	}
+	#pragma endregion
+}
@@ -0,0 +1,112 @@
+/* Headless backend: an in-process stand-in for the SC2API binary, for running bots and tests without the game client.
+   Compile SC2APIHeadless.cpp and SignalObject.cpp into the program with SC2API_HEADLESS defined everywhere, instead of
+   linking SC2API.lib and zycore.lib. */
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIUnit.h"
+#include "SC2API/include/SC2APIPoint.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIUnitTestReport.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Control of the headless world. The world is deterministic: the same calls give the same game, tick for tick.
+	/// It simulates what the API exposes and little else. Units move in straight lines at one speed, fight with the
+	/// damage, cooldown and range of the unit stats table, and see enemies within a fixed sight range.
+	/// There is no terrain, collision, economy, production or research, so the training signals never fire.
+	/// </summary>
+	namespace Headless
+	{
+		struct Settings
+		{
+			int			LocalPlayer = 1;
+			int			EnemyPlayer = 2;
+			std::string	LocalRace = Races::Terran;
+			std::string	EnemyRace = Races::Zerg;
+			bool		SinglePlayer = true;
+
+			//Returned by GetTownCandidatePositionStandard
+			Point		TownPosition = { 40.0, 40.0 };
+
+			//Distance within which units of the local player reveal enemy units
+			double		SightRange = 11.0;
+
+			//Map units per game second of every unit that is not a structure
+			double		UnitSpeed = 3.15;
+
+			//Also prints LogLoader and OutputScreen lines to stdout
+			bool		PrintLog = true;
+		};
+
+		/// <summary>
+		/// Removes all units, timers and registered unit tests and starts over at game time 0.
+		/// Connections to the unit signals are kept.
+		/// </summary>
+		SC2API_API void Reset(const Settings& settings = Settings());
+
+		/// <summary>
+		/// Fires SignalMatchStarted, then SignalRegisterUnitTests.
+		/// </summary>
+		SC2API_API void StartMatch();
+
+		/// <summary>
+		/// Fires SignalMatchEnded.
+		/// </summary>
+		SC2API_API void EndMatch();
+
+		/// <summary>
+		/// Advances the game by one tick: executes orders, resolves attacks and deaths, updates vision and fires due
+		/// timers, in this order.
+		/// </summary>
+		/// <param name="seconds">Game seconds of the tick</param>
+		SC2API_API void Step(double seconds = 1.0 / 16.0);
+
+		/// <summary>
+		/// Advances the game by ticks of the given length for the given game time.
+		/// </summary>
+		SC2API_API void Run(double seconds, double tick = 1.0 / 16.0);
+
+		SC2API_API double GetTime();
+		SC2API_API uint64_t GetTickCount();
+
+		/// <summary>
+		/// Creates a unit for any player, firing SignalUnitCreated. CheatCreateUnit creates them for the local player.
+		/// Player 0 is neutral.
+		/// </summary>
+		SC2API_API Unit SpawnUnit(const std::string& unitType, Point position, int player, bool underConstruction = false);
+
+		SC2API_API void FinishConstruction(const Unit& unit);
+
+		/// <summary>
+		/// Changes the type of a unit in place, e.g. Hatchery to Lair. Fires no event, like morphs in the game.
+		/// </summary>
+		SC2API_API void MorphUnit(const Unit& unit, const std::string& unitType);
+
+		/// <summary>
+		/// Kills a unit, firing SignalUnitDestroyed with the killer.
+		/// </summary>
+		SC2API_API void KillUnit(const Unit& unit, Optional<Unit> killer = Optional<Unit>());
+
+		SC2API_API void SetLife(const Unit& unit, double life);
+		SC2API_API void SetPosition(const Unit& unit, Point position);
+
+		/// <summary>
+		/// Gets the lines written by LogLoader, OutputScreen and UnitTestBase::ReportError since the last Reset.
+		/// Lines of SC2API_LOG arrive from the logger thread; call Logger::Get().Flush() first to see all of them.
+		/// </summary>
+		SC2API_API std::vector<std::string> GetLog();
+
+		/// <summary>
+		/// Runs the tests registered through RegisterUnitTest with a UnitTestScheduler, stepping the world until all
+		/// finished or timed out. Regional tests get regions of 40 apart from Settings::TownPosition on, 8 at a time.
+		/// Units created by a test are removed after its TeardownTest.
+		/// </summary>
+		/// <param name="filter">Tests to run, e.g. UnitTestFilter::FromEnvironment()</param>
+		/// <returns>Results in the order the tests finished, for WriteUnitTestJUnit or WriteUnitTestJson</returns>
+		SC2API_API std::vector<UnitTestResult> RunUnitTests(const UnitTestFilter& filter = UnitTestFilter(), double tick = 1.0 / 16.0);
+	}
+}
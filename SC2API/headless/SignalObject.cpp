@@ -0,0 +1,58 @@
+/**
+ * Implementation of zycore::SignalObject for the headless backend, which does not link the prebuilt
+ * zycore.lib. See SC2APIHeadless.h.
+ */
+
+#include "zycore/SignalObject.hpp"
+
+namespace zycore
+{
+
+// ============================================================================================== //
+// [SignalObject]                                                                                 //
+// ============================================================================================== //
+
+SignalObject::~SignalObject()
+{
+    destroy();
+}
+
+void SignalObject::destroy()
+{
+    sigDestroy.emit();
+
+    // Signals call back into onSignalDisconnected only when they themselves are destroyed or
+    // disconnected, so the list is not modified while we walk a copy of it.
+    std::vector<std::tuple<SlotHandle, internal::SignalBase*>> connectedSignals;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_objectMutex);
+        connectedSignals.swap(m_connectedSignals);
+    }
+    for (const auto& connection : connectedSignals)
+    {
+        std::get<1>(connection)->onSlotsObjectDestroyed(std::get<0>(connection));
+    }
+}
+
+void SignalObject::onSignalConnected(internal::SignalBase* signal, SlotHandle handle)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_objectMutex);
+    m_connectedSignals.emplace_back(handle, signal);
+}
+
+void SignalObject::onSignalDisconnected(internal::SignalBase* signal, SlotHandle handle)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_objectMutex);
+    for (auto i = m_connectedSignals.begin(); i != m_connectedSignals.end(); ++i)
+    {
+        if (std::get<0>(*i) == handle && std::get<1>(*i) == signal)
+        {
+            m_connectedSignals.erase(i);
+            break;
+        }
+    }
+}
+
+// ============================================================================================== //
+
+} // namespace zycore
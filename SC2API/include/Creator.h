@@ -1,12 +1,539 @@
 #pragma once
+#include <cstddef>
 #include <functional>
 #include <memory>
-#include <vector>
-#include <iostream>
+#include <new>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace SC2API
 {
+	template<class T>
+	class InlineCreator;
+
+	template<class T>
+	class Creator;
+
+	#pragma region Implementations
+	namespace Internal
+	{
+		//Arguments up to this size are stored inside the creator, larger ones on the heap
+		enum : size_t { CreatorInlineSize = 4 * sizeof(void*) };
+
+		using CreatorStorage = std::aligned_storage_t<CreatorInlineSize, alignof(void*)>;
+
+		template<class ArgsT>
+		using CreatorArgsFitInline = std::integral_constant<bool,
+			sizeof(ArgsT) <= sizeof(CreatorStorage)
+			&& alignof(ArgsT) <= alignof(CreatorStorage)
+			&& std::is_nothrow_move_constructible<ArgsT>::value>;
+
+		//Where the arguments live: in the storage itself, or on the heap with the storage holding the pointer
+		template<class ArgsT, bool Inline = CreatorArgsFitInline<ArgsT>::value>
+		struct CreatorArgs
+		{
+			static ArgsT& Get(CreatorStorage& storage)
+			{
+				return *reinterpret_cast<ArgsT*>(&storage);
+			}
+
+			template<class ... ValuesT>
+			static void Emplace(CreatorStorage& storage, ValuesT&& ... values)
+			{
+				new (&storage) ArgsT(std::forward<ValuesT>(values) ...);
+			}
+
+			static void Copy(CreatorStorage& from, CreatorStorage& to)
+			{
+				new (&to) ArgsT(Get(from));
+			}
+
+			static void Move(CreatorStorage& from, CreatorStorage& to)
+			{
+				new (&to) ArgsT(std::move(Get(from)));
+				Get(from).~ArgsT();
+			}
+
+			static void Destroy(CreatorStorage& storage)
+			{
+				Get(storage).~ArgsT();
+			}
+		};
+
+		template<class ArgsT>
+		struct CreatorArgs<ArgsT, false>
+		{
+			static ArgsT*& GetPointer(CreatorStorage& storage)
+			{
+				return *reinterpret_cast<ArgsT**>(&storage);
+			}
+
+			static ArgsT& Get(CreatorStorage& storage)
+			{
+				return *GetPointer(storage);
+			}
+
+			template<class ... ValuesT>
+			static void Emplace(CreatorStorage& storage, ValuesT&& ... values)
+			{
+				GetPointer(storage) = new ArgsT(std::forward<ValuesT>(values) ...);
+			}
+
+			static void Copy(CreatorStorage& from, CreatorStorage& to)
+			{
+				GetPointer(to) = new ArgsT(Get(from));
+			}
+
+			static void Move(CreatorStorage& from, CreatorStorage& to)
+			{
+				GetPointer(to) = GetPointer(from);
+			}
+
+			static void Destroy(CreatorStorage& storage)
+			{
+				delete GetPointer(storage);
+			}
+		};
+
+		//Handling of the stored arguments, which does not depend on the created base type
+		struct CreatorArgsTable
+		{
+			void (*Copy)(CreatorStorage& from, CreatorStorage& to);
+			void (*Move)(CreatorStorage& from, CreatorStorage& to);
+			void (*Destroy)(CreatorStorage& storage);
+			size_t (*GetSize)(CreatorStorage& storage);
+			size_t (*GetAlignment)(CreatorStorage& storage);
+		};
+
+		//Construction of the object as T; inner is the table of the creator this one was converted from, if any
+		template<class T>
+		struct CreatorTable
+		{
+			T* (*ConstructAt)(CreatorStorage& storage, const void* inner, void* where, bool moveArgs);
+			std::unique_ptr<T> (*Create)(CreatorStorage& storage, const void* inner, bool moveArgs);
+		};
+
+		//Tables of a creator of ConcreteT from a tuple of arguments
+		template<class T, class ConcreteT, class ArgsT>
+		struct CreatorTables
+		{
+			using Args = CreatorArgs<ArgsT>;
+
+			static size_t GetSize(CreatorStorage&)
+			{
+				return sizeof(ConcreteT);
+			}
+
+			static size_t GetAlignment(CreatorStorage&)
+			{
+				return alignof(ConcreteT);
+			}
+
+			template<size_t ... Indices>
+			static T* ConstructAt(ArgsT& args, void* where, bool moveArgs, std::index_sequence<Indices ...>)
+			{
+				if (moveArgs)
+				{
+					return new (where) ConcreteT(std::move(std::get<Indices>(args)) ...);
+				}
+				return new (where) ConcreteT(std::get<Indices>(args) ...);
+			}
+
+			template<size_t ... Indices>
+			static std::unique_ptr<T> Create(ArgsT& args, bool moveArgs, std::index_sequence<Indices ...>)
+			{
+				if (moveArgs)
+				{
+					return std::make_unique<ConcreteT>(std::move(std::get<Indices>(args)) ...);
+				}
+				return std::make_unique<ConcreteT>(std::get<Indices>(args) ...);
+			}
+
+			static T* ConstructAt(CreatorStorage& storage, const void*, void* where, bool moveArgs)
+			{
+				return ConstructAt(Args::Get(storage), where, moveArgs, std::make_index_sequence<std::tuple_size<ArgsT>::value>());
+			}
+
+			static std::unique_ptr<T> Create(CreatorStorage& storage, const void*, bool moveArgs)
+			{
+				return Create(Args::Get(storage), moveArgs, std::make_index_sequence<std::tuple_size<ArgsT>::value>());
+			}
+
+			static const CreatorArgsTable ArgsTable;
+			static const CreatorTable<T> Table;
+		};
+
+		template<class T, class ConcreteT, class ArgsT>
+		const CreatorArgsTable CreatorTables<T, ConcreteT, ArgsT>::ArgsTable =
+		{
+			&Args::Copy, &Args::Move, &Args::Destroy, &GetSize, &GetAlignment
+		};
+
+		template<class T, class ConcreteT, class ArgsT>
+		const CreatorTable<T> CreatorTables<T, ConcreteT, ArgsT>::Table =
+		{
+			&ConstructAt, &Create
+		};
+
+		//Table of an InlineCreator<T> converted from an InlineCreator<OtherT>: keeps the arguments and the table of the other
+		template<class T, class OtherT>
+		struct ConvertedCreatorTables
+		{
+			static T* ConstructAt(CreatorStorage& storage, const void* inner, void* where, bool moveArgs)
+			{
+				return static_cast<const CreatorTable<OtherT>*>(inner)->ConstructAt(storage, nullptr, where, moveArgs);
+			}
+
+			static std::unique_ptr<T> Create(CreatorStorage& storage, const void* inner, bool moveArgs)
+			{
+				return static_cast<const CreatorTable<OtherT>*>(inner)->Create(storage, nullptr, moveArgs);
+			}
+
+			static const CreatorTable<T> Table;
+		};
+
+		template<class T, class OtherT>
+		const CreatorTable<T> ConvertedCreatorTables<T, OtherT>::Table =
+		{
+			&ConstructAt, &Create
+		};
+
+		//Tables of an InlineCreator<T> holding a whole InlineCreator<OtherT>, for creators converted more than once
+		template<class T, class OtherT>
+		struct NestedCreatorTables
+		{
+			using Args = CreatorArgs<InlineCreator<OtherT>>;
+
+			static size_t GetSize(CreatorStorage& storage)
+			{
+				return Args::Get(storage).GetSize();
+			}
+
+			static size_t GetAlignment(CreatorStorage& storage)
+			{
+				return Args::Get(storage).GetAlignment();
+			}
+
+			static T* ConstructAt(CreatorStorage& storage, const void*, void* where, bool moveArgs)
+			{
+				InlineCreator<OtherT>& other = Args::Get(storage);
+				return moveArgs ? std::move(other).ConstructAt(where) : other.ConstructAt(where);
+			}
+
+			static std::unique_ptr<T> Create(CreatorStorage& storage, const void*, bool moveArgs)
+			{
+				InlineCreator<OtherT>& other = Args::Get(storage);
+				return moveArgs ? std::move(other)() : other();
+			}
+
+			static const CreatorArgsTable ArgsTable;
+			static const CreatorTable<T> Table;
+		};
+
+		template<class T, class OtherT>
+		const CreatorArgsTable NestedCreatorTables<T, OtherT>::ArgsTable =
+		{
+			&Args::Copy, &Args::Move, &Args::Destroy, &GetSize, &GetAlignment
+		};
+
+		template<class T, class OtherT>
+		const CreatorTable<T> NestedCreatorTables<T, OtherT>::Table =
+		{
+			&ConstructAt, &Create
+		};
+
+		template<class T>
+		struct IsCreator : std::false_type {};
+
+		template<class T>
+		struct IsCreator<Creator<T>> : std::true_type {};
+
+		template<class T>
+		struct IsCreator<InlineCreator<T>> : std::true_type {};
+
+		//Whether a parameter pack is a single creator, which the copy, move and converting constructors take instead
+		template<class ... ArgsT>
+		struct IsSingleCreator : std::false_type {};
+
+		template<class ArgT>
+		struct IsSingleCreator<ArgT> : IsCreator<std::decay_t<ArgT>> {};
+	}
+	#pragma endregion
+
+	/// <summary>
+	/// Deletes objects created by InlineCreator::CreateIn and gives their memory back to the pool.
+	/// </summary>
+	template<class PoolT>
+	struct CreatorPoolDeleter
+	{
+		PoolT* Pool = nullptr;
+		void* Address = nullptr;
+		size_t Size = 0;
+		size_t Alignment = 0;
+
+		template<class T>
+		void operator()(T* object) const
+		{
+			object->~T();
+			Pool->deallocate(Address, Size, Alignment);
+		}
+	};
+
+	/// <summary>
+	/// Creates objects of T, or of a type derived from T, with constructor arguments given up front.
+	/// The arguments are stored once, inline if they are small, and passed to the constructor on each call; calling
+	/// an rvalue creator, e.g. std::move(creator)(), moves them in instead, for creators used once.
+	/// Objects can be created on the heap, in caller-provided storage of GetSize() bytes or in a pool.
+	/// API functions such as RegisterUnitTest take a Creator instead, whose layout SC2API.dll is built against;
+	/// convert at the call, e.g. RegisterUnitTest(name, Creator<UnitTestBase>(std::move(inlineCreator))).
+	/// </summary>
+	template<class T>
+	class InlineCreator
+	{
+	public:
+		//Constructs from parameter pack, stored and forwarded to the object's constructor on each call
+		template<
+			class ... ArgsT,
+			typename std::enable_if<!Internal::IsSingleCreator<ArgsT ...>::value, int>::type = 0>
+		explicit InlineCreator(ArgsT&& ... args)
+			: ArgsTable(&Internal::CreatorTables<T, T, std::tuple<std::decay_t<ArgsT> ...>>::ArgsTable)
+			, Table(&Internal::CreatorTables<T, T, std::tuple<std::decay_t<ArgsT> ...>>::Table)
+		{
+			static_assert(!std::is_abstract<T>::value, "Type must not be abstract");
+			Internal::CreatorArgs<std::tuple<std::decay_t<ArgsT> ...>>::Emplace(Storage, std::forward<ArgsT>(args) ...);
+		}
+
+		~InlineCreator()
+		{
+			Reset();
+		}
+
+		//copy ctor
+		InlineCreator(const InlineCreator& other)
+		{
+			CopyFrom(other);
+		}
+
+		//move ctor
+		InlineCreator(InlineCreator&& other) noexcept
+		{
+			MoveFrom(other);
+		}
+
+		//converting copy ctor
+		template<
+			class OtherT,
+			typename std::enable_if<std::is_base_of<T, OtherT>::value && !std::is_same<T, OtherT>::value, int>::type = 0>
+			InlineCreator(const InlineCreator<OtherT>& other)
+			: InlineCreator(InlineCreator<OtherT>(other))
+		{}
+
+		//converting move ctor
+		template<
+			class OtherT,
+			typename std::enable_if<std::is_base_of<T, OtherT>::value && !std::is_same<T, OtherT>::value, int>::type = 0>
+			InlineCreator(InlineCreator<OtherT>&& other)
+		{
+			ConvertFrom(other);
+		}
+
+		//copy assign
+		InlineCreator& operator=(const InlineCreator& other)
+		{
+			if (this != &other)
+			{
+				Reset();
+				CopyFrom(other);
+			}
+			return *this;
+		}
+
+		//move assign
+		InlineCreator& operator=(InlineCreator&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+				MoveFrom(other);
+			}
+			return *this;
+		}
+
+		//converting copy and move assign
+		template<
+			class OtherT,
+			typename std::enable_if<std::is_base_of<T, OtherT>::value && !std::is_same<T, OtherT>::value, int>::type = 0>
+			InlineCreator& operator=(InlineCreator<OtherT> other)
+		{
+			Reset();
+			ConvertFrom(other);
+			return *this;
+		}
+
+		//False once moved from
+		explicit operator bool() const
+		{
+			return Table != nullptr;
+		}
+
+		//Creates the object on the heap
+		std::unique_ptr<T> operator()() const&
+		{
+			return Table->Create(GetStorage(), Inner, false);
+		}
+
+		//Creates the object on the heap, moving the arguments in; the creator cannot be used again
+		std::unique_ptr<T> operator()() &&
+		{
+			std::unique_ptr<T> object = Table->Create(Storage, Inner, true);
+			Reset();
+			return object;
+		}
+
+		//Constructs the object in storage of at least GetSize() bytes aligned to GetAlignment(); destroy it with ~T
+		T* ConstructAt(void* storage) const&
+		{
+			return Table->ConstructAt(GetStorage(), Inner, storage, false);
+		}
+
+		T* ConstructAt(void* storage) &&
+		{
+			T* object = Table->ConstructAt(Storage, Inner, storage, true);
+			Reset();
+			return object;
+		}
+
+		/// <summary>
+		/// Creates the object in memory of the pool, anything with allocate(size, alignment) and
+		/// deallocate(address, size, alignment) such as std::pmr::memory_resource.
+		/// </summary>
+		template<class PoolT>
+		std::unique_ptr<T, CreatorPoolDeleter<PoolT>> CreateIn(PoolT& pool) const&
+		{
+			return CreateIn(pool, false);
+		}
+
+		template<class PoolT>
+		std::unique_ptr<T, CreatorPoolDeleter<PoolT>> CreateIn(PoolT& pool) &&
+		{
+			std::unique_ptr<T, CreatorPoolDeleter<PoolT>> object = CreateIn(pool, true);
+			Reset();
+			return object;
+		}
+
+		//Size of the created object, which may be of a type derived from T
+		size_t GetSize() const
+		{
+			return ArgsTable->GetSize(GetStorage());
+		}
+
+		size_t GetAlignment() const
+		{
+			return ArgsTable->GetAlignment(GetStorage());
+		}
+
+		#pragma region Implementations
+	private:
+		Internal::CreatorStorage Storage;
+		const Internal::CreatorArgsTable* ArgsTable = nullptr;
+		const Internal::CreatorTable<T>* Table = nullptr;
+		const void* Inner = nullptr;
+
+		template<class OtherT> friend class InlineCreator;
+
+		//Calls without moving leave the arguments untouched
+		Internal::CreatorStorage& GetStorage() const
+		{
+			return const_cast<Internal::CreatorStorage&>(Storage);
+		}
+
+		void Reset()
+		{
+			if (ArgsTable != nullptr)
+			{
+				ArgsTable->Destroy(Storage);
+			}
+			ArgsTable = nullptr;
+			Table = nullptr;
+			Inner = nullptr;
+		}
+
+		void CopyFrom(const InlineCreator& other)
+		{
+			if (other.ArgsTable != nullptr)
+			{
+				other.ArgsTable->Copy(other.GetStorage(), Storage);
+			}
+			ArgsTable = other.ArgsTable;
+			Table = other.Table;
+			Inner = other.Inner;
+		}
+
+		void MoveFrom(InlineCreator& other)
+		{
+			if (other.ArgsTable != nullptr)
+			{
+				other.ArgsTable->Move(other.Storage, Storage);
+			}
+			ArgsTable = other.ArgsTable;
+			Table = other.Table;
+			Inner = other.Inner;
+			other.ArgsTable = nullptr;
+			other.Table = nullptr;
+			other.Inner = nullptr;
+		}
+
+		template<class OtherT>
+		void ConvertFrom(InlineCreator<OtherT>& other)
+		{
+			if (other.Table == nullptr)
+			{
+				return;
+			}
+			if (other.Inner == nullptr)
+			{
+				//Takes over the arguments as they are; the other table does the construction
+				other.ArgsTable->Move(other.Storage, Storage);
+				ArgsTable = other.ArgsTable;
+				Table = &Internal::ConvertedCreatorTables<T, OtherT>::Table;
+				Inner = other.Table;
+				other.ArgsTable = nullptr;
+				other.Table = nullptr;
+				return;
+			}
+			Internal::CreatorArgs<InlineCreator<OtherT>>::Emplace(Storage, std::move(other));
+			ArgsTable = &Internal::NestedCreatorTables<T, OtherT>::ArgsTable;
+			Table = &Internal::NestedCreatorTables<T, OtherT>::Table;
+		}
+
+		template<class PoolT>
+		std::unique_ptr<T, CreatorPoolDeleter<PoolT>> CreateIn(PoolT& pool, bool moveArgs) const
+		{
+			CreatorPoolDeleter<PoolT> deleter;
+			deleter.Pool = &pool;
+			deleter.Size = GetSize();
+			deleter.Alignment = GetAlignment();
+			deleter.Address = pool.allocate(deleter.Size, deleter.Alignment);
+			T* object;
+			try
+			{
+				object = Table->ConstructAt(GetStorage(), Inner, deleter.Address, moveArgs);
+			}
+			catch (...)
+			{
+				pool.deallocate(deleter.Address, deleter.Size, deleter.Alignment);
+				throw;
+			}
+			return std::unique_ptr<T, CreatorPoolDeleter<PoolT>>(object, deleter);
+		}
+		#pragma endregion
+	};
+
+	/// <summary>
+	/// Creates objects of T, or of a type derived from T, on the heap. Passed by value to SC2API.dll, so its layout
+	/// must stay that of the prebuilt binary: a single std::function. Prefer InlineCreator within the bot.
+	/// </summary>
 	template<class T>
 	class Creator
 	{
@@ -14,7 +541,9 @@ namespace SC2API
 		~Creator() = default;
 
 		//Constructs from parameter pack and forwards them to object's constructor
-		template<class ... ArgsT>
+		template<
+			class ... ArgsT,
+			typename std::enable_if<!Internal::IsSingleCreator<ArgsT ...>::value, int>::type = 0>
 		explicit Creator(ArgsT&& ... args)
 			: functor([args ...]  /*copy*/
 		{
@@ -40,6 +569,17 @@ namespace SC2API
 			: functor(other.functor)
 		{}
 
+		//converting ctor from an InlineCreator; std::function needs a copyable target, so the creator is shared
+		template<
+			class OtherT,
+			typename std::enable_if<std::is_base_of<T, OtherT>::value, int>::type = 0>
+			explicit Creator(InlineCreator<OtherT>&& other)
+			: functor([creator = std::make_shared<InlineCreator<OtherT>>(std::move(other))]() -> std::unique_ptr<T>
+		{
+			return (*creator)();
+		})
+		{}
+
 		//move assign
 		template<
 			class OtherT,
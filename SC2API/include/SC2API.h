@@ -4,13 +4,19 @@
 #include <zycore/Singleton.hpp>
 #include <zycore/SignalObject.hpp>
 
-#if SC2API_EXPORTS
+#if defined(SC2API_HEADLESS)
+#define SC2API_API              //Headless backend is compiled into the user binary, see SC2API/headless
+#elif !defined(_MSC_VER)
+#define SC2API_API __attribute__ ((visibility ("default")))
+#elif SC2API_EXPORTS
 #define SC2API_API __declspec (dllexport)
 #else
 #define SC2API_API __declspec (dllimport)
 #endif
 
+#if defined(_MSC_VER)
 #pragma warning(disable: 4251)  //Currently, user DLL is expected to compile with same options as SC2API (/MD, /MDd)
+#endif
 
 /// <summary>
 /// Type and thread safe signal implementation.
@@ -0,0 +1,251 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIGame.h"
+#include "SC2APIUnitTestSystem.h"
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace SC2API
+{
+	//How a benchmark runs, see BenchmarkTestBase::GetBenchmarkSettings
+	struct BenchmarkSettings
+	{
+		//Iterations run and discarded before measuring, e.g. to fill caches
+		int			WarmupIterations = 3;
+		int			Iterations = 30;
+
+		//Game seconds between iterations; 0 runs all iterations at once inside RunTest
+		double		TickInterval = 0.0;
+
+		//File with the baseline means of all benchmarks, one "name<TAB>mean" line each; empty to skip the comparison
+		std::string	BaselinePath;
+
+		//Fails when the mean is slower than the baseline by more than this fraction
+		double		RegressionThreshold = 0.10;
+
+		//Writes the measured mean as new baseline instead of comparing against the old one
+		bool		UpdateBaseline = false;
+	};
+
+	//Measurements of a benchmark in milliseconds of wall-clock time per iteration
+	struct BenchmarkStats
+	{
+		int			Iterations = 0;
+		int			GameTicks = 0;
+		double		Mean = 0.0;
+		double		StdDev = 0.0;
+		double		Min = 0.0;
+		double		P50 = 0.0;
+		double		P90 = 0.0;
+		double		P99 = 0.0;
+		double		Max = 0.0;
+
+		//Baseline mean the benchmark was compared against, 0 if there was none
+		double		Baseline = 0.0;
+	};
+
+	/// <summary>
+	/// Test that measures the time of a body instead of checking results. RunIteration is called for the warm-up and
+	/// then the measured iterations, all at once or one per game tick; the test fails when the mean regressed beyond the
+	/// threshold against the baseline file. Checks such as TestEqual still fail the test as usual.
+	/// Benchmarks are not regional tests, so UnitTestScheduler runs them alone and other tests do not skew the timing.
+	/// </summary>
+	class BenchmarkTestBase : public UnitTestBase, public SignalObject
+	{
+	public:
+		void RunTest() final
+		{
+			Settings = GetBenchmarkSettings();
+			Samples.clear();
+			Iteration = 0;
+			GameTicks = 0;
+			Done = false;
+			if (Settings.TickInterval <= 0.0)
+			{
+				while (RunNext())
+				{
+				}
+				return;
+			}
+			SignalTimer(Settings.TickInterval, true).connect(this, &BenchmarkTestBase::OnTimer);
+		}
+
+		const BenchmarkStats& GetStats() const
+		{
+			return Stats;
+		}
+
+		//Computes the stats of wall-clock samples in milliseconds
+		static BenchmarkStats ComputeStats(std::vector<double> samples)
+		{
+			BenchmarkStats stats;
+			stats.Iterations = static_cast<int>(samples.size());
+			if (samples.empty())
+			{
+				return stats;
+			}
+			std::sort(samples.begin(), samples.end());
+			double sum = 0.0;
+			for (const double sample : samples)
+			{
+				sum += sample;
+			}
+			stats.Mean = sum / samples.size();
+			double squares = 0.0;
+			for (const double sample : samples)
+			{
+				squares += (sample - stats.Mean) * (sample - stats.Mean);
+			}
+			stats.StdDev = samples.size() > 1 ? std::sqrt(squares / (samples.size() - 1)) : 0.0;
+			const auto percentile = [&samples](double fraction)
+			{
+				const size_t rank = static_cast<size_t>(std::ceil(fraction * samples.size()));
+				return samples[rank > 0 ? rank - 1 : 0];
+			};
+			stats.Min = samples.front();
+			stats.P50 = percentile(0.50);
+			stats.P90 = percentile(0.90);
+			stats.P99 = percentile(0.99);
+			stats.Max = samples.back();
+			return stats;
+		}
+
+	protected:
+		virtual BenchmarkSettings GetBenchmarkSettings() const
+		{
+			return{};
+		}
+
+		//The measured body
+		virtual void RunIteration() = 0;
+
+		#pragma region Implementations
+	private:
+		BenchmarkSettings Settings;
+		BenchmarkStats Stats;
+		std::vector<double> Samples;
+		int Iteration = 0;
+		int GameTicks = 0;
+		bool Done = false;
+
+		//Runs one iteration; returns false once all are done
+		bool RunNext()
+		{
+			if (Done)
+			{
+				return false;
+			}
+			const auto start = std::chrono::steady_clock::now();
+			RunIteration();
+			const auto end = std::chrono::steady_clock::now();
+			if (Iteration++ >= Settings.WarmupIterations)
+			{
+				Samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+			}
+			if (Iteration < Settings.WarmupIterations + Settings.Iterations)
+			{
+				return true;
+			}
+			Done = true;
+			Complete();
+			return false;
+		}
+
+		void OnTimer()
+		{
+			if (!Done)
+			{
+				++GameTicks;
+				RunNext();
+			}
+		}
+
+		void Complete()
+		{
+			Stats = ComputeStats(Samples);
+			Stats.GameTicks = GameTicks;
+			std::string regression;
+			if (!Settings.BaselinePath.empty())
+			{
+				regression = CompareBaseline();
+			}
+			char line[256];
+			std::snprintf(line, sizeof(line), "[BENCH] %s: %.4f ms +- %.4f, p50 %.4f, p99 %.4f, %d iterations, %d ticks",
+				GetName(), Stats.Mean, Stats.StdDev, Stats.P50, Stats.P99, Stats.Iterations, Stats.GameTicks);
+			SC2API_LOG(line);
+			//The result line of the test system follows; it is written synchronously and would overtake this one
+			Logger::Get().Flush();
+			if (!regression.empty())
+			{
+				ReportUnitTestFailure(*this, regression);
+				return;
+			}
+			Finished(true);
+		}
+
+		//Returns the failure message if the mean regressed, empty otherwise
+		std::string CompareBaseline()
+		{
+			std::vector<std::pair<std::string, double>> entries;
+			{
+				//Names may contain spaces, e.g. templates; only a tab ends them
+				std::ifstream file(Settings.BaselinePath);
+				std::string line;
+				while (std::getline(file, line))
+				{
+					const size_t tab = line.rfind('\t');
+					if (tab == std::string::npos)
+					{
+						continue;
+					}
+					std::istringstream mean(line.substr(tab + 1));
+					double value;
+					if (mean >> value)
+					{
+						entries.emplace_back(line.substr(0, tab), value);
+					}
+				}
+			}
+			const std::string name = GetName();
+			const auto entry = std::find_if(entries.begin(), entries.end(), [&name](const std::pair<std::string, double>& other)
+			{
+				return other.first == name;
+			});
+			if (entry != entries.end() && !Settings.UpdateBaseline)
+			{
+				Stats.Baseline = entry->second;
+				if (Stats.Mean > entry->second * (1.0 + Settings.RegressionThreshold))
+				{
+					std::ostringstream message;
+					message << "Benchmark " << name << " regressed: " << Stats.Mean << " ms against baseline " << entry->second << " ms";
+					return message.str();
+				}
+				return{};
+			}
+
+			//No baseline yet, or asked to replace it
+			if (entry != entries.end())
+			{
+				entry->second = Stats.Mean;
+			}
+			else
+			{
+				entries.emplace_back(name, Stats.Mean);
+			}
+			std::ofstream file(Settings.BaselinePath, std::ios::out | std::ios::trunc);
+			for (const auto& other : entries)
+			{
+				file << other.first << '\t' << other.second << '\n';
+			}
+			return{};
+		}
+		#pragma endregion
+	};
+}
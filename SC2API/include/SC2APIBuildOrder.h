@@ -0,0 +1,1114 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIUnitGroup.h"
+#include "SC2APIUnitStats.h"
+#include "SC2APIWorkerPool.h"
+#include "SC2APICallCounters.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Number of units per type, indexed by UnitTypeId.
+	/// </summary>
+	using UnitCounts = std::array<uint16_t, static_cast<size_t>(UnitTypeId::Count)>;
+
+	/// <summary>
+	/// A unit or structure in production.
+	/// </summary>
+	struct BuildOrderJob
+	{
+		float Finish;
+		UnitTypeId Type;
+
+		/// <summary>
+		/// The unit kept busy by the job, Invalid if the producer was consumed or is free to leave (probes).
+		/// </summary>
+		UnitTypeId Producer;
+
+		/// <summary>
+		/// The add-on kept busy by the job, Invalid if none.
+		/// </summary>
+		UnitTypeId AddOn;
+
+		/// <summary>
+		/// The producer turns into Type when the job finishes, e.g. Hatchery into Lair.
+		/// </summary>
+		bool MorphsProducer;
+	};
+
+	/// <summary>
+	/// Economic state a build order is planned from.
+	/// </summary>
+	struct BuildOrderState
+	{
+		/// <summary>
+		/// Seconds since the state was taken.
+		/// </summary>
+		float Time = 0.0f;
+
+		float Minerals = 0.0f;
+		float Vespene = 0.0f;
+
+		/// <summary>
+		/// Larvae available to the Zerg player. Fractional while the next larva spawns.
+		/// </summary>
+		float Larva = 0.0f;
+
+		/// <summary>
+		/// Completed units. Larvae are counted in Larva instead.
+		/// </summary>
+		UnitCounts Owned = {};
+
+		/// <summary>
+		/// Units in production.
+		/// </summary>
+		UnitCounts Pending = {};
+
+		/// <summary>
+		/// Units in production ordered by finish time.
+		/// </summary>
+		std::vector<BuildOrderJob> Jobs;
+
+		/// <summary>
+		/// Takes the state of the local player. Units under construction are assumed to be halfway done,
+		/// as the API does not expose build progress.
+		/// </summary>
+		/// <param name="minerals">Current minerals of the player</param>
+		/// <param name="vespene">Current vespene of the player</param>
+		static BuildOrderState FromGame(float minerals, float vespene)
+		{
+			BuildOrderState state;
+			state.Minerals = minerals;
+			state.Vespene = vespene;
+			for (const Unit& unit : SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self, UnitFilterFlag::UnderConstruction)))
+			{
+				const Optional<UnitTypeId> type = GetUnitTypeId(unit);
+				if (!type.hasValue())
+				{
+					continue;
+				}
+				if (type.value() == UnitTypeId::Larva)
+				{
+					state.Larva += 1.0f;
+				}
+				else
+				{
+					++state.Owned[static_cast<size_t>(type.value())];
+				}
+			}
+			for (const Unit& unit : SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self | UnitFilterFlag::UnderConstruction)))
+			{
+				const Optional<UnitTypeId> type = GetUnitTypeId(unit);
+				if (type.hasValue())
+				{
+					state.AddJob({ GetUnitStats(type.value()).BuildTime * 0.5f, type.value(), UnitTypeId::Invalid, UnitTypeId::Invalid, false });
+				}
+			}
+			return state;
+		}
+
+		/// <summary>
+		/// Adds a unit in production.
+		/// </summary>
+		void AddJob(const BuildOrderJob& job)
+		{
+			++Pending[static_cast<size_t>(job.Type)];
+			const auto position = std::upper_bound(Jobs.begin(), Jobs.end(), job,
+				[](const BuildOrderJob& a, const BuildOrderJob& b) { return a.Finish < b.Finish; });
+			Jobs.insert(position, job);
+		}
+	};
+
+	/// <summary>
+	/// Units wanted at the end of a build order.
+	/// </summary>
+	struct BuildOrderTarget
+	{
+		/// <summary>
+		/// Minimum number of completed units per type. Units that morph from a type count as that type (a Lair is a Hatchery).
+		/// </summary>
+		UnitCounts Counts = {};
+
+		BuildOrderTarget& Add(UnitTypeId type, uint16_t count = 1)
+		{
+			Counts[static_cast<size_t>(type)] += count;
+			return *this;
+		}
+	};
+
+	struct BuildOrderStep
+	{
+		UnitTypeId Type;
+
+		/// <summary>
+		/// Seconds after the start state at which production starts.
+		/// </summary>
+		float StartTime;
+	};
+
+	struct BuildOrderPlan
+	{
+		std::vector<BuildOrderStep> Steps;
+
+		/// <summary>
+		/// Seconds after the start state at which the target is complete.
+		/// </summary>
+		float FinishTime;
+	};
+
+	/// <summary>
+	/// Searches the fastest build order reaching a target composition.
+	/// The search is a beam search over "produce this next" decisions: every layer each state in the beam is extended
+	/// by every useful action, simulating mining, supply, larvae and production queues until the action can start.
+	/// Children are scored by a completion estimate, deduplicated through a transposition table and cut to BeamWidth;
+	/// states that cannot beat the best plan found so far are pruned. Layers are expanded in parallel on a pool of
+	/// threads the search keeps between layers and searches.
+	/// The search can run to completion or in slices with Step, e.g. one slice per game tick.
+	/// Mining rates, larva spawn and worker saturation are approximations; upgrades, MULEs, injects and
+	/// chrono boost are not modelled.
+	/// </summary>
+	class BuildOrderSearch
+	{
+	public:
+		/// <summary>
+		/// Number of states kept per layer. Larger beams find better plans at linear cost.
+		/// </summary>
+		size_t BeamWidth = 64;
+
+		/// <summary>
+		/// Number of threads expanding a layer, hardware concurrency if 0. Read when a search starts.
+		/// </summary>
+		unsigned Threads = 0;
+
+		/// <summary>
+		/// Plans taking longer than this many seconds are not considered.
+		/// </summary>
+		float MaxTime = 900.0f;
+
+		/// <summary>
+		/// Starts a new search, dropping the previous one.
+		/// </summary>
+		/// <param name="initial">State to plan from, e.g. BuildOrderState::FromGame</param>
+		/// <param name="target">Units wanted</param>
+		void Start(const BuildOrderState& initial, const BuildOrderTarget& target)
+		{
+			Target = target.Counts;
+			Best = BuildOrderPlan{ {}, std::numeric_limits<float>::infinity() };
+			Transpositions.clear();
+			Beam.clear();
+			Layers = 0;
+			CollectActions();
+			if (Pool == nullptr || Pool->GetThreadCount() != (Threads != 0 ? Threads : std::max(1u, std::thread::hardware_concurrency())))
+			{
+				Pool.reset(new WorkerPool(Threads));
+			}
+
+			Node root;
+			root.State = initial;
+			if (IsComplete(root.State))
+			{
+				Best.FinishTime = TargetFinishTime(root.State);
+				return;
+			}
+			root.Score = Estimate(root.State);
+			Beam.push_back(std::move(root));
+		}
+
+		/// <summary>
+		/// Expands layers until the search is finished or the deadline passed. A layer is never interrupted,
+		/// so the call may overrun the deadline by the time of one layer.
+		/// </summary>
+		/// <returns>True if the search is finished</returns>
+		bool Step(std::chrono::steady_clock::time_point deadline)
+		{
+			while (!Beam.empty())
+			{
+				ExpandLayer();
+				if (std::chrono::steady_clock::now() >= deadline)
+				{
+					break;
+				}
+			}
+			return IsDone();
+		}
+
+		/// <summary>
+		/// Runs the search to completion.
+		/// </summary>
+		/// <returns>True if a plan was found</returns>
+		bool Run()
+		{
+			while (!Beam.empty())
+			{
+				ExpandLayer();
+			}
+			return HasPlan();
+		}
+
+		bool IsDone() const
+		{
+			return Beam.empty();
+		}
+
+		/// <summary>
+		/// Whether a plan reaching the target was found so far. It improves while the search goes on.
+		/// </summary>
+		bool HasPlan() const
+		{
+			return Best.FinishTime < std::numeric_limits<float>::infinity();
+		}
+
+		/// <summary>
+		/// Gets the best plan found so far.
+		/// </summary>
+		const BuildOrderPlan& GetBestPlan() const
+		{
+			return Best;
+		}
+
+		/// <summary>
+		/// Number of layers expanded, which is the length of the longest plan considered.
+		/// </summary>
+		size_t GetLayerCount() const
+		{
+			return Layers;
+		}
+
+		#pragma region Implementations
+	private:
+		struct Node
+		{
+			BuildOrderState State;
+			std::vector<BuildOrderStep> Steps;
+			float Score;
+		};
+
+		//A state reached before, kept to skip states it dominates
+		struct Transposition
+		{
+			//Compared on hash hits, as different counts can share a hash
+			UnitCounts Owned;
+			UnitCounts Pending;
+			float Time;
+			float Minerals;
+			float Vespene;
+			float Larva;
+			std::vector<BuildOrderJob> Jobs;
+		};
+
+		enum class ProducerUse
+		{
+			Busy,
+			Free,
+			ConsumedAtStart,
+			ConsumedAtFinish,
+		};
+
+		enum : int
+		{
+			MaxSupply = 200,
+			MaxProducersPerType = 5,
+			MineralWorkersPerBase = 16,
+			VespeneWorkersPerGeyser = 3,
+			LarvaePerHatchery = 3,
+		};
+
+		//Minerals and vespene per worker and second at faster speed, larva spawn per hatchery and second
+		static constexpr float MineralRate = 0.95f;
+		static constexpr float VespeneRate = 0.89f;
+		static constexpr float LarvaRate = 1.0f / 11.0f;
+
+		UnitCounts Target = {};
+		BuildOrderPlan Best;
+		std::vector<Node> Beam;
+		std::unordered_multimap<uint64_t, Transposition> Transpositions;
+		std::vector<UnitTypeId> Actions;
+		UnitRace Race = UnitRace::Terran;
+		size_t Layers = 0;
+		std::unique_ptr<WorkerPool> Pool;
+
+		static size_t Index(UnitTypeId type)
+		{
+			return static_cast<size_t>(type);
+		}
+
+		static ProducerUse GetProducerUse(UnitTypeId type)
+		{
+			if (GetMorphBase(type) != UnitTypeId::Invalid)
+			{
+				return ProducerUse::ConsumedAtFinish;
+			}
+			switch (type)
+			{
+			case UnitTypeId::Baneling:
+			case UnitTypeId::Ravager:
+			case UnitTypeId::BroodLord:
+			case UnitTypeId::Overseer:
+			case UnitTypeId::Archon:
+				return ProducerUse::ConsumedAtStart;
+			default:
+				break;
+			}
+			switch (GetUnitStats(type).ProducedBy)
+			{
+			case UnitTypeId::Larva:
+			case UnitTypeId::Drone:
+				return ProducerUse::ConsumedAtStart;
+			case UnitTypeId::Probe:
+				return ProducerUse::Free;
+			default:
+				return ProducerUse::Busy;
+			}
+		}
+
+		//The type and the structures it morphs into, which can stand in for it as producer or requirement
+		static const std::vector<UnitTypeId>& GetFamily(UnitTypeId type)
+		{
+			static const std::vector<std::vector<UnitTypeId>> families = []()
+			{
+				std::vector<std::vector<UnitTypeId>> result(Index(UnitTypeId::Count));
+				for (size_t i = 0; i < result.size(); ++i)
+				{
+					result[i].push_back(static_cast<UnitTypeId>(i));
+					for (size_t member = 0; member < result[i].size(); ++member)
+					{
+						for (size_t j = 0; j < result.size(); ++j)
+						{
+							const UnitTypeId candidate = static_cast<UnitTypeId>(j);
+							if (GetUnitStats(candidate).ProducedBy == result[i][member] && GetProducerUse(candidate) == ProducerUse::ConsumedAtFinish)
+							{
+								result[i].push_back(candidate);
+							}
+						}
+					}
+				}
+				return result;
+			}();
+			return families[Index(type)];
+		}
+
+		static bool IsAddOn(UnitTypeId type)
+		{
+			const UnitTypeStats& stats = GetUnitStats(type);
+			return stats.Is(UnitFilterFlag::Structure) && stats.ProducedBy != UnitTypeId::Invalid
+				&& GetUnitStats(stats.ProducedBy).Is(UnitFilterFlag::Structure) && GetProducerUse(type) == ProducerUse::Busy;
+		}
+
+		static UnitTypeId GetReactor(UnitTypeId producer)
+		{
+			switch (producer)
+			{
+			case UnitTypeId::Barracks:
+				return UnitTypeId::BarracksReactor;
+			case UnitTypeId::Factory:
+				return UnitTypeId::FactoryReactor;
+			case UnitTypeId::Starport:
+				return UnitTypeId::StarportReactor;
+			default:
+				return UnitTypeId::Invalid;
+			}
+		}
+
+		static UnitTypeId GetWorker(UnitRace race)
+		{
+			return race == UnitRace::Terran ? UnitTypeId::SCV : race == UnitRace::Zerg ? UnitTypeId::Drone : UnitTypeId::Probe;
+		}
+
+		static UnitTypeId GetTownHall(UnitRace race)
+		{
+			return race == UnitRace::Terran ? UnitTypeId::CommandCenter : race == UnitRace::Zerg ? UnitTypeId::Hatchery : UnitTypeId::Nexus;
+		}
+
+		static UnitTypeId GetGasBuilding(UnitRace race)
+		{
+			return race == UnitRace::Terran ? UnitTypeId::Refinery : race == UnitRace::Zerg ? UnitTypeId::Extractor : UnitTypeId::Assimilator;
+		}
+
+		static UnitTypeId GetSupplyProvider(UnitRace race)
+		{
+			return race == UnitRace::Terran ? UnitTypeId::SupplyDepot : race == UnitRace::Zerg ? UnitTypeId::Overlord : UnitTypeId::Pylon;
+		}
+
+		static int CountFamily(const UnitCounts& counts, UnitTypeId type)
+		{
+			int count = 0;
+			for (const UnitTypeId member : GetFamily(type))
+			{
+				count += counts[Index(member)];
+			}
+			return count;
+		}
+
+		static int CountPlanned(const BuildOrderState& state, UnitTypeId type)
+		{
+			return CountFamily(state.Owned, type) + CountFamily(state.Pending, type);
+		}
+
+		//Jobs keeping a producer of the family of the given type busy
+		static int CountBusy(const BuildOrderState& state, UnitTypeId producer)
+		{
+			const std::vector<UnitTypeId>& family = GetFamily(producer);
+			int count = 0;
+			for (const BuildOrderJob& job : state.Jobs)
+			{
+				if (job.Producer != UnitTypeId::Invalid && std::find(family.begin(), family.end(), job.Producer) != family.end())
+				{
+					++count;
+				}
+			}
+			return count;
+		}
+
+		static int CountBusyAddOn(const BuildOrderState& state, UnitTypeId addOn)
+		{
+			int count = 0;
+			for (const BuildOrderJob& job : state.Jobs)
+			{
+				count += job.AddOn == addOn ? 1 : 0;
+			}
+			return count;
+		}
+
+		static float SupplyUsed(const BuildOrderState& state)
+		{
+			float used = 0.0f;
+			for (size_t i = 0; i < state.Owned.size(); ++i)
+			{
+				used += (state.Owned[i] + state.Pending[i]) * GetUnitStats(static_cast<UnitTypeId>(i)).Supply;
+			}
+			return used;
+		}
+
+		static float SupplyCap(const UnitCounts& counts)
+		{
+			float cap = 0.0f;
+			for (size_t i = 0; i < counts.size(); ++i)
+			{
+				cap += counts[i] * GetUnitStats(static_cast<UnitTypeId>(i)).SupplyProvided;
+			}
+			return std::min(cap, static_cast<float>(MaxSupply));
+		}
+
+		void GetRates(const BuildOrderState& state, float& outMinerals, float& outVespene, float& outLarva) const
+		{
+			const UnitTypeId worker = GetWorker(Race);
+			const int workers = state.Owned[Index(worker)] - (Race == UnitRace::Terran ? CountBusy(state, worker) : 0);
+			const int bases = CountFamily(state.Owned, GetTownHall(Race));
+			const int geysers = state.Owned[Index(GetGasBuilding(Race))];
+			const int vespeneWorkers = std::min(workers, geysers * VespeneWorkersPerGeyser);
+			const int mineralWorkers = std::min(workers - vespeneWorkers, bases * MineralWorkersPerBase);
+			outMinerals = mineralWorkers * MineralRate;
+			outVespene = vespeneWorkers * VespeneRate;
+			outLarva = Race == UnitRace::Zerg && state.Larva < bases * LarvaePerHatchery ? bases * LarvaRate : 0.0f;
+		}
+
+		//Moves the state forward in time, collecting resources and finishing jobs
+		void Advance(BuildOrderState& state, float time) const
+		{
+			for (;;)
+			{
+				const bool finishJob = !state.Jobs.empty() && state.Jobs.front().Finish <= time;
+				const float end = finishJob ? state.Jobs.front().Finish : time;
+				float mineralRate, vespeneRate, larvaRate;
+				GetRates(state, mineralRate, vespeneRate, larvaRate);
+				const float elapsed = std::max(end - state.Time, 0.0f);
+				state.Minerals += mineralRate * elapsed;
+				state.Vespene += vespeneRate * elapsed;
+				if (larvaRate > 0.0f)
+				{
+					const float maxLarva = static_cast<float>(CountFamily(state.Owned, UnitTypeId::Hatchery) * LarvaePerHatchery);
+					state.Larva = std::min(state.Larva + larvaRate * elapsed, std::max(maxLarva, state.Larva));
+				}
+				state.Time = std::max(state.Time, end);
+				if (!finishJob)
+				{
+					return;
+				}
+				const BuildOrderJob job = state.Jobs.front();
+				state.Jobs.erase(state.Jobs.begin());
+				--state.Pending[Index(job.Type)];
+				++state.Owned[Index(job.Type)];
+				if (job.MorphsProducer && state.Owned[Index(job.Producer)] > 0)
+				{
+					--state.Owned[Index(job.Producer)];
+				}
+			}
+		}
+
+		//Whether the action can ever start from this state without other actions
+		bool CanEventuallyStart(const BuildOrderState& state, UnitTypeId type) const
+		{
+			const UnitTypeStats& stats = GetUnitStats(type);
+			if (stats.Requires != UnitTypeId::Invalid && CountPlanned(state, stats.Requires) == 0)
+			{
+				return false;
+			}
+			if (stats.AddOn != UnitTypeId::Invalid && CountPlanned(state, stats.AddOn) == 0)
+			{
+				return false;
+			}
+			if (stats.ProducedBy == UnitTypeId::Larva)
+			{
+				if (CountPlanned(state, UnitTypeId::Hatchery) == 0 && state.Larva < 1.0f)
+				{
+					return false;
+				}
+			}
+			else if (stats.ProducedBy != UnitTypeId::Invalid && CountPlanned(state, stats.ProducedBy) == 0)
+			{
+				return false;
+			}
+			if (stats.Supply > 0.0f)
+			{
+				UnitCounts planned = state.Owned;
+				for (size_t i = 0; i < planned.size(); ++i)
+				{
+					planned[i] += state.Pending[i];
+				}
+				if (SupplyUsed(state) + stats.Supply > SupplyCap(planned))
+				{
+					return false;
+				}
+			}
+			if (stats.Vespene > 0 && state.Vespene < stats.Vespene && CountPlanned(state, GetGasBuilding(Race)) == 0)
+			{
+				return false;
+			}
+			return true;
+		}
+
+		//Whether the action can start right now, apart from resources
+		bool IsReady(const BuildOrderState& state, UnitTypeId type) const
+		{
+			const UnitTypeStats& stats = GetUnitStats(type);
+			if (stats.Requires != UnitTypeId::Invalid && CountFamily(state.Owned, stats.Requires) == 0)
+			{
+				return false;
+			}
+			if (stats.AddOn != UnitTypeId::Invalid && state.Owned[Index(stats.AddOn)] <= CountBusyAddOn(state, stats.AddOn))
+			{
+				return false;
+			}
+			if (stats.Supply > 0.0f && SupplyUsed(state) + stats.Supply > SupplyCap(state.Owned))
+			{
+				return false;
+			}
+			if (stats.ProducedBy == UnitTypeId::Larva)
+			{
+				return state.Larva >= 1.0f;
+			}
+			if (stats.ProducedBy == UnitTypeId::Invalid)
+			{
+				return true;
+			}
+			switch (GetProducerUse(type))
+			{
+			case ProducerUse::ConsumedAtFinish:
+				return state.Owned[Index(stats.ProducedBy)] > CountBusy(state, stats.ProducedBy);
+			case ProducerUse::Busy:
+			{
+				const UnitTypeId reactor = GetReactor(stats.ProducedBy);
+				int slots = CountFamily(state.Owned, stats.ProducedBy);
+				if (reactor != UnitTypeId::Invalid && stats.AddOn == UnitTypeId::Invalid && !IsAddOn(type))
+				{
+					slots += state.Owned[Index(reactor)];
+				}
+				return slots > CountBusy(state, stats.ProducedBy);
+			}
+			default:
+				return CountFamily(state.Owned, stats.ProducedBy) > 0;
+			}
+		}
+
+		//Waits until the action can start and starts it. Fails if it cannot start before the time limit.
+		bool WaitAndStart(BuildOrderState& state, UnitTypeId type, float timeLimit) const
+		{
+			if (!CanEventuallyStart(state, type))
+			{
+				return false;
+			}
+			const UnitTypeStats& stats = GetUnitStats(type);
+			const float epsilon = 1e-3f;
+			for (;;)
+			{
+				if (state.Time > timeLimit)
+				{
+					return false;
+				}
+				const float mineralShortfall = stats.Minerals - state.Minerals;
+				const float vespeneShortfall = stats.Vespene - state.Vespene;
+				const bool ready = IsReady(state, type);
+				if (ready && mineralShortfall <= epsilon && vespeneShortfall <= epsilon)
+				{
+					break;
+				}
+				float next = state.Jobs.empty() ? std::numeric_limits<float>::infinity() : state.Jobs.front().Finish;
+				float mineralRate, vespeneRate, larvaRate;
+				GetRates(state, mineralRate, vespeneRate, larvaRate);
+				float wait = 0.0f;
+				if (mineralShortfall > epsilon)
+				{
+					wait = std::max(wait, mineralRate > 0.0f ? mineralShortfall / mineralRate : std::numeric_limits<float>::infinity());
+				}
+				if (vespeneShortfall > epsilon)
+				{
+					wait = std::max(wait, vespeneRate > 0.0f ? vespeneShortfall / vespeneRate : std::numeric_limits<float>::infinity());
+				}
+				if (stats.ProducedBy == UnitTypeId::Larva && state.Larva < 1.0f)
+				{
+					wait = std::max(wait, larvaRate > 0.0f ? (1.0f - state.Larva) / larvaRate : std::numeric_limits<float>::infinity());
+				}
+				if (wait > 0.0f)
+				{
+					//At least a hundredth of a second, so the time moves on despite float rounding
+					next = std::min(next, state.Time + std::max(wait, 0.01f));
+				}
+				if (next == std::numeric_limits<float>::infinity())
+				{
+					return false;
+				}
+				Advance(state, std::min(next, timeLimit + epsilon));
+			}
+
+			state.Minerals -= stats.Minerals;
+			state.Vespene -= stats.Vespene;
+			BuildOrderJob job = { state.Time + stats.BuildTime, type, UnitTypeId::Invalid, stats.AddOn, false };
+			switch (GetProducerUse(type))
+			{
+			case ProducerUse::Busy:
+				job.Producer = stats.ProducedBy;
+				break;
+			case ProducerUse::ConsumedAtFinish:
+				job.Producer = stats.ProducedBy;
+				job.MorphsProducer = true;
+				break;
+			case ProducerUse::ConsumedAtStart:
+				if (stats.ProducedBy == UnitTypeId::Larva)
+				{
+					state.Larva -= 1.0f;
+				}
+				else
+				{
+					--state.Owned[Index(stats.ProducedBy)];
+				}
+				break;
+			case ProducerUse::Free:
+				break;
+			}
+			state.AddJob(job);
+			return true;
+		}
+
+		//Actions worth trying: the target types and everything needed to produce them
+		void CollectActions()
+		{
+			std::vector<bool> relevant(Index(UnitTypeId::Count), false);
+			std::vector<UnitTypeId> open;
+			for (size_t i = 0; i < Target.size(); ++i)
+			{
+				if (Target[i] > 0)
+				{
+					Race = GetUnitStats(static_cast<UnitTypeId>(i)).Race;
+					open.push_back(static_cast<UnitTypeId>(i));
+				}
+			}
+			for (const UnitTypeId always : { GetWorker(Race), GetSupplyProvider(Race), GetTownHall(Race) })
+			{
+				open.push_back(always);
+			}
+			while (!open.empty())
+			{
+				const UnitTypeId type = open.back();
+				open.pop_back();
+				if (type == UnitTypeId::Invalid || type == UnitTypeId::Larva || relevant[Index(type)])
+				{
+					continue;
+				}
+				relevant[Index(type)] = true;
+				const UnitTypeStats& stats = GetUnitStats(type);
+				open.push_back(stats.ProducedBy);
+				open.push_back(stats.Requires);
+				open.push_back(stats.AddOn);
+				if (stats.Vespene > 0)
+				{
+					open.push_back(GetGasBuilding(Race));
+				}
+			}
+			Actions.clear();
+			for (size_t i = 0; i < relevant.size(); ++i)
+			{
+				if (relevant[i])
+				{
+					Actions.push_back(static_cast<UnitTypeId>(i));
+				}
+			}
+		}
+
+		int Missing(const BuildOrderState& state, UnitTypeId type) const
+		{
+			return std::max(Target[Index(type)] - CountPlanned(state, type), 0);
+		}
+
+		bool IsComplete(const BuildOrderState& state) const
+		{
+			for (size_t i = 0; i < Target.size(); ++i)
+			{
+				if (Target[i] > 0 && Missing(state, static_cast<UnitTypeId>(i)) > 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool IsTargetJob(const BuildOrderJob& job) const
+		{
+			for (size_t i = 0; i < Target.size(); ++i)
+			{
+				if (Target[i] > 0)
+				{
+					const std::vector<UnitTypeId>& family = GetFamily(static_cast<UnitTypeId>(i));
+					if (std::find(family.begin(), family.end(), job.Type) != family.end())
+					{
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		float TargetFinishTime(const BuildOrderState& state) const
+		{
+			float finish = state.Time;
+			for (const BuildOrderJob& job : state.Jobs)
+			{
+				if (IsTargetJob(job))
+				{
+					finish = std::max(finish, job.Finish);
+				}
+			}
+			return finish;
+		}
+
+		//Whether trying the action from this state can lead anywhere useful
+		bool IsUseful(const BuildOrderState& state, UnitTypeId type) const
+		{
+			if (Missing(state, type) > 0)
+			{
+				return true;
+			}
+			const int planned = CountPlanned(state, type);
+			if (planned == 0)
+			{
+				return true;
+			}
+			if (type == GetWorker(Race))
+			{
+				const int bases = CountPlanned(state, GetTownHall(Race));
+				const int geysers = CountPlanned(state, GetGasBuilding(Race));
+				return planned < bases * MineralWorkersPerBase + geysers * VespeneWorkersPerGeyser;
+			}
+			if (type == GetSupplyProvider(Race))
+			{
+				UnitCounts owned = state.Owned;
+				for (size_t i = 0; i < owned.size(); ++i)
+				{
+					owned[i] += state.Pending[i];
+				}
+				const float cap = SupplyCap(owned);
+				return cap < MaxSupply && cap - SupplyUsed(state) < 8.0f;
+			}
+			if (type == GetGasBuilding(Race))
+			{
+				//Another geyser only pays off if the planned ones cannot mine the missing vespene before the target can finish
+				float minerals, vespene;
+				GetMissingCost(state, minerals, vespene);
+				const float plannedRate = std::min(CountPlanned(state, GetWorker(Race)), planned * static_cast<int>(VespeneWorkersPerGeyser)) * VespeneRate;
+				return planned < 2 * CountPlanned(state, GetTownHall(Race)) && vespene - state.Vespene > plannedRate * (LowerBound(state) - state.Time);
+			}
+			//More producers only pay off while enough units are left for them
+			int products = 0;
+			for (const UnitTypeId action : Actions)
+			{
+				const UnitTypeStats& stats = GetUnitStats(action);
+				if ((stats.ProducedBy == type || stats.AddOn == type) && GetProducerUse(action) == ProducerUse::Busy)
+				{
+					products += Missing(state, action);
+				}
+			}
+			return planned < std::min(products, static_cast<int>(MaxProducersPerType));
+		}
+
+		//Resources still needed for the target: the missing units and the prerequisites of them not planned yet
+		void GetMissingCost(const BuildOrderState& state, float& outMinerals, float& outVespene) const
+		{
+			std::array<bool, static_cast<size_t>(UnitTypeId::Count)> counted = {};
+			outMinerals = 0.0f;
+			outVespene = 0.0f;
+			for (size_t i = 0; i < Target.size(); ++i)
+			{
+				const UnitTypeId type = static_cast<UnitTypeId>(i);
+				const int missing = Target[i] > 0 ? Missing(state, type) : 0;
+				if (missing > 0)
+				{
+					outMinerals += missing * static_cast<float>(GetUnitStats(type).Minerals);
+					outVespene += missing * static_cast<float>(GetUnitStats(type).Vespene);
+					AddPrerequisiteCost(state, type, counted, outMinerals, outVespene);
+				}
+			}
+		}
+
+		void AddPrerequisiteCost(const BuildOrderState& state, UnitTypeId type, std::array<bool, static_cast<size_t>(UnitTypeId::Count)>& counted,
+			float& minerals, float& vespene) const
+		{
+			const UnitTypeStats& stats = GetUnitStats(type);
+			for (const UnitTypeId prerequisite : { stats.Requires, stats.ProducedBy, stats.AddOn })
+			{
+				if (prerequisite == UnitTypeId::Invalid || prerequisite == UnitTypeId::Larva || counted[Index(prerequisite)]
+					|| CountPlanned(state, prerequisite) > 0)
+				{
+					continue;
+				}
+				counted[Index(prerequisite)] = true;
+				minerals += static_cast<float>(GetUnitStats(prerequisite).Minerals);
+				vespene += static_cast<float>(GetUnitStats(prerequisite).Vespene);
+				AddPrerequisiteCost(state, prerequisite, counted, minerals, vespene);
+			}
+		}
+
+		//Earliest time a unit of the family of the type exists, given unlimited resources
+		float GetReadyTime(const BuildOrderState& state, UnitTypeId type, int depth) const
+		{
+			if (type == UnitTypeId::Invalid || type == UnitTypeId::Larva || CountFamily(state.Owned, type) > 0)
+			{
+				return state.Time;
+			}
+			const std::vector<UnitTypeId>& family = GetFamily(type);
+			for (const BuildOrderJob& job : state.Jobs)
+			{
+				if (std::find(family.begin(), family.end(), job.Type) != family.end())
+				{
+					return job.Finish;
+				}
+			}
+			return GetEarliestStart(state, type, depth) + GetUnitStats(type).BuildTime;
+		}
+
+		//Earliest time production of the type can start, once its producer, requirement and add-on exist
+		float GetEarliestStart(const BuildOrderState& state, UnitTypeId type, int depth) const
+		{
+			//Deeper than any tech chain, in case the table ever has a cycle
+			const int maxDepth = 8;
+
+			float start = state.Time;
+			if (depth < maxDepth)
+			{
+				const UnitTypeStats& stats = GetUnitStats(type);
+				for (const UnitTypeId prerequisite : { stats.Requires, stats.ProducedBy, stats.AddOn })
+				{
+					start = std::max(start, GetReadyTime(state, prerequisite, depth + 1));
+				}
+			}
+			return start;
+		}
+
+		//Lower bound on the finish time, used for pruning: the missing units still have to wait for their tech chain
+		float LowerBound(const BuildOrderState& state) const
+		{
+			float bound = TargetFinishTime(state);
+			for (size_t i = 0; i < Target.size(); ++i)
+			{
+				const UnitTypeId type = static_cast<UnitTypeId>(i);
+				if (Target[i] > 0 && Missing(state, type) > 0)
+				{
+					bound = std::max(bound, GetEarliestStart(state, type, 0) + GetUnitStats(type).BuildTime);
+				}
+			}
+			return bound;
+		}
+
+		//Estimated finish time, used for ranking: the lower bound or the time to mine the missing resources
+		float Estimate(const BuildOrderState& state) const
+		{
+			float minerals, vespene;
+			GetMissingCost(state, minerals, vespene);
+			float mineralRate, vespeneRate, larvaRate;
+			GetRates(state, mineralRate, vespeneRate, larvaRate);
+			float mining = 0.0f;
+			if (minerals > state.Minerals)
+			{
+				mining = std::max(mining, (minerals - state.Minerals) / std::max(mineralRate, 0.1f));
+			}
+			if (vespene > state.Vespene)
+			{
+				mining = std::max(mining, (vespene - state.Vespene) / std::max(vespeneRate, 0.1f));
+			}
+			return std::max(LowerBound(state), state.Time + mining);
+		}
+
+		static uint64_t HashCounts(const BuildOrderState& state)
+		{
+			//FNV-1a
+			uint64_t hash = 14695981039346656037ULL;
+			for (size_t i = 0; i < state.Owned.size(); ++i)
+			{
+				hash = (hash ^ (static_cast<uint64_t>(state.Owned[i]) | static_cast<uint64_t>(state.Pending[i]) << 16)) * 1099511628211ULL;
+			}
+			return hash;
+		}
+
+		//Whether a state reached before is at least as good as this one: same units, reached no later, with at least the
+		//same resources and larvae, and every job finishing no later. Jobs are paired in finish order, so states whose
+		//jobs finish in a different order are not compared.
+		static bool Dominates(const Transposition& seen, const BuildOrderState& state)
+		{
+			if (seen.Time > state.Time || seen.Minerals < state.Minerals || seen.Vespene < state.Vespene || seen.Larva < state.Larva
+				|| seen.Jobs.size() != state.Jobs.size())
+			{
+				return false;
+			}
+			for (size_t i = 0; i < seen.Jobs.size(); ++i)
+			{
+				const BuildOrderJob& a = seen.Jobs[i];
+				const BuildOrderJob& b = state.Jobs[i];
+				if (a.Type != b.Type || a.Producer != b.Producer || a.AddOn != b.AddOn || a.MorphsProducer != b.MorphsProducer || a.Finish > b.Finish)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		static Transposition ToTransposition(const BuildOrderState& state)
+		{
+			return Transposition{ state.Owned, state.Pending, state.Time, state.Minerals, state.Vespene, state.Larva, state.Jobs };
+		}
+
+		//Whether a state reached before dominates the state; otherwise records it, replacing the entry it dominates
+		bool IsTransposition(const BuildOrderState& state)
+		{
+			const uint64_t hash = HashCounts(state);
+			const auto range = Transpositions.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				Transposition& seen = it->second;
+				if (seen.Owned != state.Owned || seen.Pending != state.Pending)
+				{
+					continue;
+				}
+				if (Dominates(seen, state))
+				{
+					return true;
+				}
+				if (seen.Time >= state.Time && seen.Minerals <= state.Minerals && seen.Vespene <= state.Vespene && seen.Larva <= state.Larva)
+				{
+					seen = ToTransposition(state);
+				}
+				return false;
+			}
+			Transpositions.emplace(hash, ToTransposition(state));
+			return false;
+		}
+
+		//Children of a range of beam nodes. Runs concurrently, so it only reads shared state.
+		void Expand(size_t begin, size_t end, float timeLimit, std::vector<Node>& outChildren, std::vector<Node>& outComplete) const
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				const Node& parent = Beam[i];
+				for (const UnitTypeId action : Actions)
+				{
+					if (!IsUseful(parent.State, action))
+					{
+						continue;
+					}
+					Node child;
+					child.State = parent.State;
+					if (!WaitAndStart(child.State, action, timeLimit))
+					{
+						continue;
+					}
+					child.Steps.reserve(parent.Steps.size() + 1);
+					child.Steps = parent.Steps;
+					child.Steps.push_back({ action, child.State.Time });
+					if (IsComplete(child.State))
+					{
+						child.Score = TargetFinishTime(child.State);
+						if (child.Score < timeLimit)
+						{
+							outComplete.push_back(std::move(child));
+						}
+						continue;
+					}
+					if (LowerBound(child.State) >= timeLimit)
+					{
+						continue;
+					}
+					child.Score = Estimate(child.State);
+					outChildren.push_back(std::move(child));
+				}
+			}
+		}
+
+		void ExpandLayer()
+		{
+			const float timeLimit = std::min(MaxTime, Best.FinishTime);
+			//A few tasks per thread, as the cost of a node varies with the waiting it simulates
+			const size_t tasks = std::min(Beam.size(), static_cast<size_t>(Pool->GetThreadCount()) * 4);
+			const size_t chunk = (Beam.size() + tasks - 1) / tasks;
+
+			std::vector<std::vector<Node>> children(tasks), complete(tasks);
+			Pool->ParallelFor(tasks, [this, chunk, timeLimit, &children, &complete](size_t task)
+			{
+				const size_t begin = std::min(task * chunk, Beam.size());
+				Expand(begin, std::min(begin + chunk, Beam.size()), timeLimit, children[task], complete[task]);
+			});
+
+			//Merged in beam order so the result depends on neither scheduling nor the number of threads
+			std::vector<Node> layer;
+			for (size_t task = 0; task < tasks; ++task)
+			{
+				for (Node& node : complete[task])
+				{
+					if (node.Score < Best.FinishTime)
+					{
+						Best.FinishTime = node.Score;
+						Best.Steps = std::move(node.Steps);
+					}
+				}
+				std::move(children[task].begin(), children[task].end(), std::back_inserter(layer));
+			}
+			std::stable_sort(layer.begin(), layer.end(), [](const Node& a, const Node& b) { return a.Score < b.Score; });
+
+			Beam.clear();
+			for (Node& node : layer)
+			{
+				if (Beam.size() >= BeamWidth)
+				{
+					break;
+				}
+				if (node.Score >= Best.FinishTime)
+				{
+					continue;
+				}
+				if (IsTransposition(node.State))
+				{
+					continue;
+				}
+				Beam.push_back(std::move(node));
+			}
+			++Layers;
+		}
+		#pragma endregion
+	};
+}
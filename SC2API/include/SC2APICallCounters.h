@@ -0,0 +1,211 @@
+#pragma once
+
+//Call counting is compiled in with SC2API_CALL_COUNTING defined; otherwise SC2API_COUNT_CALL is the bare call.
+#if defined(SC2API_CALL_COUNTING)
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+//Exported functions of Unit and UnitGroup that can be counted: X(Id, Name)
+#define SC2API_COUNTED_CALLS(X) \
+	X(UnitIsAccessible,				"Unit::IsAccessible") \
+	X(UnitGetType,					"Unit::GetType") \
+	X(UnitGetPosition,				"Unit::GetPosition") \
+	X(UnitGetOwner,					"Unit::GetOwner") \
+	X(UnitIsOwnedByLocalPlayer,		"Unit::IsOwnedByLocalPlayer") \
+	X(UnitIsOwnedByEnemyPlayer,		"Unit::IsOwnedByEnemyPlayer") \
+	X(UnitGetLife,					"Unit::GetLife") \
+	X(UnitGetShield,				"Unit::GetShield") \
+	X(UnitGetEnergy,				"Unit::GetEnergy") \
+	X(UnitGetCurrentOrder,			"Unit::GetCurrentOrder") \
+	X(UnitToString,					"Unit::ToString") \
+	X(UnitGroupHas,					"UnitGroup::Has") \
+	X(UnitGroupCount,				"UnitGroup::Count") \
+	X(UnitGroupFirst,				"UnitGroup::First") \
+	X(UnitGroupSendOrder,			"UnitGroup::SendOrder") \
+	X(UnitGroupQueueOrder,			"UnitGroup::QueueOrder") \
+	X(UnitGroupFilter,				"UnitGroup::Filter") \
+	X(UnitGroupGetAccessibleUnits,	"UnitGroup::GetAccessibleUnits") \
+	X(UnitGroupGetUnitsOfType,		"UnitGroup::GetUnitsOfType") \
+	X(UnitGroupToString,			"UnitGroup::ToString")
+
+namespace SC2API
+{
+	#define SC2API_COUNTED_CALLS_ENUM(Id, Name) Id,
+	enum class ApiCall : uint8_t
+	{
+		SC2API_COUNTED_CALLS(SC2API_COUNTED_CALLS_ENUM)
+		Count
+	};
+	#undef SC2API_COUNTED_CALLS_ENUM
+
+	/// <summary>
+	/// Calls of one API function over one frame.
+	/// </summary>
+	struct ApiCallStats
+	{
+		const char* Name = "";
+		uint64_t Count = 0;
+
+		/// <summary>
+		/// Milliseconds spent in the calls, including the overhead of timing them.
+		/// </summary>
+		double Time = 0.0;
+	};
+
+	/// <summary>
+	/// Counted calls of one frame, see ApiCallCounters::EndFrame.
+	/// </summary>
+	struct ApiCallSnapshot
+	{
+		uint64_t Frame = 0;
+		uint64_t TotalCount = 0;
+		double TotalTime = 0.0;
+
+		/// <summary>
+		/// Stats of every function, indexed by ApiCall.
+		/// </summary>
+		std::array<ApiCallStats, static_cast<size_t>(ApiCall::Count)> Calls;
+
+		const ApiCallStats& Get(ApiCall call) const
+		{
+			return Calls[static_cast<size_t>(call)];
+		}
+
+		/// <summary>
+		/// Gets the functions that were called, most called first.
+		/// </summary>
+		std::vector<ApiCallStats> GetMostCalled() const
+		{
+			std::vector<ApiCallStats> called;
+			for (const ApiCallStats& stats : Calls)
+			{
+				if (stats.Count > 0)
+				{
+					called.push_back(stats);
+				}
+			}
+			std::sort(called.begin(), called.end(), [](const ApiCallStats& a, const ApiCallStats& b)
+			{
+				return a.Count > b.Count;
+			});
+			return called;
+		}
+	};
+
+	/// <summary>
+	/// Counts and times calls into the SC2API binary per frame, to find call patterns worth replacing with bulk queries
+	/// such as FillUnitGroupState. Calls are counted where they are wrapped in SC2API_COUNT_CALL, which the inline
+	/// parts of the API do; wrap the hot call sites of the bot the same way. The API itself never calls some of the
+	/// functions, e.g. UnitGroup::GetUnitsOfType or UnitGroup::SendOrder, so these count the calls of the bot only.
+	/// Counters are atomic, so calls may be counted from any thread.
+	/// </summary>
+	class ApiCallCounters
+	{
+	public:
+		static ApiCallCounters& Get()
+		{
+			static ApiCallCounters counters;
+			return counters;
+		}
+
+		void Record(ApiCall call, uint64_t nanoseconds)
+		{
+			Counter& counter = Counters[static_cast<size_t>(call)];
+			counter.Count.fetch_add(1, std::memory_order_relaxed);
+			counter.Time.fetch_add(nanoseconds, std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Ends the current frame: moves the counters into the snapshot and restarts them from zero.
+		/// Call once per game tick, from one thread.
+		/// </summary>
+		void EndFrame()
+		{
+			Snapshot.Frame = Frame++;
+			Snapshot.TotalCount = 0;
+			Snapshot.TotalTime = 0.0;
+			for (size_t i = 0; i < Counters.size(); ++i)
+			{
+				ApiCallStats& stats = Snapshot.Calls[i];
+				stats.Name = GetName(static_cast<ApiCall>(i));
+				stats.Count = Counters[i].Count.exchange(0, std::memory_order_relaxed);
+				stats.Time = Counters[i].Time.exchange(0, std::memory_order_relaxed) / 1e6;
+				Snapshot.TotalCount += stats.Count;
+				Snapshot.TotalTime += stats.Time;
+			}
+		}
+
+		/// <summary>
+		/// Gets the calls of the last ended frame. Valid until the next EndFrame.
+		/// </summary>
+		const ApiCallSnapshot& GetSnapshot() const
+		{
+			return Snapshot;
+		}
+
+		static const char* GetName(ApiCall call)
+		{
+			#define SC2API_COUNTED_CALLS_NAME(Id, Name) Name,
+			static const char* const names[] = { SC2API_COUNTED_CALLS(SC2API_COUNTED_CALLS_NAME) };
+			#undef SC2API_COUNTED_CALLS_NAME
+			return names[static_cast<size_t>(call)];
+		}
+
+		static uint64_t Now()
+		{
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+		#pragma region Implementations
+	private:
+		struct Counter
+		{
+			std::atomic<uint64_t> Count{ 0 };
+			std::atomic<uint64_t> Time{ 0 };
+		};
+
+		std::array<Counter, static_cast<size_t>(ApiCall::Count)> Counters;
+		ApiCallSnapshot Snapshot;
+		uint64_t Frame = 0;
+
+		ApiCallCounters() = default;
+		#pragma endregion
+	};
+
+	namespace Internal
+	{
+		template<typename FuncT>
+		auto CountCall(ApiCall call, FuncT&& func) -> decltype(func())
+		{
+			struct Timer
+			{
+				ApiCall Call;
+				uint64_t Start;
+
+				~Timer()
+				{
+					ApiCallCounters::Get().Record(Call, ApiCallCounters::Now() - Start);
+				}
+			} timer{ call, ApiCallCounters::Now() };
+			return func();
+		}
+	}
+}
+
+//Counts and times one call into the SC2API binary, e.g. SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition())
+#define SC2API_COUNT_CALL(call, expr) (SC2API::Internal::CountCall(SC2API::ApiCall::call, [&]() { return (expr); }))
+
+//Ends the call counter frame, see ApiCallCounters::EndFrame
+#define SC2API_COUNT_CALLS_END_FRAME() SC2API::ApiCallCounters::Get().EndFrame()
+
+#else
+
+#define SC2API_COUNT_CALL(call, expr) (expr)
+#define SC2API_COUNT_CALLS_END_FRAME() do {} while (0)
+
+#endif
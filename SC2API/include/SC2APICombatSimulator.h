@@ -0,0 +1,380 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIUnitGroup.h"
+#include "SC2APISimd.h"
+#include "SC2APIUnitStats.h"
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Combat relevant stats of a unit type. A weapon with a cooldown of 0 does not exist.
+	/// </summary>
+	struct CombatStats
+	{
+		float Armor;
+		bool IsAir;
+		float GroundDamage;
+		float GroundCooldown;
+		float AirDamage;
+		float AirCooldown;
+	};
+
+	/// <summary>
+	/// Gives the combat stats of a unit type, or empty value for units that do not take part in fights.
+	/// </summary>
+	using CombatStatsFunc = std::function<Optional<CombatStats>(const std::string& unitType)>;
+
+	/// <summary>
+	/// Combat stats of a unit type from the unit stats table, without upgrades.
+	/// </summary>
+	/// <returns>The stats, or empty value for types not in the table and types without a weapon</returns>
+	inline Optional<CombatStats> GetCombatStats(const std::string& unitType)
+	{
+		const Optional<UnitTypeId> id = UnitTypeIdFromName(unitType);
+		if (!id.hasValue())
+		{
+			return{};
+		}
+		const UnitTypeStats& stats = GetUnitStats(id.value());
+		if (stats.GroundCooldown <= 0.0f && stats.AirCooldown <= 0.0f)
+		{
+			return{};
+		}
+		return CombatStats{ stats.Armor, stats.Is(UnitFilterFlag::Air), stats.GroundDamage, stats.GroundCooldown, stats.AirDamage, stats.AirCooldown };
+	}
+
+	/// <summary>
+	/// One side of a fight in structure-of-arrays layout. Entry i describes one unit; health is life plus shield.
+	/// Snapshots are cheap to copy, so what-if variants (reinforcements, losses) can be derived from one another.
+	/// </summary>
+	struct CombatArmy
+	{
+		std::vector<float> Health;
+		std::vector<float> Armor;
+		std::vector<float> IsAir;
+		std::vector<float> GroundDamage;
+		std::vector<float> GroundRate;
+		std::vector<float> AirDamage;
+		std::vector<float> AirRate;
+
+		/// <summary>
+		/// Adds a unit to the army.
+		/// </summary>
+		/// <param name="stats">Stats of the unit type</param>
+		/// <param name="health">Current life plus shield</param>
+		void Add(const CombatStats& stats, float health)
+		{
+			Health.push_back(health);
+			Armor.push_back(stats.Armor);
+			IsAir.push_back(stats.IsAir ? 1.0f : 0.0f);
+			GroundDamage.push_back(stats.GroundDamage);
+			GroundRate.push_back(stats.GroundCooldown > 0.0f ? 1.0f / stats.GroundCooldown : 0.0f);
+			AirDamage.push_back(stats.AirDamage);
+			AirRate.push_back(stats.AirCooldown > 0.0f ? 1.0f / stats.AirCooldown : 0.0f);
+		}
+
+		/// <summary>
+		/// Adds the accessible units of a group that have stats.
+		/// </summary>
+		/// <param name="getStats">Gives the stats of a unit type, GetCombatStats by default</param>
+		void Add(const UnitGroup& group, const CombatStatsFunc& getStats = &GetCombatStats)
+		{
+			UnitGroupState state;
+			FillUnitGroupState(group, state);
+			for (size_t i = 0; i < state.Count(); ++i)
+			{
+				if (!state.IsAccessible(i))
+				{
+					continue;
+				}
+				const Optional<std::string> type = SC2API_COUNT_CALL(UnitGetType, state.Units[i].GetType());
+				if (!type.hasValue())
+				{
+					continue;
+				}
+				const Optional<CombatStats> stats = getStats(type.value());
+				if (stats.hasValue())
+				{
+					Add(stats.value(), state.Life[i] + state.Shield[i]);
+				}
+			}
+		}
+
+		size_t Count() const
+		{
+			return Health.size();
+		}
+
+		void Clear()
+		{
+			for (std::vector<float>* column : { &Health, &Armor, &IsAir, &GroundDamage, &GroundRate, &AirDamage, &AirRate })
+			{
+				column->clear();
+			}
+		}
+	};
+
+	/// <summary>
+	/// Winner of a simulated fight.
+	/// </summary>
+	enum class CombatWinner
+	{
+		Attacker,
+		Defender,
+
+		/// <summary>
+		/// Both armies died in the same time step.
+		/// </summary>
+		Draw,
+
+		/// <summary>
+		/// Both armies still stand when the time limit is reached, e.g. when neither can hit the other.
+		/// </summary>
+		Undecided,
+	};
+
+	struct CombatOutcome
+	{
+		CombatWinner Winner;
+
+		/// <summary>
+		/// Simulated seconds until the fight was decided, the time limit if it was not.
+		/// </summary>
+		float Duration;
+
+		size_t AttackerSurvivors;
+		size_t DefenderSurvivors;
+		float AttackerHealth;
+		float DefenderHealth;
+	};
+
+	/// <summary>
+	/// Predicts fights between two armies in fixed time steps.
+	/// Every step each army pours its damage per second into the other: units with a ground weapon fire at ground
+	/// targets while any are left, the rest fire at air targets. Damage is focused on targets in index order and spills
+	/// over to the next target, and armor is that of the current target, lowering each hit to at least MinDamage.
+	/// The fight is assumed to be engaged, so ranges and positions are not modelled.
+	/// Damage sums are vectorized over units; results are deterministic for a given build.
+	/// The simulator keeps scratch buffers, so use one instance per thread.
+	/// </summary>
+	class CombatSimulator
+	{
+	public:
+		/// <summary>
+		/// Length of a time step in seconds.
+		/// </summary>
+		float TimeStep = 0.25f;
+
+		/// <summary>
+		/// Time limit of a fight in seconds.
+		/// </summary>
+		float MaxDuration = 60.0f;
+
+		/// <summary>
+		/// Damage of a hit after armor is applied never drops below this.
+		/// </summary>
+		float MinDamage = 0.5f;
+
+		/// <summary>
+		/// Simulates a fight.
+		/// </summary>
+		/// <param name="attacker">The first army</param>
+		/// <param name="defender">The second army</param>
+		/// <returns>The predicted outcome</returns>
+		CombatOutcome Simulate(const CombatArmy& attacker, const CombatArmy& defender)
+		{
+			Sides[0].Load(attacker);
+			Sides[1].Load(defender);
+
+			float time = 0.0f;
+			while (Sides[0].IsAlive() && Sides[1].IsAlive() && time < MaxDuration)
+			{
+				float groundDamage[2], airDamage[2];
+				for (int side = 0; side < 2; ++side)
+				{
+					ComputeDamage(Sides[side], Sides[1 - side], groundDamage[side], airDamage[side]);
+				}
+				//Both armies fire before either takes losses, so the exchange does not favour the side simulated first
+				for (int side = 0; side < 2; ++side)
+				{
+					Sides[1 - side].ApplyDamage(groundDamage[side] * TimeStep, false);
+					Sides[1 - side].ApplyDamage(airDamage[side] * TimeStep, true);
+				}
+				time += TimeStep;
+			}
+
+			CombatOutcome outcome;
+			outcome.Duration = std::min(time, MaxDuration);
+			outcome.AttackerSurvivors = Sides[0].AliveCount[0] + Sides[0].AliveCount[1];
+			outcome.DefenderSurvivors = Sides[1].AliveCount[0] + Sides[1].AliveCount[1];
+			outcome.AttackerHealth = Sides[0].TotalHealth();
+			outcome.DefenderHealth = Sides[1].TotalHealth();
+			if (Sides[0].IsAlive() && Sides[1].IsAlive())
+			{
+				outcome.Winner = CombatWinner::Undecided;
+			}
+			else if (Sides[0].IsAlive())
+			{
+				outcome.Winner = CombatWinner::Attacker;
+			}
+			else if (Sides[1].IsAlive())
+			{
+				outcome.Winner = CombatWinner::Defender;
+			}
+			else
+			{
+				outcome.Winner = CombatWinner::Draw;
+			}
+			return outcome;
+		}
+
+		#pragma region Implementations
+	private:
+		using PackT = Simd::Pack<float>;
+
+		//Working copy of an army, padded with dead units to a whole number of packs
+		struct Side
+		{
+			std::vector<float> Health;
+			std::vector<float> Armor;
+			std::vector<float> IsAir;
+			std::vector<float> Alive;
+			std::vector<float> GroundDamage;
+			std::vector<float> GroundRate;
+			std::vector<float> AirDamage;
+			std::vector<float> AirRate;
+
+			//Air rate of units without a ground weapon, the ones still shooting air while ground targets are left
+			std::vector<float> AirOnlyRate;
+
+			size_t Count;
+			size_t AliveCount[2];
+
+			//First possibly alive target per layer (ground, air)
+			size_t Front[2];
+
+			void Load(const CombatArmy& army)
+			{
+				Count = army.Count();
+				const size_t padded = (Count + PackT::Width - 1) / PackT::Width * PackT::Width;
+				auto copy = [padded](std::vector<float>& to, const std::vector<float>& from)
+				{
+					to.assign(from.begin(), from.end());
+					to.resize(padded, 0.0f);
+				};
+				copy(Health, army.Health);
+				copy(Armor, army.Armor);
+				copy(IsAir, army.IsAir);
+				copy(GroundDamage, army.GroundDamage);
+				copy(GroundRate, army.GroundRate);
+				copy(AirDamage, army.AirDamage);
+				copy(AirRate, army.AirRate);
+				Alive.assign(padded, 0.0f);
+				AirOnlyRate.assign(padded, 0.0f);
+				AliveCount[0] = AliveCount[1] = 0;
+				for (size_t i = 0; i < Count; ++i)
+				{
+					if (Health[i] > 0.0f)
+					{
+						Alive[i] = 1.0f;
+						++AliveCount[IsAir[i] != 0.0f ? 1 : 0];
+					}
+					AirOnlyRate[i] = GroundRate[i] > 0.0f ? 0.0f : AirRate[i];
+				}
+				Front[0] = Front[1] = 0;
+				SkipDead(false);
+				SkipDead(true);
+			}
+
+			bool IsAlive() const
+			{
+				return AliveCount[0] + AliveCount[1] > 0;
+			}
+
+			float TotalHealth() const
+			{
+				float total = 0.0f;
+				for (size_t i = 0; i < Count; ++i)
+				{
+					total += Alive[i] * Health[i];
+				}
+				return total;
+			}
+
+			void SkipDead(bool air)
+			{
+				size_t& front = Front[air ? 1 : 0];
+				while (front < Count && (Alive[front] == 0.0f || (IsAir[front] != 0.0f) != air))
+				{
+					++front;
+				}
+			}
+
+			float FrontArmor(bool air) const
+			{
+				return Front[air ? 1 : 0] < Count ? Armor[Front[air ? 1 : 0]] : 0.0f;
+			}
+
+			void ApplyDamage(float damage, bool air)
+			{
+				size_t& front = Front[air ? 1 : 0];
+				while (damage > 0.0f && front < Count)
+				{
+					const float dealt = std::min(damage, Health[front]);
+					Health[front] -= dealt;
+					damage -= dealt;
+					if (Health[front] <= 0.0f)
+					{
+						Alive[front] = 0.0f;
+						--AliveCount[air ? 1 : 0];
+						SkipDead(air);
+					}
+				}
+			}
+		};
+
+		Side Sides[2];
+
+		//Sum over units of alive * max(minDamage, damage - armor) * rate
+		float SumDamagePerSecond(const Side& side, const std::vector<float>& damage, const std::vector<float>& rate, float armor) const
+		{
+			const PackT minDamage = PackT::Broadcast(MinDamage);
+			const PackT targetArmor = PackT::Broadcast(armor);
+			PackT sum = PackT::Broadcast(0.0f);
+			for (size_t i = 0; i < side.Alive.size(); i += PackT::Width)
+			{
+				const PackT hit = Max(minDamage, PackT::Load(&damage[i]) - targetArmor);
+				sum = sum + PackT::Load(&side.Alive[i]) * hit * PackT::Load(&rate[i]);
+			}
+			float lanes[PackT::Width];
+			sum.Store(lanes);
+			float total = 0.0f;
+			for (size_t lane = 0; lane < PackT::Width; ++lane)
+			{
+				total += lanes[lane];
+			}
+			return total;
+		}
+
+		void ComputeDamage(const Side& shooter, const Side& target, float& outGround, float& outAir) const
+		{
+			outGround = 0.0f;
+			outAir = 0.0f;
+			const bool groundTargets = target.AliveCount[0] > 0;
+			if (groundTargets)
+			{
+				outGround = SumDamagePerSecond(shooter, shooter.GroundDamage, shooter.GroundRate, target.FrontArmor(false));
+			}
+			if (target.AliveCount[1] > 0)
+			{
+				outAir = SumDamagePerSecond(shooter, shooter.AirDamage, groundTargets ? shooter.AirOnlyRate : shooter.AirRate, target.FrontArmor(true));
+			}
+		}
+		#pragma endregion
+	};
+}
@@ -0,0 +1,495 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APICallCounters.h"
+#include "SC2APIUnit.h"
+#include "SC2APIUnitGroup.h"
+#include "SC2APIGameData.h"
+#include "SC2APIPlayer.h"
+#include "SC2APIPoint.h"
+#include "SC2APIHandleMap.h"
+#include "SC2APIUnitStats.h"
+#include <set>
+#include <string>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Economy of one base of the local player.
+	/// </summary>
+	struct BaseEconomy
+	{
+		/// <summary>
+		/// The town hall the base is built around. Not accessible anymore once IsActive is false.
+		/// </summary>
+		Unit TownHall;
+
+		Point Position;
+		int MineralFields = 0;
+		int Geysers = 0;
+
+		/// <summary>
+		/// Finished gas buildings of the local player at the base.
+		/// </summary>
+		int GasBuildings = 0;
+
+		/// <summary>
+		/// Gas buildings still under construction, which cannot be mined yet. They move to GasBuildings in the
+		/// EconomyTracker::Update after they finished.
+		/// </summary>
+		int UnfinishedGasBuildings = 0;
+
+		/// <summary>
+		/// Workers of the local player near the base.
+		/// </summary>
+		int Workers = 0;
+
+		bool IsActive = false;
+
+		/// <summary>
+		/// Number of workers that mine at full speed: two per mineral field and three per finished gas building.
+		/// </summary>
+		int GetIdealWorkers() const
+		{
+			return MineralFields * 2 + GasBuildings * 3;
+		}
+
+		/// <summary>
+		/// Workers relative to the ideal count; 1 is saturated, above 1 oversaturated.
+		/// </summary>
+		float GetSaturation() const
+		{
+			const int ideal = GetIdealWorkers();
+			return ideal > 0 ? static_cast<float>(Workers) / ideal : 0.0f;
+		}
+
+		/// <summary>
+		/// Workers missing for saturation, negative when oversaturated.
+		/// </summary>
+		int GetMissingWorkers() const
+		{
+			return GetIdealWorkers() - Workers;
+		}
+	};
+
+	/// <summary>
+	/// Economy model of the local player, maintained incrementally instead of recomputed every frame.
+	/// Town halls define bases; mineral fields, geysers and gas buildings are assigned to the nearest base once, when
+	/// they appear or a base is founded, and removed when they die or are mined out. Workers count for the nearest base
+	/// within BaseRadius; Update() moves them between bases as they walk, at a cost linear in workers times bases.
+	/// Gas buildings are created when placed and count for saturation once Update() sees them finished.
+	/// Which worker mines which field is not exposed by the API, so saturation is by proximity.
+	/// </summary>
+	class EconomyTracker : public SignalObject
+	{
+	public:
+		/// <summary>
+		/// Distance from a town hall within which resources and workers belong to its base.
+		/// </summary>
+		float BaseRadius = 10.0f;
+
+		/// <summary>
+		/// Takes the current economy and starts tracking it.
+		/// </summary>
+		EconomyTracker()
+		{
+			Unit::SignalUnitCreated().connect(this, &EconomyTracker::OnUnitCreated);
+			Unit::SignalUnitDestroyed().connect(this, &EconomyTracker::OnUnitDestroyed);
+			Unit::SignalUnitEnterVision().connect(this, &EconomyTracker::OnUnitEnterVision);
+			Refresh();
+		}
+
+		/// <summary>
+		/// Gets all bases, including ones whose town hall was lost (IsActive false). Indices are stable.
+		/// </summary>
+		const std::vector<BaseEconomy>& GetBases() const
+		{
+			return Bases;
+		}
+
+		/// <summary>
+		/// Gets the base a unit is assigned to.
+		/// </summary>
+		/// <returns>Index into GetBases(), or empty value if the unit is not tracked or not near a base</returns>
+		Optional<size_t> GetBaseOf(const Unit& unit) const
+		{
+			const Tracked* tracked = TrackedUnits.Find(unit.id);
+			if (tracked == nullptr || tracked->Base == NoBase)
+			{
+				return{};
+			}
+			return static_cast<size_t>(tracked->Base);
+		}
+
+		int GetWorkerCount() const
+		{
+			return WorkerCount;
+		}
+
+		/// <summary>
+		/// Gets the active base missing the most workers.
+		/// </summary>
+		/// <returns>Index into GetBases(), or empty value if every base is saturated</returns>
+		Optional<size_t> GetLeastSaturatedBase() const
+		{
+			Optional<size_t> best;
+			int mostMissing = 0;
+			for (size_t i = 0; i < Bases.size(); ++i)
+			{
+				if (Bases[i].IsActive && Bases[i].GetMissingWorkers() > mostMissing)
+				{
+					mostMissing = Bases[i].GetMissingWorkers();
+					best = i;
+				}
+			}
+			return best;
+		}
+
+		/// <summary>
+		/// Moves workers to the base they are near now, and counts gas buildings that finished construction, which costs
+		/// one unit query while any is under construction. Call once per game tick or less often.
+		/// </summary>
+		void Update()
+		{
+			UpdateGasBuildings();
+			TrackedUnits.ForEach([this](HandleId id, Tracked& tracked)
+			{
+				if (tracked.Kind != UnitKind::Worker)
+				{
+					return;
+				}
+				Unit worker;
+				worker.id = id;
+				const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, worker.GetPosition());
+				if (position.hasValue())
+				{
+					tracked.Position = position.value();
+					Assign(tracked, FindBase(position.value()));
+				}
+			});
+		}
+
+		/// <summary>
+		/// Rebuilds the model from all accessible units.
+		/// </summary>
+		void Refresh()
+		{
+			Bases.clear();
+			TrackedUnits.Clear();
+			UnfinishedGasBuildings.clear();
+			WorkerCount = 0;
+			const UnitGroup own = SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self));
+			const UnitGroup underConstruction = SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self | UnitFilterFlag::UnderConstruction));
+			//Bases first, so resources and workers find them
+			for (const Unit& unit : own)
+			{
+				if (GetKind(unit) == UnitKind::TownHall)
+				{
+					Add(unit, UnitKind::TownHall);
+				}
+			}
+			for (const Unit& unit : SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits()))
+			{
+				const UnitKind kind = GetKind(unit);
+				const bool isOwn = SC2API_COUNT_CALL(UnitGroupHas, own.Has(unit));
+				if (kind == UnitKind::MineralField || kind == UnitKind::Geyser || (isOwn && kind != UnitKind::Other && kind != UnitKind::TownHall))
+				{
+					Add(unit, kind, !SC2API_COUNT_CALL(UnitGroupHas, underConstruction.Has(unit)));
+				}
+			}
+		}
+
+		#pragma region Implementations
+	private:
+		enum class UnitKind : uint8_t
+		{
+			Other,
+			TownHall,
+			Worker,
+			GasBuilding,
+			MineralField,
+			Geyser,
+		};
+
+		enum : int
+		{
+			NoBase = -1,
+		};
+
+		struct Tracked
+		{
+			UnitKind Kind = UnitKind::Other;
+			int Base = NoBase;
+			//Position when added, for workers the one of the last Update()
+			Point Position = {};
+			//False for gas buildings under construction
+			bool Completed = true;
+		};
+
+		std::vector<BaseEconomy> Bases;
+		HandleMap<Tracked> TrackedUnits;
+		int WorkerCount = 0;
+
+		//Gas buildings under construction, whose completion Update() checks
+		std::vector<Unit> UnfinishedGasBuildings;
+
+		static UnitKind GetKind(const Unit& unit)
+		{
+			static const std::set<std::string> mineralFields =
+			{
+				Units::MineralField, Units::MineralField750, Units::RichMineralField, Units::RichMineralField750,
+				Units::LabMineralField, Units::LabMineralField750, Units::PurifierMineralField, Units::PurifierMineralField750,
+				Units::PurifierRichMineralField, Units::PurifierRichMineralField750,
+			};
+			static const std::set<std::string> geysers =
+			{
+				Units::VespeneGeyser, Units::SpacePlatformGeyser, Units::RichVespeneGeyser, Units::ProtossVespeneGeyser,
+				Units::PurifierVespeneGeyser, Units::ShakurasVespeneGeyser,
+			};
+			const Optional<std::string> type = SC2API_COUNT_CALL(UnitGetType, unit.GetType());
+			if (!type.hasValue())
+			{
+				return UnitKind::Other;
+			}
+			if (mineralFields.count(type.value()) != 0)
+			{
+				return UnitKind::MineralField;
+			}
+			if (geysers.count(type.value()) != 0)
+			{
+				return UnitKind::Geyser;
+			}
+			const Optional<UnitTypeId> id = UnitTypeIdFromName(type.value());
+			if (!id.hasValue())
+			{
+				return UnitKind::Other;
+			}
+			switch (id.value())
+			{
+			case UnitTypeId::SCV:
+			case UnitTypeId::Drone:
+			case UnitTypeId::Probe:
+				return UnitKind::Worker;
+			case UnitTypeId::Refinery:
+			case UnitTypeId::Extractor:
+			case UnitTypeId::Assimilator:
+				return UnitKind::GasBuilding;
+			default:
+				break;
+			}
+			//Morphed town halls (Lair, Orbital Command...) count as their base type
+			UnitTypeId base = id.value();
+			while (GetMorphBase(base) != UnitTypeId::Invalid)
+			{
+				base = GetMorphBase(base);
+			}
+			return base == UnitTypeId::CommandCenter || base == UnitTypeId::Hatchery || base == UnitTypeId::Nexus
+				? UnitKind::TownHall : UnitKind::Other;
+		}
+
+		int FindBase(const Point& position) const
+		{
+			int best = NoBase;
+			double bestDistance = static_cast<double>(BaseRadius) * BaseRadius;
+			for (size_t i = 0; i < Bases.size(); ++i)
+			{
+				if (!Bases[i].IsActive)
+				{
+					continue;
+				}
+				const double dx = Bases[i].Position.X - position.X;
+				const double dy = Bases[i].Position.Y - position.Y;
+				const double distance = dx * dx + dy * dy;
+				if (distance <= bestDistance)
+				{
+					bestDistance = distance;
+					best = static_cast<int>(i);
+				}
+			}
+			return best;
+		}
+
+		int* GetCounter(BaseEconomy& base, const Tracked& tracked)
+		{
+			switch (tracked.Kind)
+			{
+			case UnitKind::Worker:
+				return &base.Workers;
+			case UnitKind::GasBuilding:
+				return tracked.Completed ? &base.GasBuildings : &base.UnfinishedGasBuildings;
+			case UnitKind::MineralField:
+				return &base.MineralFields;
+			case UnitKind::Geyser:
+				return &base.Geysers;
+			default:
+				return nullptr;
+			}
+		}
+
+		void Assign(Tracked& tracked, int base)
+		{
+			if (tracked.Base == base)
+			{
+				return;
+			}
+			if (tracked.Base != NoBase)
+			{
+				--*GetCounter(Bases[tracked.Base], tracked);
+			}
+			tracked.Base = base;
+			if (base != NoBase)
+			{
+				++*GetCounter(Bases[base], tracked);
+			}
+		}
+
+		void Add(const Unit& unit, UnitKind kind, bool completed = true)
+		{
+			const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition());
+			if (kind == UnitKind::Other || !position.hasValue() || TrackedUnits.Contains(unit.id))
+			{
+				return;
+			}
+			Tracked tracked;
+			tracked.Kind = kind;
+			tracked.Position = position.value();
+			tracked.Completed = completed || kind != UnitKind::GasBuilding;
+			if (!tracked.Completed)
+			{
+				UnfinishedGasBuildings.push_back(unit);
+			}
+			if (kind == UnitKind::TownHall)
+			{
+				AddBase(unit, position.value());
+				TrackedUnits.Insert(unit.id, tracked);
+				return;
+			}
+			if (kind == UnitKind::Worker)
+			{
+				++WorkerCount;
+			}
+			Assign(tracked, FindBase(position.value()));
+			TrackedUnits.Insert(unit.id, tracked);
+		}
+
+		void UpdateGasBuildings()
+		{
+			if (UnfinishedGasBuildings.empty())
+			{
+				return;
+			}
+			const UnitGroup underConstruction = SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self | UnitFilterFlag::UnderConstruction));
+			for (size_t i = 0; i < UnfinishedGasBuildings.size();)
+			{
+				if (SC2API_COUNT_CALL(UnitGroupHas, underConstruction.Has(UnfinishedGasBuildings[i])))
+				{
+					++i;
+					continue;
+				}
+				//Finished, or destroyed and no longer tracked
+				Tracked* tracked = TrackedUnits.Find(UnfinishedGasBuildings[i].id);
+				if (tracked != nullptr)
+				{
+					const int base = tracked->Base;
+					Assign(*tracked, NoBase);
+					tracked->Completed = true;
+					Assign(*tracked, base);
+				}
+				UnfinishedGasBuildings[i] = UnfinishedGasBuildings.back();
+				UnfinishedGasBuildings.pop_back();
+			}
+		}
+
+		void AddBase(const Unit& townHall, const Point& position)
+		{
+			//Reuse the slot of a lost base at the same spot so indices stay meaningful
+			size_t index = Bases.size();
+			for (size_t i = 0; i < Bases.size(); ++i)
+			{
+				if (!Bases[i].IsActive && Bases[i].Position.X == position.X && Bases[i].Position.Y == position.Y)
+				{
+					index = i;
+				}
+			}
+			if (index == Bases.size())
+			{
+				Bases.emplace_back();
+			}
+			BaseEconomy& base = Bases[index];
+			base = BaseEconomy();
+			base.TownHall = townHall;
+			base.Position = position;
+			base.IsActive = true;
+			//Resources and workers without a base may belong to the new one
+			TrackedUnits.ForEach([this](HandleId, Tracked& tracked)
+			{
+				if (tracked.Kind != UnitKind::TownHall && tracked.Base == NoBase)
+				{
+					Assign(tracked, FindBase(tracked.Position));
+				}
+			});
+		}
+
+		void RemoveBase(int index)
+		{
+			Bases[index].IsActive = false;
+			TrackedUnits.ForEach([this, index](HandleId, Tracked& tracked)
+			{
+				if (tracked.Base == index)
+				{
+					Assign(tracked, FindBase(tracked.Position));
+				}
+			});
+		}
+
+		void OnUnitCreated(Unit eventUnit, int eventPlayerId)
+		{
+			if (eventPlayerId == PlayerLocal())
+			{
+				//Structures are created when placed; gas buildings count once finished
+				const UnitKind kind = GetKind(eventUnit);
+				Add(eventUnit, kind, kind != UnitKind::GasBuilding);
+			}
+		}
+
+		void OnUnitEnterVision(Unit eventUnit)
+		{
+			const UnitKind kind = GetKind(eventUnit);
+			if (kind == UnitKind::MineralField || kind == UnitKind::Geyser)
+			{
+				Add(eventUnit, kind);
+			}
+		}
+
+		void OnUnitDestroyed(Unit eventUnit, Optional<Unit> /*killerUnit*/)
+		{
+			Tracked* tracked = TrackedUnits.Find(eventUnit.id);
+			if (tracked == nullptr)
+			{
+				return;
+			}
+			if (tracked->Kind == UnitKind::TownHall)
+			{
+				for (size_t i = 0; i < Bases.size(); ++i)
+				{
+					if (Bases[i].IsActive && Bases[i].TownHall == eventUnit)
+					{
+						TrackedUnits.Erase(eventUnit.id);
+						RemoveBase(static_cast<int>(i));
+						return;
+					}
+				}
+			}
+			else
+			{
+				if (tracked->Kind == UnitKind::Worker)
+				{
+					--WorkerCount;
+				}
+				Assign(*tracked, NoBase);
+			}
+			TrackedUnits.Erase(eventUnit.id);
+		}
+		#pragma endregion
+	};
+}
@@ -0,0 +1,509 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIPoint.h"
+#include "SC2APIGame.h"
+#include "SC2APIUnitStats.h"
+#include "SC2APIEventLogFormat.h"
+#include "Utils.h"
+#include <zycore/BinaryStream.hpp>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Static description of an event: its id in the file, its name, and the names and types of its fields.
+	/// Define formats as constexpr constants and keep their ids stable, so logs of older bots still decode.
+	/// Ids start at EventRecordId::FirstEventFormatId; ids 16 to 31 are used by UnitEventRecorder.
+	/// The text is rendered by the decoder with one "{}" per field in order, e.g.
+	/// constexpr EventFormat<Unit, int> UnitKilled{ 32, "UnitKilled", "{} killed by player {}", { "unit", "player" } };
+	/// Leave the text empty to render the fields as name=value pairs.
+	/// </summary>
+	template<class ... FieldsT>
+	struct EventFormat
+	{
+		uint16_t Id;
+		const char* Name;
+		const char* Text;
+		const char* FieldNames[sizeof...(FieldsT) > 0 ? sizeof...(FieldsT) : 1];
+	};
+
+	#pragma region Implementations
+	namespace Internal
+	{
+		//Packs the fields of a record, which then goes through OBinaryStream in one write instead of one per field
+		struct EventRecordWriter
+		{
+			uint8_t* Out;
+
+			template<class T>
+			void Put(const T& value)
+			{
+				std::memcpy(Out, &value, sizeof(value));
+				Out += sizeof(value);
+			}
+		};
+
+		//Storage of a field type; types without a specialization cannot be fields
+		template<class T>
+		struct EventField;
+
+		template<>
+		struct EventField<bool>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Bool; }
+			static void Write(EventRecordWriter& writer, bool value) { writer.Put(static_cast<uint8_t>(value ? 1 : 0)); }
+		};
+
+		template<>
+		struct EventField<int32_t>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Int32; }
+			static void Write(EventRecordWriter& writer, int32_t value) { writer.Put(value); }
+		};
+
+		template<>
+		struct EventField<uint32_t>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::UInt32; }
+			static void Write(EventRecordWriter& writer, uint32_t value) { writer.Put(value); }
+		};
+
+		template<>
+		struct EventField<int64_t>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Int64; }
+			static void Write(EventRecordWriter& writer, int64_t value) { writer.Put(value); }
+		};
+
+		template<>
+		struct EventField<uint64_t>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::UInt64; }
+			static void Write(EventRecordWriter& writer, uint64_t value) { writer.Put(value); }
+		};
+
+		template<>
+		struct EventField<float>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Float; }
+			static void Write(EventRecordWriter& writer, float value) { writer.Put(value); }
+		};
+
+		template<>
+		struct EventField<double>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Double; }
+			static void Write(EventRecordWriter& writer, double value) { writer.Put(value); }
+		};
+
+		//Units are stored by handle, like in the text log
+		template<>
+		struct EventField<Unit>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Unit; }
+			static void Write(EventRecordWriter& writer, const Unit& unit) { writer.Put(static_cast<uint32_t>(unit.id)); }
+		};
+
+		template<>
+		struct EventField<Optional<Unit>>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Unit; }
+
+			static void Write(EventRecordWriter& writer, const Optional<Unit>& unit)
+			{
+				writer.Put(static_cast<uint32_t>(unit.hasValue() ? unit.value().id : 0));
+			}
+		};
+
+		template<>
+		struct EventField<UnitTypeId>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::UnitType; }
+			static void Write(EventRecordWriter& writer, UnitTypeId type) { writer.Put(static_cast<uint16_t>(type)); }
+		};
+
+		template<>
+		struct EventField<Point>
+		{
+			static constexpr EventFieldType GetType() { return EventFieldType::Point; }
+			static void Write(EventRecordWriter& writer, const Point& point) { writer.Put(point.X); writer.Put(point.Y); }
+		};
+
+		template<class ... FieldsT>
+		constexpr uint32_t GetEventFieldsSize()
+		{
+			const uint32_t sizes[] = { 0, GetEventFieldSize(EventField<FieldsT>::GetType())... };
+			uint32_t size = 0;
+			for (const uint32_t fieldSize : sizes)
+			{
+				size += fieldSize;
+			}
+			return size;
+		}
+	}
+	#pragma endregion
+
+	/// <summary>
+	/// Writes events as compact binary records to a file, for logging every unit event in production where text
+	/// logs are too big and too slow. A record is the id of its format followed by the raw fields; the formats, the
+	/// time and the unit type names are written once, so the file decodes without the bot, see EventLogDecoder.
+	/// Writing an event only appends to a block in memory; full blocks are written to the file by a background thread.
+	/// The queue of full blocks is bounded: blocks arriving while it is full are dropped and counted, and the decoder
+	/// reports the gap instead of the log growing memory.
+	/// Not thread safe: write from one thread, usually the game thread, or use one log per thread.
+	/// </summary>
+	class EventLog
+	{
+	public:
+		/// <summary>
+		/// Opens the file and starts the writer thread.
+		/// </summary>
+		/// <param name="path">Path of the log file, overwritten</param>
+		/// <param name="blockSize">Bytes of events collected before they are handed to the writer thread</param>
+		/// <param name="maxQueuedBlocks">Most blocks waiting to be written</param>
+		explicit EventLog(const std::string& path, size_t blockSize = 1 << 20, size_t maxQueuedBlocks = 16)
+			: File(path, std::ios::out | std::ios::trunc | std::ios::binary)
+			, Out(File)
+			, BlockSize(std::max<size_t>(blockSize, 4096))
+			, MaxQueuedBlocks(std::max<size_t>(maxQueuedBlocks, 1))
+			, Block(BlockSize)
+			, Stream(&Block, 4096)
+		{
+			Start();
+		}
+
+		/// <summary>
+		/// Writes to a stream instead of a file, e.g. a socket stream. The stream must outlive the log and is only
+		/// written by the writer thread after the file header.
+		/// </summary>
+		explicit EventLog(std::ostream& out, size_t blockSize = 1 << 20, size_t maxQueuedBlocks = 16)
+			: Out(out)
+			, BlockSize(std::max<size_t>(blockSize, 4096))
+			, MaxQueuedBlocks(std::max<size_t>(maxQueuedBlocks, 1))
+			, Block(BlockSize)
+			, Stream(&Block, 4096)
+		{
+			Start();
+		}
+
+		/// <summary>
+		/// Writes what is buffered and closes the file.
+		/// </summary>
+		~EventLog()
+		{
+			Flush();
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Stopping = true;
+			}
+			QueueChanged.notify_one();
+			Writer.join();
+		}
+
+		bool IsOpen() const
+		{
+			return !Out.fail();
+		}
+
+		/// <summary>
+		/// Writes an event. The values are converted to the field types of the format.
+		/// </summary>
+		template<class ... FieldsT>
+		void Write(const EventFormat<FieldsT...>& format, const std::common_type_t<FieldsT>& ... values)
+		{
+			std::array<uint8_t, sizeof(uint16_t) + Internal::GetEventFieldsSize<FieldsT...>()> record;
+			Internal::EventRecordWriter writer{ record.data() };
+			writer.Put(format.Id);
+			(void)std::initializer_list<int>{ (Internal::EventField<FieldsT>::Write(writer, values), 0)... };
+			//Checked after reserving: starting a new block may drop the block holding the definition
+			Reserve(record.size());
+			if ((Defined[format.Id >> 6] & (uint64_t(1) << (format.Id & 63))) == 0)
+			{
+				const EventFieldType types[] = { EventFieldType::Count, Internal::EventField<FieldsT>::GetType()... };
+				if (!Define(format.Id, format.Name, format.Text, types + 1, format.FieldNames, sizeof...(FieldsT), record.size()))
+				{
+					return;
+				}
+			}
+			Stream << record;
+		}
+
+		/// <summary>
+		/// Sets the game time of the events written after it, e.g. from a SignalTimer.
+		/// </summary>
+		void MarkTime(double gameSeconds)
+		{
+			Time = gameSeconds;
+			Reserve(sizeof(uint16_t) + sizeof(double));
+			Stream << static_cast<uint16_t>(EventRecordId::Time) << gameSeconds;
+		}
+
+		/// <summary>
+		/// Hands the buffered events to the writer thread, e.g. at the end of the match.
+		/// Unlike filling a block, waits for room in the queue instead of dropping the events.
+		/// </summary>
+		void Flush()
+		{
+			if (Stream.wpos() != 0)
+			{
+				Submit(true);
+			}
+		}
+
+		/// <summary>
+		/// Number of blocks dropped because the queue was full.
+		/// </summary>
+		uint64_t GetDroppedBlocks() const
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			return DroppedBlocks;
+		}
+
+		EventLog(const EventLog&) = delete;
+		EventLog& operator=(const EventLog&) = delete;
+
+		#pragma region Implementations
+	private:
+		std::ofstream File;
+		std::ostream& Out;
+		size_t BlockSize;
+		size_t MaxQueuedBlocks;
+
+		//Owned by the writing thread; Stream writes into Block, which is swapped, never reallocated, between blocks
+		zycore::OBinaryStream::Buffer Block;
+		zycore::OBinaryStream Stream;
+		uint64_t Defined[1 << 10] = {};
+		double Time = 0.0;
+		uint32_t DroppedSinceGap = 0;
+
+		mutable std::mutex Mutex;
+		std::condition_variable QueueChanged;
+		std::condition_variable QueueDrained;
+		std::deque<zycore::OBinaryStream::Buffer> Queue;
+		std::vector<zycore::OBinaryStream::Buffer> Spare;
+		uint64_t DroppedBlocks = 0;
+		bool Stopping = false;
+		std::thread Writer;
+
+		static uint16_t GetStringLength(const char* text)
+		{
+			return static_cast<uint16_t>(std::min<size_t>(text != nullptr ? std::strlen(text) : 0, 0xFFFF));
+		}
+
+		static void WriteString(zycore::OBinaryStream& stream, const char* text)
+		{
+			const uint16_t length = GetStringLength(text);
+			stream << length;
+			stream.rawWrite(stream.wpos(), length, reinterpret_cast<const uint8_t*>(text));
+			stream.wpos(stream.wpos() + length);
+		}
+
+		void Start()
+		{
+			zycore::OBinaryStream::Buffer header;
+			zycore::OBinaryStream out(&header);
+			out << static_cast<uint32_t>(EventLogMagic) << static_cast<uint16_t>(EventLogVersion)
+				<< static_cast<uint16_t>(UnitTypeId::Count);
+			for (size_t i = 0; i < static_cast<size_t>(UnitTypeId::Count); ++i)
+			{
+				WriteString(out, GetUnitStats(static_cast<UnitTypeId>(i)).Name);
+			}
+			Out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(out.wpos()));
+			Writer = std::thread(&EventLog::Run, this);
+		}
+
+		//Reserves the definition together with the record that follows it, so a dropped block cannot separate them
+		bool Define(uint16_t id, const char* name, const char* text, const EventFieldType* types, const char* const* fieldNames, size_t count, size_t recordSize)
+		{
+			SC2API_ASSERT(id >= static_cast<uint16_t>(EventRecordId::FirstEventFormatId));
+			if (id < static_cast<uint16_t>(EventRecordId::FirstEventFormatId))
+			{
+				return false;
+			}
+			size_t size = sizeof(uint16_t) * 4 + GetStringLength(name) + GetStringLength(text) + sizeof(uint8_t);
+			for (size_t i = 0; i < count; ++i)
+			{
+				size += sizeof(uint8_t) + sizeof(uint16_t) + GetStringLength(fieldNames[i]);
+			}
+			Reserve(size + recordSize);
+			Stream << static_cast<uint16_t>(EventRecordId::Format) << id;
+			WriteString(Stream, name);
+			WriteString(Stream, text);
+			Stream << static_cast<uint8_t>(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				Stream << static_cast<uint8_t>(types[i]);
+				WriteString(Stream, fieldNames[i]);
+			}
+			Defined[id >> 6] |= uint64_t(1) << (id & 63);
+			return true;
+		}
+
+		//Starts a new block unless the record fits; records larger than a block grow it
+		void Reserve(size_t size)
+		{
+			if (Stream.wpos() + size > BlockSize && Stream.wpos() != 0)
+			{
+				Submit(false);
+			}
+		}
+
+		void Submit(bool wait)
+		{
+			Block.resize(Stream.wpos());
+			bool dropped = false;
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+				if (wait)
+				{
+					QueueDrained.wait(lock, [this]() { return Queue.size() < MaxQueuedBlocks; });
+				}
+				if (Queue.size() >= MaxQueuedBlocks)
+				{
+					++DroppedBlocks;
+					dropped = true;
+				}
+				else
+				{
+					DroppedSinceGap = 0;
+					Queue.push_back(std::move(Block));
+					Block.clear();
+					if (!Spare.empty())
+					{
+						Block.swap(Spare.back());
+						Spare.pop_back();
+					}
+					QueueChanged.notify_one();
+				}
+			}
+			//Growing to the full block up front keeps OBinaryStream from resizing on every write
+			Block.resize(BlockSize);
+			Stream.wpos(0);
+			if (dropped)
+			{
+				//The dropped block may have held format definitions the following events rely on, and the gaps of
+				//blocks dropped before it, so the count covers all blocks dropped since the last one written
+				std::fill(std::begin(Defined), std::end(Defined), 0);
+				Stream << static_cast<uint16_t>(EventRecordId::Gap) << ++DroppedSinceGap;
+				Stream << static_cast<uint16_t>(EventRecordId::Time) << Time;
+			}
+		}
+
+		void Run()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			for (;;)
+			{
+				QueueChanged.wait(lock, [this]() { return Stopping || !Queue.empty(); });
+				if (Queue.empty())
+				{
+					break;
+				}
+				zycore::OBinaryStream::Buffer block = std::move(Queue.front());
+				Queue.pop_front();
+				QueueDrained.notify_one();
+				lock.unlock();
+				Out.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+				lock.lock();
+				if (Spare.size() < MaxQueuedBlocks)
+				{
+					Spare.push_back(std::move(block));
+				}
+			}
+			Out.flush();
+		}
+		#pragma endregion
+	};
+
+	/// <summary>
+	/// Formats of the unit events written by UnitEventRecorder.
+	/// </summary>
+	namespace UnitEvents
+	{
+		constexpr EventFormat<Unit, UnitTypeId, int32_t, Point> Created{ 16, "UnitCreated", "{} ({}) created for player {} at {}", { "unit", "type", "player", "position" } };
+		constexpr EventFormat<Unit, Optional<Unit>> Destroyed{ 17, "UnitDestroyed", "{} destroyed by {}", { "unit", "killer" } };
+		constexpr EventFormat<Unit, UnitTypeId, Point> EnterVision{ 18, "UnitEnterVision", "{} ({}) enters vision at {}", { "unit", "type", "position" } };
+		constexpr EventFormat<Unit> LeaveVision{ 19, "UnitLeaveVision", "{} leaves vision", { "unit" } };
+	}
+
+	/// <summary>
+	/// Writes the unit signals to an event log, the structured counterpart of logging them as text.
+	/// The time of the events is counted in game seconds since the recorder was created, in steps of the clock interval.
+	/// </summary>
+	class UnitEventRecorder : public SignalObject
+	{
+	public:
+		/// <param name="log">Log to write to; must outlive the recorder</param>
+		/// <param name="clockInterval">Game seconds between time marks</param>
+		explicit UnitEventRecorder(EventLog& log, double clockInterval = 0.125)
+			: Log(log)
+			, ClockInterval(clockInterval)
+		{
+			Log.MarkTime(0.0);
+			Unit::SignalUnitCreated().connect(this, &UnitEventRecorder::OnUnitCreated);
+			Unit::SignalUnitDestroyed().connect(this, &UnitEventRecorder::OnUnitDestroyed);
+			Unit::SignalUnitEnterVision().connect(this, &UnitEventRecorder::OnUnitEnterVision);
+			Unit::SignalUnitLeaveVision().connect(this, &UnitEventRecorder::OnUnitLeaveVision);
+			SignalTimer(ClockInterval, true).connect(this, &UnitEventRecorder::OnTimer);
+		}
+
+		#pragma region Implementations
+	private:
+		EventLog& Log;
+		double ClockInterval;
+		double Time = 0.0;
+
+		void OnUnitCreated(Unit unit, int player)
+		{
+			Log.Write(UnitEvents::Created, unit, GetType(unit), player, GetPosition(unit));
+		}
+
+		void OnUnitDestroyed(Unit unit, Optional<Unit> killer)
+		{
+			Log.Write(UnitEvents::Destroyed, unit, killer);
+		}
+
+		void OnUnitEnterVision(Unit unit)
+		{
+			Log.Write(UnitEvents::EnterVision, unit, GetType(unit), GetPosition(unit));
+		}
+
+		void OnUnitLeaveVision(Unit unit)
+		{
+			Log.Write(UnitEvents::LeaveVision, unit);
+		}
+
+		static UnitTypeId GetType(const Unit& unit)
+		{
+			const Optional<UnitTypeId> type = GetUnitTypeId(unit);
+			return type.hasValue() ? type.value() : UnitTypeId::Invalid;
+		}
+
+		static Point GetPosition(const Unit& unit)
+		{
+			const Optional<Point> position = unit.GetPosition();
+			return position.hasValue() ? position.value() : Point{ 0.0, 0.0 };
+		}
+
+		void OnTimer()
+		{
+			Time += ClockInterval;
+			Log.MarkTime(Time);
+		}
+		#pragma endregion
+	};
+}
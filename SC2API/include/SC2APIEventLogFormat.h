@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+
+//Layout of the files written by SC2API::EventLog, shared with the offline decoder which does not include the API.
+//All values are stored raw in the byte order of the writer (little endian on all supported platforms).
+//
+//File:       uint32 EventLogMagic, uint16 EventLogVersion, uint16 unit type count, unit type names
+//Record:     uint16 id, then the body of the record
+//Format:     uint16 id, string name, string text, uint8 field count, per field: uint8 EventFieldType, string name
+//Time:       double game seconds of the records that follow
+//Gap:        uint32 blocks dropped since the previous gap; formats are defined again after it
+//Event:      the fields in the order of their format, see EventFieldType for their size
+//String:     uint16 length, then the characters without terminator
+
+namespace SC2API
+{
+	enum : uint32_t
+	{
+		//"SC2E"
+		EventLogMagic = 0x45324353,
+		EventLogVersion = 1,
+	};
+
+	/// <summary>
+	/// Ids of the records the log writes itself. Ids of event formats start at FirstEventFormatId.
+	/// </summary>
+	enum class EventRecordId : uint16_t
+	{
+		Format,
+		Time,
+		Gap,
+
+		FirstEventFormatId = 16,
+	};
+
+	/// <summary>
+	/// Types of event fields and how they are stored.
+	/// </summary>
+	enum class EventFieldType : uint8_t
+	{
+		//uint8, 0 or 1
+		Bool,
+		Int32,
+		UInt32,
+		Int64,
+		UInt64,
+		Float,
+		Double,
+
+		//HandleId as uint32, 0 for no unit
+		Unit,
+
+		//UnitTypeId as uint16, index into the unit type names of the file
+		UnitType,
+
+		//X and Y as doubles
+		Point,
+
+		Count,
+	};
+
+	/// <summary>
+	/// Size of a stored field in bytes.
+	/// </summary>
+	constexpr uint32_t GetEventFieldSize(EventFieldType type)
+	{
+		return type == EventFieldType::Bool ? 1
+			: type == EventFieldType::UnitType ? 2
+			: type == EventFieldType::Int32 || type == EventFieldType::UInt32 || type == EventFieldType::Float || type == EventFieldType::Unit ? 4
+			: type == EventFieldType::Point ? 16
+			: 8;
+	}
+}
@@ -0,0 +1,598 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIPoint.h"
+#include "SC2APIPathing.h"
+#include "SC2APIWorkerPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Movement layers a flow field can be generated for.
+	/// </summary>
+	enum class PathingLayer
+	{
+		/// <summary>
+		/// Walkable cells of the pathing grid.
+		/// </summary>
+		Ground = 0,
+
+		/// <summary>
+		/// Every cell of the map.
+		/// </summary>
+		Air = 1,
+	};
+
+	/// <summary>
+	/// Flow field towards a single goal: an integration field holding the walking cost of each cell to the goal,
+	/// and a direction field holding the neighbour to step to from each cell.
+	/// Built once per goal, after which any number of units steer by sampling it in constant time,
+	/// so the cost of moving a group depends on the map size rather than the group size.
+	/// </summary>
+	class FlowField
+	{
+	public:
+		/// <summary>
+		/// Direction value of cells without a next step: the goal itself and unreachable or blocked cells.
+		/// </summary>
+		enum : uint8_t { NoDirection = 8 };
+
+		FlowField()
+			: Width(0), Height(0), GoalCell(-1)
+		{}
+
+		/// <summary>
+		/// Builds the field, starting threads for this build only. Build with a WorkerPool to build fields repeatedly.
+		/// </summary>
+		/// <param name="grid">Walkable cells</param>
+		/// <param name="goal">The point to flow to</param>
+		/// <param name="threads">Threads building the field, 0 for one per core</param>
+		/// <returns>False if the goal is blocked, the field is empty then</returns>
+		bool Build(const PathingGrid& grid, const Point& goal, unsigned threads = 0)
+		{
+			WorkerPool pool(threads);
+			return Build(grid, goal, pool);
+		}
+
+		/// <summary>
+		/// Builds the field on the threads of a pool. With four threads or more the integration field is built in tiles,
+		/// which settle in parallel and exchange costs across their borders until none improves; the costs are the
+		/// same as with one thread.
+		/// </summary>
+		/// <param name="grid">Walkable cells</param>
+		/// <param name="goal">The point to flow to</param>
+		/// <param name="pool">Threads building the field</param>
+		/// <returns>False if the goal is blocked, the field is empty then</returns>
+		bool Build(const PathingGrid& grid, const Point& goal, WorkerPool& pool)
+		{
+			Width = grid.GetWidth();
+			Height = grid.GetHeight();
+			const int goalX = static_cast<int>(std::floor(goal.X));
+			const int goalY = static_cast<int>(std::floor(goal.Y));
+			const size_t cellCount = static_cast<size_t>(Width) * Height;
+			Cost.assign(cellCount, Unreachable);
+			Directions.assign(cellCount, NoDirection);
+			if (!grid.IsWalkable(goalX, goalY))
+			{
+				GoalCell = -1;
+				return false;
+			}
+			GoalCell = goalY * Width + goalX;
+			Integrate(grid, pool);
+			BuildDirections(grid, pool);
+			return true;
+		}
+
+		/// <summary>
+		/// Determines whether the field has been built for a reachable goal.
+		/// </summary>
+		bool IsValid() const
+		{
+			return GoalCell >= 0;
+		}
+
+		/// <summary>
+		/// Gets the goal cell center.
+		/// </summary>
+		Point GetGoal() const
+		{
+			return CellCenter(GoalCell);
+		}
+
+		/// <summary>
+		/// Gets the walking distance from a point to the goal, in map units with diagonal steps counted as 1.4.
+		/// </summary>
+		/// <returns>The distance, or empty value if the point is blocked or cannot reach the goal</returns>
+		Optional<double> GetDistance(const Point& point) const
+		{
+			const int cell = ToCell(point);
+			if (cell < 0 || Cost[cell] == Unreachable)
+			{
+				return{};
+			}
+			return Cost[cell] / static_cast<double>(OrthogonalCost);
+		}
+
+		/// <summary>
+		/// Gets the unit direction to move in from a point.
+		/// </summary>
+		/// <returns>The direction, or empty value at the goal and where the goal cannot be reached</returns>
+		Optional<Point> GetDirection(const Point& point) const
+		{
+			const int cell = ToCell(point);
+			if (cell < 0 || Directions[cell] == NoDirection)
+			{
+				return{};
+			}
+			const uint8_t direction = Directions[cell];
+			const double scale = direction >= 4 ? 0.70710678 : 1.0;
+			return Point{ StepX(direction) * scale, StepY(direction) * scale };
+		}
+
+		/// <summary>
+		/// Follows the field for a number of cells from a point. Use as the target of a move order when steering a group;
+		/// a few cells of look-ahead keeps orders sparse while still bending around obstacles.
+		/// </summary>
+		/// <param name="point">The point to start from</param>
+		/// <param name="steps">Number of cells to follow</param>
+		/// <returns>Center of the cell reached, or empty value where the goal cannot be reached</returns>
+		Optional<Point> GetWaypoint(const Point& point, int steps = 4) const
+		{
+			int cell = ToCell(point);
+			if (cell < 0 || Cost[cell] == Unreachable)
+			{
+				return{};
+			}
+			for (int i = 0; i < steps && Directions[cell] != NoDirection; ++i)
+			{
+				cell += StepY(Directions[cell]) * Width + StepX(Directions[cell]);
+			}
+			return CellCenter(cell);
+		}
+
+		/// <summary>
+		/// Raw integration field, row-major, see OrthogonalCost.
+		/// </summary>
+		const uint32_t* GetCosts() const
+		{
+			return Cost.data();
+		}
+
+		/// <summary>
+		/// Raw direction field, row-major, index into the step tables or NoDirection.
+		/// </summary>
+		const uint8_t* GetDirections() const
+		{
+			return Directions.data();
+		}
+
+		/// <summary>
+		/// Integration costs of a straight and a diagonal step, and the cost of unreachable cells.
+		/// </summary>
+		enum : uint32_t { OrthogonalCost = 10, DiagonalCost = 14, Unreachable = 0xFFFFFFFF };
+
+		#pragma region Implementations
+	private:
+		//Straight steps first, diagonal steps from index 4
+		static int StepX(int direction)
+		{
+			static const int steps[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+			return steps[direction];
+		}
+
+		static int StepY(int direction)
+		{
+			static const int steps[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+			return steps[direction];
+		}
+
+		int Width;
+		int Height;
+		int GoalCell;
+		std::vector<uint32_t> Cost;
+		std::vector<uint8_t> Directions;
+
+		int ToCell(const Point& point) const
+		{
+			const int x = static_cast<int>(std::floor(point.X));
+			const int y = static_cast<int>(std::floor(point.Y));
+			if (GoalCell < 0 || x < 0 || y < 0 || x >= Width || y >= Height)
+			{
+				return -1;
+			}
+			return y * Width + x;
+		}
+
+		Point CellCenter(int cell) const
+		{
+			return{ cell % Width + 0.5, cell / Width + 0.5 };
+		}
+
+		static bool CanStep(const PathingGrid& grid, int x, int y, int direction)
+		{
+			const int nx = x + StepX(direction);
+			const int ny = y + StepY(direction);
+			if (!grid.IsWalkable(nx, ny))
+			{
+				return false;
+			}
+			//No corner cutting, same as PathPlanner
+			return direction < 4 || (grid.IsWalkable(nx, y) && grid.IsWalkable(x, ny));
+		}
+
+		enum : int
+		{
+			//Side of the square tiles the integration field is built in with several threads
+			TileSize = 32,
+
+			//Tiles are settled while their cheapest seed is within this much of the cheapest of all tiles
+			SeedWindow = TileSize * OrthogonalCost,
+
+			//Settling tiles and exchanging their borders takes about 1.7 times the work of a single sweep, which
+			//only pays off from this many threads
+			MinTiledThreads = 4,
+		};
+
+		struct IntegrationTile
+		{
+			int X0, Y0, X1, Y1;
+
+			//Costs offered to cells of the tile, cost first so they sort by it
+			std::vector<std::pair<uint32_t, int>> Seeds;
+
+			std::vector<int> Buckets[DiagonalCost + 1];
+
+			//Whether the last Settle lowered any cost
+			bool Changed = false;
+		};
+
+		static bool IsInside(const IntegrationTile& tile, int x, int y)
+		{
+			return x >= tile.X0 && x < tile.X1 && y >= tile.Y0 && y < tile.Y1;
+		}
+
+		//Dial's algorithm: with integer step costs of at most DiagonalCost, DiagonalCost + 1 circular buckets
+		//replace the priority queue and every cell is settled in constant time.
+		//Only reads and writes cells of the tile; seeds join the buckets as the sweep reaches their cost.
+		void Settle(const PathingGrid& grid, IntegrationTile& tile)
+		{
+			const uint32_t bucketCount = DiagonalCost + 1;
+			//The grid bounds are checked by CanStep
+			const bool whole = tile.X0 == 0 && tile.Y0 == 0 && tile.X1 == Width && tile.Y1 == Height;
+			std::sort(tile.Seeds.begin(), tile.Seeds.end());
+			tile.Changed = false;
+			size_t nextSeed = 0;
+			size_t pending = 0;
+			for (uint32_t current = 0; pending > 0 || nextSeed < tile.Seeds.size(); ++current)
+			{
+				if (pending == 0)
+				{
+					current = std::max(current, tile.Seeds[nextSeed].first);
+				}
+				for (; nextSeed < tile.Seeds.size() && tile.Seeds[nextSeed].first == current; ++nextSeed)
+				{
+					const int cell = tile.Seeds[nextSeed].second;
+					if (current < Cost[cell])
+					{
+						Cost[cell] = current;
+						tile.Buckets[current % bucketCount].push_back(cell);
+						++pending;
+						tile.Changed = true;
+					}
+				}
+				std::vector<int>& bucket = tile.Buckets[current % bucketCount];
+				while (!bucket.empty())
+				{
+					const int cell = bucket.back();
+					bucket.pop_back();
+					--pending;
+					if (Cost[cell] != current)
+					{
+						continue;
+					}
+					const int x = cell % Width;
+					const int y = cell / Width;
+					for (int direction = 0; direction < 8; ++direction)
+					{
+						if ((!whole && !IsInside(tile, x + StepX(direction), y + StepY(direction))) || !CanStep(grid, x, y, direction))
+						{
+							continue;
+						}
+						const int next = cell + StepY(direction) * Width + StepX(direction);
+						const uint32_t cost = current + (direction < 4 ? OrthogonalCost : DiagonalCost);
+						if (cost < Cost[next])
+						{
+							Cost[next] = cost;
+							tile.Buckets[cost % bucketCount].push_back(next);
+							++pending;
+						}
+					}
+				}
+			}
+			tile.Seeds.clear();
+		}
+
+		//Offers the border cells of the tile the costs of their neighbours in other tiles. Only reads costs.
+		void GatherSeeds(const PathingGrid& grid, IntegrationTile& tile) const
+		{
+			for (int y = tile.Y0; y < tile.Y1; ++y)
+			{
+				//Every cell of the first and last row, the first and last cell of the others
+				const int step = y == tile.Y0 || y == tile.Y1 - 1 ? 1 : std::max(tile.X1 - 1 - tile.X0, 1);
+				for (int x = tile.X0; x < tile.X1; x += step)
+				{
+					if (!grid.IsWalkable(x, y))
+					{
+						continue;
+					}
+					const int cell = y * Width + x;
+					for (int direction = 0; direction < 8; ++direction)
+					{
+						//Steps between walkable cells are symmetric, so the step into the tile is allowed when the step out is
+						const int nx = x + StepX(direction);
+						const int ny = y + StepY(direction);
+						if (IsInside(tile, nx, ny) || !CanStep(grid, x, y, direction))
+						{
+							continue;
+						}
+						const uint32_t neighbour = Cost[ny * Width + nx];
+						if (neighbour == Unreachable)
+						{
+							continue;
+						}
+						const uint32_t cost = neighbour + (direction < 4 ? OrthogonalCost : DiagonalCost);
+						if (cost < Cost[cell])
+						{
+							tile.Seeds.emplace_back(cost, cell);
+						}
+					}
+				}
+			}
+		}
+
+		void Integrate(const PathingGrid& grid, WorkerPool& pool)
+		{
+			if (pool.GetThreadCount() < MinTiledThreads || (Width <= TileSize && Height <= TileSize))
+			{
+				IntegrationTile whole;
+				whole.X0 = whole.Y0 = 0;
+				whole.X1 = Width;
+				whole.Y1 = Height;
+				whole.Seeds.emplace_back(0, GoalCell);
+				Settle(grid, whole);
+				return;
+			}
+
+			//Rounds of settling the tiles that got seeds, then gathering seeds for the neighbours of changed tiles.
+			//Each phase writes only to its own tile, so the tiles of a phase run in parallel; every round moves the
+			//costs across at least one border, and the costs stop changing once they are the shortest distances.
+			const int columns = (Width + TileSize - 1) / TileSize;
+			const int rows = (Height + TileSize - 1) / TileSize;
+			std::vector<IntegrationTile> tiles(static_cast<size_t>(columns) * rows);
+			for (int row = 0; row < rows; ++row)
+			{
+				for (int column = 0; column < columns; ++column)
+				{
+					IntegrationTile& tile = tiles[row * columns + column];
+					tile.X0 = column * TileSize;
+					tile.Y0 = row * TileSize;
+					tile.X1 = std::min(tile.X0 + TileSize, Width);
+					tile.Y1 = std::min(tile.Y0 + TileSize, Height);
+				}
+			}
+			const int goalTile = (GoalCell / Width / TileSize) * columns + GoalCell % Width / TileSize;
+			tiles[goalTile].Seeds.emplace_back(0, GoalCell);
+
+			std::vector<int> active = { goalTile };
+			std::vector<int> candidates;
+			std::vector<bool> isCandidate(tiles.size());
+			while (!active.empty())
+			{
+				pool.ParallelFor(active.size(), [this, &grid, &tiles, &active](size_t i)
+				{
+					Settle(grid, tiles[active[i]]);
+				});
+
+				candidates.clear();
+				std::fill(isCandidate.begin(), isCandidate.end(), false);
+				for (const int index : active)
+				{
+					if (!tiles[index].Changed)
+					{
+						continue;
+					}
+					const int row = index / columns;
+					const int column = index % columns;
+					for (int neighbourRow = std::max(row - 1, 0); neighbourRow <= std::min(row + 1, rows - 1); ++neighbourRow)
+					{
+						for (int neighbourColumn = std::max(column - 1, 0); neighbourColumn <= std::min(column + 1, columns - 1); ++neighbourColumn)
+						{
+							const int neighbour = neighbourRow * columns + neighbourColumn;
+							if (neighbour != index && !isCandidate[neighbour])
+							{
+								isCandidate[neighbour] = true;
+								candidates.push_back(neighbour);
+							}
+						}
+					}
+				}
+				//Sorted so the rounds do not depend on the order tiles were settled in
+				std::sort(candidates.begin(), candidates.end());
+				pool.ParallelFor(candidates.size(), [this, &grid, &tiles, &candidates](size_t i)
+				{
+					GatherSeeds(grid, tiles[candidates[i]]);
+				});
+
+				//Tiles whose cheapest seed is far above the others wait, as their borders likely improve before the
+				//wave reaches them and settling them now would be redone
+				uint32_t lowest = Unreachable;
+				for (const IntegrationTile& tile : tiles)
+				{
+					if (!tile.Seeds.empty())
+					{
+						lowest = std::min(lowest, std::min_element(tile.Seeds.begin(), tile.Seeds.end())->first);
+					}
+				}
+				active.clear();
+				for (size_t index = 0; index < tiles.size(); ++index)
+				{
+					const std::vector<std::pair<uint32_t, int>>& seeds = tiles[index].Seeds;
+					if (!seeds.empty() && std::min_element(seeds.begin(), seeds.end())->first <= lowest + SeedWindow)
+					{
+						active.push_back(static_cast<int>(index));
+					}
+				}
+			}
+		}
+
+		void BuildDirectionRows(const PathingGrid& grid, int rowBegin, int rowEnd)
+		{
+			for (int y = rowBegin; y < rowEnd; ++y)
+			{
+				for (int x = 0; x < Width; ++x)
+				{
+					const int cell = y * Width + x;
+					uint32_t best = Cost[cell];
+					if (best == Unreachable)
+					{
+						continue;
+					}
+					for (int direction = 0; direction < 8; ++direction)
+					{
+						if (!CanStep(grid, x, y, direction))
+						{
+							continue;
+						}
+						const uint32_t cost = Cost[cell + StepY(direction) * Width + StepX(direction)];
+						if (cost < best)
+						{
+							best = cost;
+							Directions[cell] = static_cast<uint8_t>(direction);
+						}
+					}
+				}
+			}
+		}
+
+		//Each cell only reads the integration field, so bands of rows are independent
+		void BuildDirections(const PathingGrid& grid, WorkerPool& pool)
+		{
+			const int bandCount = (Height + TileSize - 1) / TileSize;
+			pool.ParallelFor(static_cast<size_t>(bandCount), [this, &grid](size_t band)
+			{
+				const int rowBegin = static_cast<int>(band) * TileSize;
+				BuildDirectionRows(grid, rowBegin, std::min(rowBegin + TileSize, Height));
+			});
+		}
+		#pragma endregion
+	};
+
+	/// <summary>
+	/// Cache of flow fields per (goal cell, layer) on top of a path planner.
+	/// Ground fields are rebuilt when the planner's grid changed since they were built; air fields never go stale.
+	/// The least recently used field is dropped when the cache is full.
+	/// </summary>
+	class FlowFieldCache
+	{
+	public:
+		/// <summary>
+		/// Creates a cache.
+		/// </summary>
+		/// <param name="planner">Planner providing the ground pathing grid</param>
+		/// <param name="capacity">Maximum number of fields kept</param>
+		/// <param name="threads">Threads used to build a field, 0 for one per core; they are kept by the cache</param>
+		explicit FlowFieldCache(const PathPlanner& planner, size_t capacity = 16, unsigned threads = 0)
+			: Planner(planner)
+			, Capacity(std::max<size_t>(capacity, 1))
+			, Pool(threads)
+			, AirGrid(planner.GetGrid().GetWidth(), planner.GetGrid().GetHeight(), true)
+		{
+			Entries.reserve(Capacity);
+		}
+
+		/// <summary>
+		/// Gets the field towards a goal, building it if it is not cached or stale.
+		/// The reference stays valid until the next call to GetField or Clear.
+		/// </summary>
+		/// <returns>The field, or nullptr if the goal is blocked on that layer</returns>
+		const FlowField* GetField(const Point& goal, PathingLayer layer = PathingLayer::Ground)
+		{
+			const PathingGrid& grid = layer == PathingLayer::Ground ? Planner.GetGrid() : AirGrid;
+			const int goalX = static_cast<int>(std::floor(goal.X));
+			const int goalY = static_cast<int>(std::floor(goal.Y));
+			if (!grid.IsWalkable(goalX, goalY))
+			{
+				return nullptr;
+			}
+			const int goalCell = goalY * grid.GetWidth() + goalX;
+			const uint32_t version = layer == PathingLayer::Ground ? Planner.GetGridVersion() : 0;
+			++Clock;
+
+			Entry* slot = nullptr;
+			for (Entry& entry : Entries)
+			{
+				if (entry.GoalCell == goalCell && entry.Layer == layer)
+				{
+					slot = &entry;
+					break;
+				}
+			}
+			if (slot != nullptr && slot->GridVersion == version)
+			{
+				slot->LastUsed = Clock;
+				return &slot->Field;
+			}
+			if (slot == nullptr)
+			{
+				if (Entries.size() < Capacity)
+				{
+					Entries.emplace_back();
+					slot = &Entries.back();
+				}
+				else
+				{
+					slot = &*std::min_element(Entries.begin(), Entries.end(),
+						[](const Entry& a, const Entry& b) { return a.LastUsed < b.LastUsed; });
+				}
+			}
+
+			slot->GoalCell = goalCell;
+			slot->Layer = layer;
+			slot->GridVersion = version;
+			slot->LastUsed = Clock;
+			slot->Field.Build(grid, goal, Pool);
+			return &slot->Field;
+		}
+
+		/// <summary>
+		/// Drops all cached fields.
+		/// </summary>
+		void Clear()
+		{
+			Entries.clear();
+		}
+
+		#pragma region Implementations
+	private:
+		struct Entry
+		{
+			int GoalCell = -1;
+			PathingLayer Layer = PathingLayer::Ground;
+			uint32_t GridVersion = 0;
+			uint64_t LastUsed = 0;
+			FlowField Field;
+		};
+
+		const PathPlanner& Planner;
+		size_t Capacity;
+		WorkerPool Pool;
+		PathingGrid AirGrid;
+		std::vector<Entry> Entries;
+		uint64_t Clock = 0;
+		#pragma endregion
+	};
+}
@@ -0,0 +1,229 @@
+#pragma once
+#include "HandleId.h"
+#include "Utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Compact map from unit handles to values, open-addressed with linear probing.
+	/// Keys and values live in two flat arrays, so lookups touch one or two cache lines instead of chasing tree or
+	/// bucket nodes. Handle 0 is not a valid unit and cannot be used as key.
+	/// References returned by Find and Insert are invalidated by the next Insert or Erase.
+	/// </summary>
+	template<typename T>
+	class HandleMap
+	{
+	public:
+		/// <summary>
+		/// Gets the value of a handle.
+		/// </summary>
+		/// <returns>Pointer to the value, or nullptr if the handle is not in the map</returns>
+		T* Find(HandleId id)
+		{
+			const size_t slot = FindSlot(id);
+			return slot != NotFound ? &Values[slot] : nullptr;
+		}
+
+		const T* Find(HandleId id) const
+		{
+			const size_t slot = FindSlot(id);
+			return slot != NotFound ? &Values[slot] : nullptr;
+		}
+
+		bool Contains(HandleId id) const
+		{
+			return FindSlot(id) != NotFound;
+		}
+
+		/// <summary>
+		/// Sets the value of a handle, replacing the previous one. Handle 0 is rejected and not stored.
+		/// </summary>
+		/// <returns>Reference to the stored value</returns>
+		T& Insert(HandleId id, T value)
+		{
+			SC2API_ASSERT(id != EmptyKey);
+			if (id == EmptyKey)
+			{
+				//Not in the map, the caller only sees its own value
+				static T rejected;
+				rejected = std::move(value);
+				return rejected;
+			}
+			//Grow at 3/4 load to keep probe sequences short
+			if ((Count + 1) * 4 > Keys.size() * 3)
+			{
+				Rehash(Keys.empty() ? 16 : Keys.size() * 2);
+			}
+			size_t slot = Home(id);
+			while (Keys[slot] != EmptyKey && Keys[slot] != id)
+			{
+				slot = (slot + 1) & (Keys.size() - 1);
+			}
+			if (Keys[slot] == EmptyKey)
+			{
+				Keys[slot] = id;
+				++Count;
+			}
+			Values[slot] = std::move(value);
+			return Values[slot];
+		}
+
+		/// <summary>
+		/// Removes a handle.
+		/// </summary>
+		/// <returns>True if the handle was in the map</returns>
+		bool Erase(HandleId id)
+		{
+			size_t hole = FindSlot(id);
+			if (hole == NotFound)
+			{
+				return false;
+			}
+			//Shift later entries of the probe sequence back instead of leaving tombstones
+			const size_t mask = Keys.size() - 1;
+			for (size_t slot = (hole + 1) & mask; Keys[slot] != EmptyKey; slot = (slot + 1) & mask)
+			{
+				const size_t home = Home(Keys[slot]);
+				if (((slot - home) & mask) >= ((slot - hole) & mask))
+				{
+					Keys[hole] = Keys[slot];
+					Values[hole] = std::move(Values[slot]);
+					hole = slot;
+				}
+			}
+			Keys[hole] = EmptyKey;
+			Values[hole] = T();
+			--Count;
+			return true;
+		}
+
+		/// <summary>
+		/// Removes all entries for which the predicate returns true.
+		/// Connect: bool Predicate(HandleId id, const T& value);
+		/// </summary>
+		template<typename PredicateT>
+		void EraseIf(PredicateT&& predicate)
+		{
+			std::vector<HandleId> erased;
+			ForEach([&](HandleId id, const T& value)
+			{
+				if (predicate(id, value))
+				{
+					erased.push_back(id);
+				}
+			});
+			for (const HandleId id : erased)
+			{
+				Erase(id);
+			}
+		}
+
+		/// <summary>
+		/// Calls a function for every entry, in no particular order.
+		/// Connect: void Func(HandleId id, const T& value);
+		/// </summary>
+		template<typename FuncT>
+		void ForEach(FuncT&& func) const
+		{
+			for (size_t slot = 0; slot < Keys.size(); ++slot)
+			{
+				if (Keys[slot] != EmptyKey)
+				{
+					func(Keys[slot], Values[slot]);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Calls a function for every entry, in no particular order. The function may modify values but not the map.
+		/// Connect: void Func(HandleId id, T& value);
+		/// </summary>
+		template<typename FuncT>
+		void ForEach(FuncT&& func)
+		{
+			for (size_t slot = 0; slot < Keys.size(); ++slot)
+			{
+				if (Keys[slot] != EmptyKey)
+				{
+					func(Keys[slot], Values[slot]);
+				}
+			}
+		}
+
+		size_t Size() const
+		{
+			return Count;
+		}
+
+		bool IsEmpty() const
+		{
+			return Count == 0;
+		}
+
+		void Clear()
+		{
+			Keys.clear();
+			Values.clear();
+			Count = 0;
+		}
+
+		#pragma region Implementations
+	private:
+		enum : HandleId
+		{
+			EmptyKey = 0,
+		};
+
+		enum : size_t
+		{
+			NotFound = ~static_cast<size_t>(0),
+		};
+
+		std::vector<HandleId> Keys;
+		std::vector<T> Values;
+		size_t Count = 0;
+
+		//Fibonacci hashing spreads sequential handles over the table
+		size_t Home(HandleId id) const
+		{
+			return static_cast<size_t>((static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ULL) >> 32) & (Keys.size() - 1);
+		}
+
+		size_t FindSlot(HandleId id) const
+		{
+			if (Keys.empty() || id == EmptyKey)
+			{
+				return NotFound;
+			}
+			for (size_t slot = Home(id); Keys[slot] != EmptyKey; slot = (slot + 1) & (Keys.size() - 1))
+			{
+				if (Keys[slot] == id)
+				{
+					return slot;
+				}
+			}
+			return NotFound;
+		}
+
+		void Rehash(size_t capacity)
+		{
+			std::vector<HandleId> keys(capacity, static_cast<HandleId>(EmptyKey));
+			std::vector<T> values(capacity);
+			keys.swap(Keys);
+			values.swap(Values);
+			Count = 0;
+			for (size_t slot = 0; slot < keys.size(); ++slot)
+			{
+				if (keys[slot] != EmptyKey)
+				{
+					Insert(keys[slot], std::move(values[slot]));
+				}
+			}
+		}
+		#pragma endregion
+	};
+}
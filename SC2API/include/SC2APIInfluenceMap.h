@@ -0,0 +1,306 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIPoint.h"
+#include "SC2APISimd.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Layers of an influence map. Ground holds the threat to ground units, Air the threat to air units.
+	/// </summary>
+	enum class InfluenceLayer
+	{
+		Ground = 0,
+		Air = 1,
+	};
+
+	/// <summary>
+	/// How much threat a unit projects and where.
+	/// </summary>
+	struct ThreatProfile
+	{
+		/// <summary>
+		/// Radius of the threatened area in map units, usually weapon range plus some margin.
+		/// </summary>
+		float Range;
+
+		/// <summary>
+		/// Threat added to every cell in range, e.g. DPS. Rounded to a multiple of 1/256 so removals cancel exactly.
+		/// </summary>
+		float Weight;
+
+		bool HitsGround;
+		bool HitsAir;
+	};
+
+	/// <summary>
+	/// Threat grid over the map, maintained incrementally from vision events instead of being rebuilt each frame.
+	/// Enemy units are stamped when they enter vision and removed when they leave it or die;
+	/// Update() restamps only units that moved to another cell. Queries are a single cell lookup.
+	/// </summary>
+	class InfluenceMap : public SignalObject
+	{
+	public:
+		/// <summary>
+		/// Gives the threat profile of a unit. Called once when the unit starts being tracked.
+		/// </summary>
+		using ThreatProfileFunc = std::function<ThreatProfile(const Unit&)>;
+
+		/// <summary>
+		/// Creates the map and starts tracking enemy units as they become visible.
+		/// </summary>
+		/// <param name="width">Width of the map in map units</param>
+		/// <param name="height">Height of the map in map units</param>
+		/// <param name="cellSize">Size of a grid cell in map units</param>
+		/// <param name="threatProfile">Gives the threat profile of a unit, DefaultThreatProfile if empty</param>
+		InfluenceMap(float width, float height, float cellSize = 1.0f, ThreatProfileFunc threatProfile = nullptr)
+			: CellSize(cellSize)
+			, Width(static_cast<int>(std::ceil(width / cellSize)))
+			, Height(static_cast<int>(std::ceil(height / cellSize)))
+			, GetThreatProfile(threatProfile ? std::move(threatProfile) : ThreatProfileFunc(&InfluenceMap::DefaultThreatProfile))
+		{
+			Layers[0].assign(static_cast<size_t>(Width) * Height, 0.0f);
+			Layers[1].assign(static_cast<size_t>(Width) * Height, 0.0f);
+
+			Unit::SignalUnitEnterVision().connect(this, &InfluenceMap::OnUnitEnterVision);
+			Unit::SignalUnitLeaveVision().connect(this, &InfluenceMap::OnUnitLeaveVision);
+			Unit::SignalUnitDestroyed().connect(this, &InfluenceMap::OnUnitDestroyed);
+		}
+
+		/// <summary>
+		/// Profile used when none is given: 6 range, weight 1, hits ground and air.
+		/// </summary>
+		static ThreatProfile DefaultThreatProfile(const Unit&)
+		{
+			return{ 6.0f, 1.0f, true, true };
+		}
+
+		/// <summary>
+		/// Gets the threat at a point. Points outside the map have no threat.
+		/// </summary>
+		float GetThreat(InfluenceLayer layer, const Point& point) const
+		{
+			const int x = ToCell(point.X);
+			const int y = ToCell(point.Y);
+			if (x < 0 || y < 0 || x >= Width || y >= Height)
+			{
+				return 0.0f;
+			}
+			return Layers[static_cast<int>(layer)][static_cast<size_t>(y) * Width + x];
+		}
+
+		/// <summary>
+		/// Gets the raw grid of a layer, row-major with GetWidth() cells per row.
+		/// </summary>
+		const float* GetLayer(InfluenceLayer layer) const
+		{
+			return Layers[static_cast<int>(layer)].data();
+		}
+
+		int GetWidth() const
+		{
+			return Width;
+		}
+
+		int GetHeight() const
+		{
+			return Height;
+		}
+
+		float GetCellSize() const
+		{
+			return CellSize;
+		}
+
+		/// <summary>
+		/// Number of units currently stamped on the map.
+		/// </summary>
+		size_t GetTrackedCount() const
+		{
+			return Tracked.size();
+		}
+
+		/// <summary>
+		/// Moves the stamps of tracked units that changed cell since the last update. Call once per game tick.
+		/// </summary>
+		void Update()
+		{
+			for (auto& entry : Tracked)
+			{
+				TrackedUnit& tracked = entry.second;
+				const Optional<Point> position = tracked.Target.GetPosition();
+				if (!position.hasValue())
+				{
+					continue;
+				}
+				const int x = ToCell(position.value().X);
+				const int y = ToCell(position.value().Y);
+				if (x != tracked.CellX || y != tracked.CellY)
+				{
+					Stamp(tracked, -tracked.Profile.Weight);
+					tracked.CellX = x;
+					tracked.CellY = y;
+					Stamp(tracked, tracked.Profile.Weight);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Starts tracking a unit regardless of its owner, e.g. to add units seen before the map was created.
+		/// Does nothing if the unit is already tracked or inaccessible.
+		/// </summary>
+		void Track(const Unit& unit)
+		{
+			if (Tracked.count(unit.id) != 0)
+			{
+				return;
+			}
+			const Optional<Point> position = unit.GetPosition();
+			if (!position.hasValue())
+			{
+				return;
+			}
+			TrackedUnit tracked;
+			tracked.Target = unit;
+			tracked.Profile = GetThreatProfile(unit);
+			tracked.Profile.Weight = std::round(tracked.Profile.Weight * 256.0f) / 256.0f;
+			tracked.CellX = ToCell(position.value().X);
+			tracked.CellY = ToCell(position.value().Y);
+			Stamp(tracked, tracked.Profile.Weight);
+			Tracked.emplace(unit.id, tracked);
+		}
+
+		/// <summary>
+		/// Stops tracking a unit and removes its threat.
+		/// </summary>
+		void Untrack(const Unit& unit)
+		{
+			const auto it = Tracked.find(unit.id);
+			if (it == Tracked.end())
+			{
+				return;
+			}
+			Stamp(it->second, -it->second.Profile.Weight);
+			Tracked.erase(it);
+		}
+
+		/// <summary>
+		/// Clears the grid and stamps all tracked units again at their last known cell.
+		/// </summary>
+		void Rebuild()
+		{
+			std::fill(Layers[0].begin(), Layers[0].end(), 0.0f);
+			std::fill(Layers[1].begin(), Layers[1].end(), 0.0f);
+			for (const auto& entry : Tracked)
+			{
+				Stamp(entry.second, entry.second.Profile.Weight);
+			}
+		}
+
+		#pragma region Implementations
+	private:
+		struct TrackedUnit
+		{
+			Unit Target;
+			ThreatProfile Profile;
+			int CellX;
+			int CellY;
+		};
+
+		float CellSize;
+		int Width;
+		int Height;
+		ThreatProfileFunc GetThreatProfile;
+		std::vector<float> Layers[2];
+		std::unordered_map<HandleId, TrackedUnit> Tracked;
+
+		//Half widths of the disc rows per radius in cells, index dy + radius
+		std::unordered_map<int, std::vector<int>> DiscSpans;
+
+		int ToCell(double coordinate) const
+		{
+			return static_cast<int>(std::floor(coordinate / CellSize));
+		}
+
+		const std::vector<int>& GetDiscSpans(int radius)
+		{
+			std::vector<int>& spans = DiscSpans[radius];
+			if (spans.empty())
+			{
+				spans.resize(2 * radius + 1);
+				for (int dy = -radius; dy <= radius; ++dy)
+				{
+					spans[dy + radius] = static_cast<int>(std::floor(std::sqrt(static_cast<double>(radius * radius - dy * dy))));
+				}
+			}
+			return spans;
+		}
+
+		void Stamp(const TrackedUnit& tracked, float weight)
+		{
+			const int radius = static_cast<int>(std::ceil(tracked.Profile.Range / CellSize));
+			const std::vector<int>& spans = GetDiscSpans(radius);
+			for (int layer = 0; layer < 2; ++layer)
+			{
+				if (!(layer == static_cast<int>(InfluenceLayer::Ground) ? tracked.Profile.HitsGround : tracked.Profile.HitsAir))
+				{
+					continue;
+				}
+				for (int dy = -radius; dy <= radius; ++dy)
+				{
+					const int y = tracked.CellY + dy;
+					if (y < 0 || y >= Height)
+					{
+						continue;
+					}
+					const int begin = std::max(tracked.CellX - spans[dy + radius], 0);
+					const int end = std::min(tracked.CellX + spans[dy + radius] + 1, Width);
+					if (begin < end)
+					{
+						AddSpan(&Layers[layer][static_cast<size_t>(y) * Width], begin, end, weight);
+					}
+				}
+			}
+		}
+
+		static void AddSpan(float* row, int begin, int end, float weight)
+		{
+			using PackT = Simd::Pack<float>;
+			const PackT add = PackT::Broadcast(weight);
+			int x = begin;
+			for (; x + static_cast<int>(PackT::Width) <= end; x += static_cast<int>(PackT::Width))
+			{
+				(PackT::Load(row + x) + add).Store(row + x);
+			}
+			for (; x < end; ++x)
+			{
+				row[x] += weight;
+			}
+		}
+
+		void OnUnitEnterVision(Unit eventUnit)
+		{
+			if (eventUnit.IsOwnedByEnemyPlayer())
+			{
+				Track(eventUnit);
+			}
+		}
+
+		void OnUnitLeaveVision(Unit eventUnit)
+		{
+			Untrack(eventUnit);
+		}
+
+		void OnUnitDestroyed(Unit eventUnit, Optional<Unit> /*killerUnit*/)
+		{
+			Untrack(eventUnit);
+		}
+		#pragma endregion
+	};
+}
@@ -0,0 +1,595 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIPoint.h"
+#include "Utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// What Logger::Log does when the buffer of its thread is full.
+	/// </summary>
+	enum class LogOverflow
+	{
+		//Drops the line and counts it; the drain thread reports the count
+		Drop,
+
+		//Waits until the drain thread made room; never loses a line but may stall the game thread
+		Block,
+	};
+
+	#pragma region Implementations
+	namespace Internal
+	{
+		enum class LogTag : uint8_t
+		{
+			Bool,
+			Char,
+			Int,
+			UInt,
+			Double,
+			String,
+			Unit,
+			Point,
+			None,
+		};
+
+		struct LogWriter
+		{
+			char* Out;
+
+			void Put(const void* data, size_t size)
+			{
+				std::memcpy(Out, data, size);
+				Out += size;
+			}
+
+			template<class T>
+			void Put(const T& value)
+			{
+				Put(&value, sizeof(value));
+			}
+
+			void PutString(const char* text, uint32_t length)
+			{
+				Put(LogTag::String);
+				Put(length);
+				Put(text, length);
+			}
+		};
+
+		//Encoding of an argument; types without a specialization cannot be logged
+		template<class T, class Enable = void>
+		struct LogArgument;
+
+		template<>
+		struct LogArgument<bool>
+		{
+			static size_t Size(bool) { return 1 + sizeof(bool); }
+			static void Write(LogWriter& writer, bool value) { writer.Put(LogTag::Bool); writer.Put(value); }
+		};
+
+		template<>
+		struct LogArgument<char>
+		{
+			static size_t Size(char) { return 1 + sizeof(char); }
+			static void Write(LogWriter& writer, char value) { writer.Put(LogTag::Char); writer.Put(value); }
+		};
+
+		template<class T>
+		struct LogArgument<T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, char>::value>>
+		{
+			static size_t Size(T) { return 1 + sizeof(int64_t); }
+			static void Write(LogWriter& writer, T value) { writer.Put(LogTag::Int); writer.Put(static_cast<int64_t>(value)); }
+		};
+
+		template<class T>
+		struct LogArgument<T, std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value && !std::is_same<T, char>::value>>
+		{
+			static size_t Size(T) { return 1 + sizeof(uint64_t); }
+			static void Write(LogWriter& writer, T value) { writer.Put(LogTag::UInt); writer.Put(static_cast<uint64_t>(value)); }
+		};
+
+		template<class T>
+		struct LogArgument<T, std::enable_if_t<std::is_floating_point<T>::value>>
+		{
+			static size_t Size(T) { return 1 + sizeof(double); }
+			static void Write(LogWriter& writer, T value) { writer.Put(LogTag::Double); writer.Put(static_cast<double>(value)); }
+		};
+
+		//Strings are copied, so they may change or go away after the call
+		template<>
+		struct LogArgument<const char*>
+		{
+			static size_t Size(const char* text) { return 1 + sizeof(uint32_t) + (text != nullptr ? std::strlen(text) : 0); }
+
+			static void Write(LogWriter& writer, const char* text)
+			{
+				writer.PutString(text != nullptr ? text : "", static_cast<uint32_t>(text != nullptr ? std::strlen(text) : 0));
+			}
+		};
+
+		template<>
+		struct LogArgument<char*> : LogArgument<const char*> {};
+
+		template<>
+		struct LogArgument<std::string>
+		{
+			static size_t Size(const std::string& text) { return 1 + sizeof(uint32_t) + text.size(); }
+			static void Write(LogWriter& writer, const std::string& text) { writer.PutString(text.data(), static_cast<uint32_t>(text.size())); }
+		};
+
+		//Units are logged by handle: asking the game for more would cost what the logger saves
+		template<>
+		struct LogArgument<Unit>
+		{
+			static size_t Size(const Unit&) { return 1 + sizeof(HandleId); }
+			static void Write(LogWriter& writer, const Unit& unit) { writer.Put(LogTag::Unit); writer.Put(unit.id); }
+		};
+
+		template<>
+		struct LogArgument<Point>
+		{
+			static size_t Size(const Point&) { return 1 + 2 * sizeof(double); }
+			static void Write(LogWriter& writer, const Point& point) { writer.Put(LogTag::Point); writer.Put(point.X); writer.Put(point.Y); }
+		};
+
+		template<class T>
+		struct LogArgument<Optional<T>>
+		{
+			static size_t Size(const Optional<T>& value)
+			{
+				return value.hasValue() ? LogArgument<T>::Size(value.value()) : 1;
+			}
+
+			static void Write(LogWriter& writer, const Optional<T>& value)
+			{
+				if (value.hasValue())
+				{
+					LogArgument<T>::Write(writer, value.value());
+				}
+				else
+				{
+					writer.Put(LogTag::None);
+				}
+			}
+		};
+
+		template<class T>
+		using LogArgumentOf = LogArgument<std::decay_t<T>>;
+
+		inline size_t LogArgumentsSize()
+		{
+			return 0;
+		}
+
+		template<class T, class ... ArgsT>
+		size_t LogArgumentsSize(const T& value, const ArgsT& ... args)
+		{
+			return LogArgumentOf<T>::Size(value) + LogArgumentsSize(args ...);
+		}
+
+		inline void WriteLogArguments(LogWriter&)
+		{
+		}
+
+		template<class T, class ... ArgsT>
+		void WriteLogArguments(LogWriter& writer, const T& value, const ArgsT& ... args)
+		{
+			LogArgumentOf<T>::Write(writer, value);
+			WriteLogArguments(writer, args ...);
+		}
+
+		//Appends the text of the encoded arguments in [data, end) to the line
+		inline void FormatLogArguments(const char* data, const char* end, std::string& line)
+		{
+			const auto take = [&data](void* value, size_t size)
+			{
+				std::memcpy(value, data, size);
+				data += size;
+			};
+			char number[64];
+			while (data < end)
+			{
+				LogTag tag;
+				take(&tag, sizeof(tag));
+				switch (tag)
+				{
+				case LogTag::Bool:
+				{
+					bool value;
+					take(&value, sizeof(value));
+					line += value ? "true" : "false";
+					break;
+				}
+				case LogTag::Char:
+				{
+					char value;
+					take(&value, sizeof(value));
+					line += value;
+					break;
+				}
+				case LogTag::Int:
+				{
+					int64_t value;
+					take(&value, sizeof(value));
+					std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(value));
+					line += number;
+					break;
+				}
+				case LogTag::UInt:
+				{
+					uint64_t value;
+					take(&value, sizeof(value));
+					std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(value));
+					line += number;
+					break;
+				}
+				case LogTag::Double:
+				{
+					double value;
+					take(&value, sizeof(value));
+					std::snprintf(number, sizeof(number), "%g", value);
+					line += number;
+					break;
+				}
+				case LogTag::String:
+				{
+					uint32_t length;
+					take(&length, sizeof(length));
+					line.append(data, length);
+					data += length;
+					break;
+				}
+				case LogTag::Unit:
+				{
+					HandleId id;
+					take(&id, sizeof(id));
+					line += "Unit ";
+					line += std::to_string(id);
+					break;
+				}
+				case LogTag::Point:
+				{
+					double x, y;
+					take(&x, sizeof(x));
+					take(&y, sizeof(y));
+					std::snprintf(number, sizeof(number), "(%g, %g)", x, y);
+					line += number;
+					break;
+				}
+				case LogTag::None:
+					line += "none";
+					break;
+				}
+			}
+		}
+	}
+	#pragma endregion
+
+	/// <summary>
+	/// Asynchronous logger in front of LogLoader. Log copies its arguments into a buffer of the calling thread, without
+	/// locks, allocations or formatting; a background thread formats the lines and writes them to the sink.
+	/// Lines of one thread keep their order; lines of different threads may interleave differently than they were logged.
+	/// The drain thread starts with the first line. From a bot DLL, call Stop in the cleanup export: joining a thread
+	/// while the DLL unloads can deadlock.
+	/// </summary>
+	class Logger
+	{
+	public:
+		static Logger& Get()
+		{
+			static Logger logger;
+			return logger;
+		}
+
+		/// <summary>
+		/// Logs the arguments as one line, concatenated: strings, characters, numbers, bool, Unit (by handle), Point
+		/// and Optional of these.
+		/// </summary>
+		template<class ... ArgsT>
+		void Log(const ArgsT& ... args)
+		{
+			const uint32_t size = static_cast<uint32_t>(sizeof(uint32_t) + Internal::LogArgumentsSize(args ...));
+			if (size > RingBytes / 4 || Stopped.load(std::memory_order_acquire))
+			{
+				//Too long for the buffers, or nobody left to drain them; written after the lines before it
+				Flush();
+				std::vector<char> record(size);
+				Internal::LogWriter writer{ record.data() };
+				Internal::WriteLogArguments(writer, args ...);
+				WriteLine(record.data(), writer.Out);
+				return;
+			}
+			Ring& ring = GetThreadRing();
+			char* record = Reserve(ring, RoundUp(size));
+			if (record == nullptr)
+			{
+				return;
+			}
+			std::memcpy(record, &size, sizeof(size));
+			Internal::LogWriter writer{ record + sizeof(uint32_t) };
+			Internal::WriteLogArguments(writer, args ...);
+			ring.Head.store(ring.Head.load(std::memory_order_relaxed) + RoundUp(size), std::memory_order_release);
+		}
+
+		/// <summary>
+		/// Replaces the output of the formatted lines, LogLoader by default. Called from the drain thread, one line at a time.
+		/// </summary>
+		void SetSink(std::function<void(const std::string&)> sink)
+		{
+			std::lock_guard<std::mutex> lock(SinkMutex);
+			Sink = std::move(sink);
+		}
+
+		void SetOverflow(LogOverflow overflow)
+		{
+			Overflow.store(overflow, std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Waits until every line logged before the call was written to the sink.
+		/// </summary>
+		void Flush()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			if (!Drainer.joinable())
+			{
+				return;
+			}
+			const uint64_t request = ++FlushRequests;
+			Wake.notify_one();
+			Flushed.wait(lock, [this, request]() { return FlushedRequests >= request; });
+		}
+
+		/// <summary>
+		/// Writes the pending lines and stops the drain thread. Lines logged afterwards are written on the calling thread.
+		/// </summary>
+		void Stop()
+		{
+			std::thread drainer;
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Stopped.store(true, std::memory_order_release);
+				Stopping = true;
+				drainer = std::move(Drainer);
+			}
+			Wake.notify_one();
+			if (drainer.joinable())
+			{
+				drainer.join();
+			}
+			//Lines written between the last drain and Stopped becoming visible
+			std::lock_guard<std::mutex> lock(Mutex);
+			DrainAll();
+		}
+
+		/// <summary>
+		/// Number of lines dropped because a buffer was full, since the start.
+		/// </summary>
+		uint64_t GetDroppedCount() const
+		{
+			return TotalDropped.load(std::memory_order_relaxed);
+		}
+
+		~Logger()
+		{
+			Stop();
+		}
+
+		Logger(const Logger&) = delete;
+		Logger& operator=(const Logger&) = delete;
+
+		#pragma region Implementations
+	private:
+		enum : uint32_t
+		{
+			//Bytes per thread, a power of two; about a thousand typical lines
+			RingBytes = 1 << 16,
+		};
+
+		//Written by its thread only, read by the drain thread
+		struct Ring
+		{
+			std::unique_ptr<char[]> Bytes = std::unique_ptr<char[]>(new char[RingBytes]);
+			std::atomic<uint32_t> Head{ 0 };
+			std::atomic<uint32_t> Tail{ 0 };
+			std::atomic<uint64_t> Dropped{ 0 };
+			std::atomic<bool> Retired{ false };
+		};
+
+		//Keeps the ring alive until it was drained, even after the thread exited
+		struct RingOwner
+		{
+			std::shared_ptr<Ring> Owned;
+
+			~RingOwner()
+			{
+				if (Owned)
+				{
+					Owned->Retired.store(true, std::memory_order_release);
+				}
+			}
+		};
+
+		std::mutex Mutex;
+		std::condition_variable Wake;
+		std::condition_variable Flushed;
+		std::vector<std::shared_ptr<Ring>> Rings;
+		std::thread Drainer;
+		bool Stopping = false;
+		uint64_t FlushRequests = 0;
+		uint64_t FlushedRequests = 0;
+		std::atomic<bool> Stopped{ false };
+		std::atomic<LogOverflow> Overflow{ LogOverflow::Drop };
+		std::atomic<uint64_t> TotalDropped{ 0 };
+
+		std::mutex SinkMutex;
+		std::function<void(const std::string&)> Sink = [](const std::string& line) { LogLoader(line); };
+
+		//Drained by the drain thread
+		std::string Line;
+
+		Logger() = default;
+
+		static uint32_t RoundUp(uint32_t size)
+		{
+			return (size + 3) & ~3u;
+		}
+
+		Ring& GetThreadRing()
+		{
+			thread_local RingOwner owner;
+			if (!owner.Owned)
+			{
+				owner.Owned = std::make_shared<Ring>();
+				std::lock_guard<std::mutex> lock(Mutex);
+				Rings.push_back(owner.Owned);
+				if (!Drainer.joinable() && !Stopping)
+				{
+					Drainer = std::thread(&Logger::Run, this);
+				}
+			}
+			return *owner.Owned;
+		}
+
+		//Finds contiguous room for a record of the rounded size; records never wrap, a zero size marks the skipped end.
+		//The record starts with its exact size, and the next one at the size rounded up to four bytes.
+		char* Reserve(Ring& ring, uint32_t size)
+		{
+			for (;;)
+			{
+				const uint32_t head = ring.Head.load(std::memory_order_relaxed);
+				const uint32_t offset = head & (RingBytes - 1);
+				const uint32_t padding = RingBytes - offset < size ? RingBytes - offset : 0;
+				if (head + padding + size - ring.Tail.load(std::memory_order_acquire) <= RingBytes)
+				{
+					if (padding != 0)
+					{
+						const uint32_t skip = 0;
+						std::memcpy(ring.Bytes.get() + offset, &skip, sizeof(skip));
+						ring.Head.store(head + padding, std::memory_order_release);
+					}
+					return ring.Bytes.get() + ((head + padding) & (RingBytes - 1));
+				}
+				if (Overflow.load(std::memory_order_relaxed) == LogOverflow::Drop || Stopped.load(std::memory_order_acquire))
+				{
+					ring.Dropped.fetch_add(1, std::memory_order_relaxed);
+					TotalDropped.fetch_add(1, std::memory_order_relaxed);
+					return nullptr;
+				}
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					++FlushRequests;
+				}
+				Wake.notify_one();
+				std::this_thread::yield();
+			}
+		}
+
+		void WriteLine(const char* data, const char* end)
+		{
+			std::lock_guard<std::mutex> lock(SinkMutex);
+			Line.clear();
+			Internal::FormatLogArguments(data, end, Line);
+			if (Sink)
+			{
+				Sink(Line);
+			}
+		}
+
+		void Drain(Ring& ring)
+		{
+			const uint32_t head = ring.Head.load(std::memory_order_acquire);
+			uint32_t tail = ring.Tail.load(std::memory_order_relaxed);
+			while (tail != head)
+			{
+				const char* record = ring.Bytes.get() + (tail & (RingBytes - 1));
+				uint32_t size;
+				std::memcpy(&size, record, sizeof(size));
+				if (size == 0)
+				{
+					tail += RingBytes - (tail & (RingBytes - 1));
+					continue;
+				}
+				WriteLine(record + sizeof(uint32_t), record + size);
+				tail += RoundUp(size);
+				ring.Tail.store(tail, std::memory_order_release);
+			}
+			ring.Tail.store(tail, std::memory_order_release);
+			const uint64_t dropped = ring.Dropped.exchange(0, std::memory_order_relaxed);
+			if (dropped != 0)
+			{
+				std::lock_guard<std::mutex> lock(SinkMutex);
+				if (Sink)
+				{
+					Sink("[Logger] " + std::to_string(dropped) + " lines dropped");
+				}
+			}
+		}
+
+		//Called with Mutex held
+		void DrainAll()
+		{
+			for (size_t i = 0; i < Rings.size();)
+			{
+				Ring& ring = *Rings[i];
+				//Checked first: everything the thread logged before exiting is visible to the drain below
+				const bool retired = ring.Retired.load(std::memory_order_acquire);
+				Drain(ring);
+				if (retired)
+				{
+					Rings[i] = std::move(Rings.back());
+					Rings.pop_back();
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+
+		void Run()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			while (!Stopping)
+			{
+				Wake.wait_for(lock, std::chrono::milliseconds(5), [this]() { return Stopping || FlushRequests != FlushedRequests; });
+				const uint64_t request = FlushRequests;
+				//Rings are only added under the lock, and draining them needs no lock
+				const std::vector<std::shared_ptr<Ring>> rings = Rings;
+				lock.unlock();
+				for (const std::shared_ptr<Ring>& ring : rings)
+				{
+					Drain(*ring);
+				}
+				lock.lock();
+				Rings.erase(std::remove_if(Rings.begin(), Rings.end(), [](const std::shared_ptr<Ring>& ring)
+				{
+					return ring->Retired.load(std::memory_order_acquire) && ring->Tail.load(std::memory_order_relaxed) == ring->Head.load(std::memory_order_acquire);
+				}), Rings.end());
+				FlushedRequests = request;
+				Flushed.notify_all();
+			}
+		}
+		#pragma endregion
+	};
+}
+
+//Logs the arguments as one line through the asynchronous logger, see Logger::Log
+#define SC2API_LOG(...) SC2API::Logger::Get().Log(__VA_ARGS__)
@@ -0,0 +1,809 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIPoint.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Internal
+	{
+		const float PathUnreachable = std::numeric_limits<float>::infinity();
+		const float PathDiagonalCost = 1.41421356f;
+	}
+
+	/// <summary>
+	/// Compact bitmap over the map grid, one bit per cell, one cell per map unit.
+	/// Used for the pathing grid (bit set when walkable) and likewise for the placement grid (bit set when buildable).
+	/// The API does not expose terrain, so the grid is filled by the caller, e.g. from the map file or from a synthetic layout.
+	/// </summary>
+	class PathingGrid
+	{
+	public:
+		PathingGrid()
+			: Width(0), Height(0), RowWords(0)
+		{}
+
+		/// <summary>
+		/// Creates a grid with every cell set to given value.
+		/// </summary>
+		PathingGrid(int width, int height, bool walkable = false)
+			: Width(width), Height(height), RowWords((width + 63) / 64)
+		{
+			Bits.assign(static_cast<size_t>(RowWords) * height, 0);
+			if (walkable)
+			{
+				SetRect(0, 0, width, height, true);
+			}
+		}
+
+		/// <summary>
+		/// Creates a grid from text rows, top row first, where '.' is a set cell and any other character is a cleared cell.
+		/// Meant for synthetic grids in tests and tools.
+		/// </summary>
+		static PathingGrid FromRows(const std::vector<std::string>& rows)
+		{
+			const int height = static_cast<int>(rows.size());
+			int width = 0;
+			for (const std::string& row : rows)
+			{
+				width = std::max(width, static_cast<int>(row.size()));
+			}
+			PathingGrid grid(width, height);
+			for (int y = 0; y < height; ++y)
+			{
+				const std::string& row = rows[height - 1 - y];
+				for (int x = 0; x < static_cast<int>(row.size()); ++x)
+				{
+					grid.Set(x, y, row[x] == '.');
+				}
+			}
+			return grid;
+		}
+
+		int GetWidth() const
+		{
+			return Width;
+		}
+
+		int GetHeight() const
+		{
+			return Height;
+		}
+
+		/// <summary>
+		/// Determines whether a cell is set. Cells outside the grid are never set.
+		/// </summary>
+		bool IsWalkable(int x, int y) const
+		{
+			if (x < 0 || y < 0 || x >= Width || y >= Height)
+			{
+				return false;
+			}
+			return ((Bits[static_cast<size_t>(y) * RowWords + x / 64] >> (x % 64)) & 1) != 0;
+		}
+
+		bool IsWalkable(const Point& point) const
+		{
+			return IsWalkable(static_cast<int>(std::floor(point.X)), static_cast<int>(std::floor(point.Y)));
+		}
+
+		void Set(int x, int y, bool walkable)
+		{
+			uint64_t& word = Bits[static_cast<size_t>(y) * RowWords + x / 64];
+			const uint64_t bit = 1ULL << (x % 64);
+			word = walkable ? (word | bit) : (word & ~bit);
+		}
+
+		/// <summary>
+		/// Sets all cells of [x, x + width) x [y, y + height), clipped to the grid.
+		/// </summary>
+		void SetRect(int x, int y, int width, int height, bool walkable)
+		{
+			const int x1 = std::min(x + width, Width);
+			const int y1 = std::min(y + height, Height);
+			for (int row = std::max(y, 0); row < y1; ++row)
+			{
+				for (int column = std::max(x, 0); column < x1; ++column)
+				{
+					Set(column, row, walkable);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Raw bits, GetRowWords() 64 bit words per row, bit x % 64 of word x / 64 for column x.
+		/// </summary>
+		const uint64_t* GetWords() const
+		{
+			return Bits.data();
+		}
+
+		int GetRowWords() const
+		{
+			return RowWords;
+		}
+
+	private:
+		int Width;
+		int Height;
+		int RowWords;
+		std::vector<uint64_t> Bits;
+	};
+
+	/// <summary>
+	/// Hierarchical (HPA*) path planner over a pathing grid.
+	/// The grid is cut into square clusters; entrances between neighbouring clusters and the distances between the entrances
+	/// of each cluster are cached, so a query searches a small abstract graph and only touches cells in the start and goal clusters.
+	/// Obstacles (buildings) invalidate only the clusters they touch, which are rebuilt on the next query.
+	/// Movement is 8-connected without cutting corners. Paths are near-optimal, as usual for HPA*.
+	/// Queries reuse scratch buffers, so one planner must not be queried from several threads at once.
+	/// </summary>
+	class PathPlanner
+	{
+	public:
+		/// <summary>
+		/// Creates a planner.
+		/// </summary>
+		/// <param name="terrain">Walkable cells of the map without any units</param>
+		/// <param name="clusterSize">Edge length of a cluster in cells</param>
+		explicit PathPlanner(const PathingGrid& terrain, int clusterSize = 16)
+			: Terrain(terrain)
+			, Grid(terrain)
+			, ClusterSize(clusterSize)
+			, ClustersX((terrain.GetWidth() + clusterSize - 1) / clusterSize)
+			, ClustersY((terrain.GetHeight() + clusterSize - 1) / clusterSize)
+			, Clusters(static_cast<size_t>(ClustersX) * ClustersY)
+			, ObstacleCount(static_cast<size_t>(terrain.GetWidth()) * terrain.GetHeight(), 0)
+			, Scores(static_cast<size_t>(terrain.GetWidth()) * terrain.GetHeight())
+		{}
+
+		/// <summary>
+		/// Gets the current pathing grid, terrain minus obstacles.
+		/// </summary>
+		const PathingGrid& GetGrid() const
+		{
+			return Grid;
+		}
+
+		/// <summary>
+		/// Gets a counter increased whenever the pathing grid changes, so derived data can tell when it is stale.
+		/// </summary>
+		uint32_t GetGridVersion() const
+		{
+			return GridVersion;
+		}
+
+		/// <summary>
+		/// Blocks a rectangle of cells, e.g. the footprint of a new building. Obstacles may overlap.
+		/// </summary>
+		void AddObstacle(int x, int y, int width, int height)
+		{
+			ChangeObstacle(x, y, width, height, 1);
+		}
+
+		/// <summary>
+		/// Removes an obstacle previously added with the same rectangle.
+		/// </summary>
+		void RemoveObstacle(int x, int y, int width, int height)
+		{
+			ChangeObstacle(x, y, width, height, -1);
+		}
+
+		/// <summary>
+		/// Gets the walking distance between two points. Cheaper than FindPath as the path is not refined into cells.
+		/// Use in place of Point::Dist where cliffs and chokes matter.
+		/// </summary>
+		/// <returns>The distance, or empty value if either point is blocked or there is no path</returns>
+		Optional<double> PathDistance(const Point& start, const Point& goal)
+		{
+			const int startCell = ToCell(start);
+			const int goalCell = ToCell(goal);
+			if (startCell < 0 || goalCell < 0)
+			{
+				return{};
+			}
+			const float distance = Search(startCell, goalCell);
+			if (distance == Internal::PathUnreachable)
+			{
+				return{};
+			}
+			return static_cast<double>(distance);
+		}
+
+		/// <summary>
+		/// Finds a path between two points.
+		/// </summary>
+		/// <param name="start">The point to start from</param>
+		/// <param name="goal">The point to reach</param>
+		/// <param name="outPath">Receives the centers of the cells along the path, start and goal cells included</param>
+		/// <returns>Length of the path, or empty value if either point is blocked or there is no path</returns>
+		Optional<double> FindPath(const Point& start, const Point& goal, std::vector<Point>& outPath)
+		{
+			outPath.clear();
+			const int startCell = ToCell(start);
+			const int goalCell = ToCell(goal);
+			if (startCell < 0 || goalCell < 0)
+			{
+				return{};
+			}
+			const float distance = Search(startCell, goalCell);
+			if (distance == Internal::PathUnreachable)
+			{
+				return{};
+			}
+
+			std::vector<int> cells;
+			if (DirectPath)
+			{
+				AppendLocalPath(startCell, goalCell, cells);
+			}
+			else
+			{
+				//Abstract chain is walked back from the last entrance
+				std::vector<int> chain;
+				for (int cell = BestEntrance; cell != -1; cell = Scores[cell].Parent)
+				{
+					chain.push_back(cell);
+				}
+				std::reverse(chain.begin(), chain.end());
+
+				AppendLocalPath(startCell, chain.front(), cells);
+				for (size_t i = 1; i < chain.size(); ++i)
+				{
+					if (GetClusterIndex(chain[i - 1]) == GetClusterIndex(chain[i]))
+					{
+						AppendLocalPath(chain[i - 1], chain[i], cells);
+					}
+					else
+					{
+						cells.push_back(chain[i]);
+					}
+				}
+				AppendLocalPath(chain.back(), goalCell, cells);
+			}
+
+			outPath.reserve(cells.size());
+			for (int cell : cells)
+			{
+				outPath.push_back({ cell % Grid.GetWidth() + 0.5, cell / Grid.GetWidth() + 0.5 });
+			}
+			return static_cast<double>(distance);
+		}
+
+		#pragma region Implementations
+	private:
+		struct Entrance
+		{
+			int Cell;
+
+			//Adjacent entrance cells in neighbouring clusters; a corner cell can lead to two clusters
+			int Partners[2];
+		};
+
+		struct Cluster
+		{
+			bool Dirty = true;
+			std::vector<Entrance> Entrances;
+
+			//Walkable cells with a blocked one cell border, (ClusterSize + 2) squared, see LocalIndex
+			std::vector<uint8_t> Walkable;
+
+			//Entrances.size() squared, distance between entrances i and j when staying inside the cluster
+			std::vector<float> Distances;
+		};
+
+		struct NodeScore
+		{
+			float G;
+			int Parent;
+			uint32_t Generation;
+		};
+
+		using HeapEntry = std::pair<float, int>;
+
+		struct LocalSearchResult
+		{
+			std::vector<float> Dist;
+			std::vector<int> Parent;
+		};
+
+		PathingGrid Terrain;
+		PathingGrid Grid;
+		int ClusterSize;
+		int ClustersX;
+		int ClustersY;
+		std::vector<Cluster> Clusters;
+		std::vector<uint16_t> ObstacleCount;
+
+		//Abstract search scratch, reset by bumping Generation instead of clearing
+		std::vector<NodeScore> Scores;
+		uint32_t Generation = 0;
+		uint32_t GridVersion = 0;
+		LocalSearchResult StartSearch;
+		LocalSearchResult GoalSearch;
+		LocalSearchResult Scratch;
+		int StartSearchCell = -1;
+		int GoalSearchCell = -1;
+		std::vector<HeapEntry> Open;
+		std::vector<HeapEntry> Heap;
+		int BestEntrance = -1;
+		bool DirectPath = false;
+
+		int ToCell(const Point& point) const
+		{
+			const int x = static_cast<int>(std::floor(point.X));
+			const int y = static_cast<int>(std::floor(point.Y));
+			if (!Grid.IsWalkable(x, y))
+			{
+				return -1;
+			}
+			return y * Grid.GetWidth() + x;
+		}
+
+		int GetClusterIndex(int cell) const
+		{
+			return (cell / Grid.GetWidth()) / ClusterSize * ClustersX + (cell % Grid.GetWidth()) / ClusterSize;
+		}
+
+		static float Octile(int dx, int dy)
+		{
+			dx = std::abs(dx);
+			dy = std::abs(dy);
+			return static_cast<float>(std::max(dx, dy) - std::min(dx, dy)) + Internal::PathDiagonalCost * static_cast<float>(std::min(dx, dy));
+		}
+
+		void ChangeObstacle(int x, int y, int width, int height, int delta)
+		{
+			const int x0 = std::max(x, 0);
+			const int y0 = std::max(y, 0);
+			const int x1 = std::min(x + width, Grid.GetWidth());
+			const int y1 = std::min(y + height, Grid.GetHeight());
+			if (x0 >= x1 || y0 >= y1)
+			{
+				return;
+			}
+			StartSearchCell = -1;
+			GoalSearchCell = -1;
+			++GridVersion;
+			for (int row = y0; row < y1; ++row)
+			{
+				for (int column = x0; column < x1; ++column)
+				{
+					uint16_t& count = ObstacleCount[static_cast<size_t>(row) * Grid.GetWidth() + column];
+					count = static_cast<uint16_t>(count + delta);
+					Grid.Set(column, row, count == 0 && Terrain.IsWalkable(column, row));
+				}
+			}
+
+			//Entrances on a border belong to both clusters, so the clusters next to the rectangle are invalidated too
+			const int cx0 = std::max((x0 - 1) / ClusterSize, 0);
+			const int cy0 = std::max((y0 - 1) / ClusterSize, 0);
+			const int cx1 = std::min(x1 / ClusterSize, ClustersX - 1);
+			const int cy1 = std::min(y1 / ClusterSize, ClustersY - 1);
+			for (int cy = cy0; cy <= cy1; ++cy)
+			{
+				for (int cx = cx0; cx <= cx1; ++cx)
+				{
+					Clusters[cy * ClustersX + cx].Dirty = true;
+				}
+			}
+		}
+
+		void GetClusterBounds(int clusterIndex, int& x0, int& y0, int& width, int& height) const
+		{
+			x0 = clusterIndex % ClustersX * ClusterSize;
+			y0 = clusterIndex / ClustersX * ClusterSize;
+			width = std::min(ClusterSize, Grid.GetWidth() - x0);
+			height = std::min(ClusterSize, Grid.GetHeight() - y0);
+		}
+
+		//Scans the border between this cluster's cells (x, y) and the neighbour cells (x + nx, y + ny) along (stepX, stepY).
+		//Open runs get one entrance in the middle, long runs one at each end; both clusters compute the same result.
+		void ScanBorder(Cluster& cluster, int x, int y, int stepX, int stepY, int length, int nx, int ny)
+		{
+			const int width = Grid.GetWidth();
+			int runStart = -1;
+			for (int i = 0; i <= length; ++i)
+			{
+				const int cx = x + stepX * i;
+				const int cy = y + stepY * i;
+				const bool open = i < length && Grid.IsWalkable(cx, cy) && Grid.IsWalkable(cx + nx, cy + ny);
+				if (open && runStart < 0)
+				{
+					runStart = i;
+				}
+				else if (!open && runStart >= 0)
+				{
+					const int runEnd = i - 1;
+					int picks[2] = { (runStart + runEnd) / 2, -1 };
+					if (runEnd - runStart + 1 >= 6)
+					{
+						picks[0] = runStart;
+						picks[1] = runEnd;
+					}
+					for (int pick : picks)
+					{
+						if (pick < 0)
+						{
+							continue;
+						}
+						const int cell = (y + stepY * pick) * width + x + stepX * pick;
+						const int partner = cell + ny * width + nx;
+						auto it = std::find_if(cluster.Entrances.begin(), cluster.Entrances.end(),
+							[cell](const Entrance& entrance) { return entrance.Cell == cell; });
+						if (it == cluster.Entrances.end())
+						{
+							cluster.Entrances.push_back({ cell, { partner, -1 } });
+						}
+						else
+						{
+							it->Partners[1] = partner;
+						}
+					}
+					runStart = -1;
+				}
+			}
+		}
+
+		void RebuildCluster(int clusterIndex)
+		{
+			Cluster& cluster = Clusters[clusterIndex];
+			int x0, y0, width, height;
+			GetClusterBounds(clusterIndex, x0, y0, width, height);
+
+			const int stride = ClusterSize + 2;
+			cluster.Walkable.assign(static_cast<size_t>(stride) * stride, 0);
+			for (int y = 0; y < height; ++y)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					cluster.Walkable[(y + 1) * stride + x + 1] = Grid.IsWalkable(x0 + x, y0 + y) ? 1 : 0;
+				}
+			}
+
+			cluster.Entrances.clear();
+			if (x0 > 0)
+			{
+				ScanBorder(cluster, x0, y0, 0, 1, height, -1, 0);
+			}
+			if (x0 + width < Grid.GetWidth())
+			{
+				ScanBorder(cluster, x0 + width - 1, y0, 0, 1, height, 1, 0);
+			}
+			if (y0 > 0)
+			{
+				ScanBorder(cluster, x0, y0, 1, 0, width, 0, -1);
+			}
+			if (y0 + height < Grid.GetHeight())
+			{
+				ScanBorder(cluster, x0, y0 + height - 1, 1, 0, width, 0, 1);
+			}
+
+			const size_t count = cluster.Entrances.size();
+			cluster.Distances.assign(count * count, Internal::PathUnreachable);
+			for (size_t i = 0; i < count; ++i)
+			{
+				LocalSearch(clusterIndex, cluster.Entrances[i].Cell, -1, Scratch);
+				for (size_t j = 0; j < count; ++j)
+				{
+					cluster.Distances[i * count + j] = Scratch.Dist[LocalIndex(cluster.Entrances[j].Cell)];
+				}
+			}
+			cluster.Dirty = false;
+		}
+
+		Cluster& GetCluster(int clusterIndex)
+		{
+			if (Clusters[clusterIndex].Dirty)
+			{
+				RebuildCluster(clusterIndex);
+			}
+			return Clusters[clusterIndex];
+		}
+
+		//Index of a cell in the padded layout of its cluster. Clusters start at multiples of ClusterSize, so it follows from the cell alone.
+		int LocalIndex(int cell) const
+		{
+			return (cell / Grid.GetWidth() % ClusterSize + 1) * (ClusterSize + 2) + cell % Grid.GetWidth() % ClusterSize + 1;
+		}
+
+		int CellFromLocal(int clusterIndex, int local) const
+		{
+			int x0, y0, width, height;
+			GetClusterBounds(clusterIndex, x0, y0, width, height);
+			return (y0 + local / (ClusterSize + 2) - 1) * Grid.GetWidth() + x0 + local % (ClusterSize + 2) - 1;
+		}
+
+		//Dijkstra restricted to one cluster, over the padded layout so neighbours need no bounds checks.
+		//Stops early once target is settled, or covers the whole cluster for target -1. The cluster must be up to date.
+		void LocalSearch(int clusterIndex, int source, int target, LocalSearchResult& result)
+		{
+			static const int StepX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+			static const int StepY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+			const int stride = ClusterSize + 2;
+			const uint8_t* walkable = Clusters[clusterIndex].Walkable.data();
+			result.Dist.assign(static_cast<size_t>(stride) * stride, Internal::PathUnreachable);
+			result.Parent.assign(static_cast<size_t>(stride) * stride, -1);
+
+			const int targetLocal = target < 0 ? -1 : LocalIndex(target);
+			Heap.clear();
+			result.Dist[LocalIndex(source)] = 0.0f;
+			PushHeap(0.0f, LocalIndex(source));
+			while (!Heap.empty())
+			{
+				const HeapEntry top = PopHeap();
+				const int local = top.second;
+				if (top.first > result.Dist[local])
+				{
+					continue;
+				}
+				if (local == targetLocal)
+				{
+					return;
+				}
+				for (int direction = 0; direction < 8; ++direction)
+				{
+					const int next = local + StepY[direction] * stride + StepX[direction];
+					if (!walkable[next])
+					{
+						continue;
+					}
+					const bool diagonal = direction >= 4;
+					if (diagonal && (!walkable[local + StepX[direction]] || !walkable[local + StepY[direction] * stride]))
+					{
+						continue;
+					}
+					const float g = top.first + (diagonal ? Internal::PathDiagonalCost : 1.0f);
+					if (g < result.Dist[next])
+					{
+						result.Dist[next] = g;
+						result.Parent[next] = local;
+						PushHeap(g, next);
+					}
+				}
+			}
+		}
+
+		void PushHeap(float key, int cell)
+		{
+			Heap.push_back({ key, cell });
+			std::push_heap(Heap.begin(), Heap.end(), std::greater<HeapEntry>());
+		}
+
+		HeapEntry PopHeap()
+		{
+			std::pop_heap(Heap.begin(), Heap.end(), std::greater<HeapEntry>());
+			const HeapEntry top = Heap.back();
+			Heap.pop_back();
+			return top;
+		}
+
+		void AppendLocalPath(int from, int to, std::vector<int>& cells)
+		{
+			const int clusterIndex = GetClusterIndex(from);
+			LocalSearch(clusterIndex, from, to, Scratch);
+			const size_t begin = cells.size();
+			const int fromLocal = LocalIndex(from);
+			for (int local = LocalIndex(to); local != fromLocal; local = Scratch.Parent[local])
+			{
+				cells.push_back(CellFromLocal(clusterIndex, local));
+			}
+			if (begin == 0)
+			{
+				cells.push_back(from);
+			}
+			std::reverse(cells.begin() + begin, cells.end());
+		}
+
+		float Search(int startCell, int goalCell)
+		{
+			const int width = Grid.GetWidth();
+			const int goalX = goalCell % width;
+			const int goalY = goalCell / width;
+			const int startCluster = GetClusterIndex(startCell);
+			const int goalCluster = GetClusterIndex(goalCell);
+			BestEntrance = -1;
+			DirectPath = false;
+
+			float best = Internal::PathUnreachable;
+			Open.clear();
+			const Cluster& first = GetCluster(startCluster);
+			GetCluster(goalCluster);
+			//Units sharing a goal (or a start) reuse its search
+			if (goalCell != GoalSearchCell)
+			{
+				LocalSearch(goalCluster, goalCell, -1, GoalSearch);
+				GoalSearchCell = goalCell;
+			}
+			if (startCell != StartSearchCell)
+			{
+				LocalSearch(startCluster, startCell, -1, StartSearch);
+				StartSearchCell = startCell;
+			}
+			if (startCluster == goalCluster)
+			{
+				best = GoalSearch.Dist[LocalIndex(startCell)];
+				DirectPath = best != Internal::PathUnreachable;
+			}
+
+			if (++Generation == 0)
+			{
+				std::fill(Scores.begin(), Scores.end(), NodeScore{ Internal::PathUnreachable, -1, 0 });
+				Generation = 1;
+			}
+
+			auto relax = [&](int cell, float g, int parent)
+			{
+				NodeScore& score = Scores[cell];
+				if (score.Generation != Generation || g < score.G)
+				{
+					score = { g, parent, Generation };
+					Open.push_back({ g + Octile(cell % width - goalX, cell / width - goalY), cell });
+					std::push_heap(Open.begin(), Open.end(), std::greater<HeapEntry>());
+				}
+			};
+
+			for (const Entrance& entrance : first.Entrances)
+			{
+				const float g = StartSearch.Dist[LocalIndex(entrance.Cell)];
+				if (g != Internal::PathUnreachable)
+				{
+					relax(entrance.Cell, g, -1);
+				}
+			}
+
+			while (!Open.empty())
+			{
+				std::pop_heap(Open.begin(), Open.end(), std::greater<HeapEntry>());
+				const HeapEntry top = Open.back();
+				Open.pop_back();
+				if (top.first >= best)
+				{
+					break;
+				}
+				const int cell = top.second;
+				const float g = Scores[cell].G;
+				if (top.first > g + Octile(cell % width - goalX, cell / width - goalY))
+				{
+					continue;
+				}
+
+				const int clusterIndex = GetClusterIndex(cell);
+				if (clusterIndex == goalCluster)
+				{
+					const float total = g + GoalSearch.Dist[LocalIndex(cell)];
+					if (total < best)
+					{
+						best = total;
+						BestEntrance = cell;
+						DirectPath = false;
+					}
+				}
+
+				const Cluster& cluster = GetCluster(clusterIndex);
+				const size_t count = cluster.Entrances.size();
+				size_t self = 0;
+				while (self < count && cluster.Entrances[self].Cell != cell)
+				{
+					++self;
+				}
+				if (self == count)
+				{
+					continue;
+				}
+				for (int partner : cluster.Entrances[self].Partners)
+				{
+					if (partner >= 0)
+					{
+						relax(partner, g + 1.0f, cell);
+					}
+				}
+				for (size_t other = 0; other < count; ++other)
+				{
+					const float distance = cluster.Distances[self * count + other];
+					if (other != self && distance != Internal::PathUnreachable)
+					{
+						relax(cluster.Entrances[other].Cell, g + distance, cell);
+					}
+				}
+			}
+			return best;
+		}
+		#pragma endregion
+	};
+
+	/// <summary>
+	/// Keeps a path planner in sync with buildings: blocks their footprint when they are created and frees it when they die.
+	/// </summary>
+	class PathingObstacleTracker : public SignalObject
+	{
+	public:
+		/// <summary>
+		/// Gives the edge length in cells of the square footprint of a unit, or 0 if the unit does not block pathing.
+		/// </summary>
+		using FootprintFunc = std::function<int(const Unit&)>;
+
+		PathingObstacleTracker(PathPlanner& planner, FootprintFunc footprint)
+			: Planner(planner)
+			, GetFootprint(std::move(footprint))
+		{
+			Unit::SignalUnitCreated().connect(this, &PathingObstacleTracker::OnUnitCreated);
+			Unit::SignalUnitDestroyed().connect(this, &PathingObstacleTracker::OnUnitDestroyed);
+		}
+
+		/// <summary>
+		/// Blocks the footprint of a unit, e.g. for buildings that existed before the tracker was created.
+		/// </summary>
+		void Add(const Unit& unit)
+		{
+			if (Obstacles.count(unit.id) != 0)
+			{
+				return;
+			}
+			const int size = GetFootprint(unit);
+			const Optional<Point> position = unit.GetPosition();
+			if (size <= 0 || !position.hasValue())
+			{
+				return;
+			}
+			//Odd footprints are centered on a cell, even ones on a cell corner
+			const Footprint footprint =
+			{
+				static_cast<int>(std::floor(position.value().X - size * 0.5 + 0.5)),
+				static_cast<int>(std::floor(position.value().Y - size * 0.5 + 0.5)),
+				size
+			};
+			Planner.AddObstacle(footprint.X, footprint.Y, footprint.Size, footprint.Size);
+			Obstacles.emplace(unit.id, footprint);
+		}
+
+		/// <summary>
+		/// Frees the footprint of a unit.
+		/// </summary>
+		void Remove(const Unit& unit)
+		{
+			const auto it = Obstacles.find(unit.id);
+			if (it == Obstacles.end())
+			{
+				return;
+			}
+			Planner.RemoveObstacle(it->second.X, it->second.Y, it->second.Size, it->second.Size);
+			Obstacles.erase(it);
+		}
+
+		#pragma region Implementations
+	private:
+		struct Footprint
+		{
+			int X;
+			int Y;
+			int Size;
+		};
+
+		PathPlanner& Planner;
+		FootprintFunc GetFootprint;
+
+		//Footprints are remembered because a destroyed unit no longer has a position
+		std::unordered_map<HandleId, Footprint> Obstacles;
+
+		void OnUnitCreated(Unit eventUnit, int /*eventPlayerId*/)
+		{
+			Add(eventUnit);
+		}
+
+		void OnUnitDestroyed(Unit eventUnit, Optional<Unit> /*killerUnit*/)
+		{
+			Remove(eventUnit);
+		}
+		#pragma endregion
+	};
+}
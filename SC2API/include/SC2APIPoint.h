@@ -17,6 +17,7 @@ namespace SC2API
 
 		/// <summary>
 		/// Returns distance between two points.
+		/// For one-to-many distances, see the batched kernels in SC2APIPointBatch.h.
 		/// </summary>
 		static double Dist(const Point& pointA, const Point& pointB);
 	};
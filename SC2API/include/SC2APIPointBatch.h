@@ -0,0 +1,239 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIPoint.h"
+#include "SC2APISimd.h"
+#include <algorithm>
+#include <bitset>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Structure-of-arrays batch of points, the input layout of the batched distance kernels.
+	/// Use float for throughput (twice the lanes per instruction) or double to match Point exactly.
+	/// </summary>
+	/// <param name="T">float or double</param>
+	template<typename T>
+	struct PointArray
+	{
+		static_assert(std::is_floating_point<T>::value, "PointArray requires a floating point coordinate type");
+
+		std::vector<T> X;
+		std::vector<T> Y;
+
+		/// <summary>
+		/// Appends a point to the batch.
+		/// </summary>
+		void Add(const Point& point)
+		{
+			X.push_back(static_cast<T>(point.X));
+			Y.push_back(static_cast<T>(point.Y));
+		}
+
+		/// <summary>
+		/// Gets point at given index.
+		/// </summary>
+		Point Get(size_t index) const
+		{
+			return{ static_cast<double>(X[index]), static_cast<double>(Y[index]) };
+		}
+
+		void Reserve(size_t count)
+		{
+			X.reserve(count);
+			Y.reserve(count);
+		}
+
+		void Clear()
+		{
+			X.clear();
+			Y.clear();
+		}
+
+		size_t Count() const
+		{
+			return X.size();
+		}
+	};
+
+	/// <summary>
+	/// Number of 64 bit words needed by InRangeMask for a batch of given size.
+	/// </summary>
+	inline size_t RangeMaskWords(size_t count)
+	{
+		return (count + 63) / 64;
+	}
+
+	#pragma region Kernels
+	namespace Internal
+	{
+		template<typename PackT, typename T>
+		inline PackT DistSquaredPack(PackT originX, PackT originY, const T* xs, const T* ys, size_t i)
+		{
+			const PackT dx = PackT::Load(xs + i) - originX;
+			const PackT dy = PackT::Load(ys + i) - originY;
+			return dx * dx + dy * dy;
+		}
+
+		//Processes [begin, end) in steps of PackT::Width, returns the first index not processed
+		template<typename PackT, typename T, bool TakeSqrt>
+		inline size_t DistLoop(const Point& origin, const T* xs, const T* ys, size_t begin, size_t end, T* out)
+		{
+			const PackT originX = PackT::Broadcast(static_cast<T>(origin.X));
+			const PackT originY = PackT::Broadcast(static_cast<T>(origin.Y));
+			size_t i = begin;
+			for (; i + PackT::Width <= end; i += PackT::Width)
+			{
+				const PackT distSquared = DistSquaredPack(originX, originY, xs, ys, i);
+				(TakeSqrt ? Sqrt(distSquared) : distSquared).Store(out + i);
+			}
+			return i;
+		}
+
+		template<typename PackT, typename T>
+		inline size_t InRangeLoop(const Point& origin, const T* xs, const T* ys, size_t begin, size_t end, T rangeSquared, uint64_t* outMask, size_t& inRange)
+		{
+			const PackT originX = PackT::Broadcast(static_cast<T>(origin.X));
+			const PackT originY = PackT::Broadcast(static_cast<T>(origin.Y));
+			const PackT limit = PackT::Broadcast(rangeSquared);
+			size_t i = begin;
+			for (; i + PackT::Width <= end; i += PackT::Width)
+			{
+				//Width divides 64 and i is a multiple of Width (or the tail), so the lane bits never straddle two words
+				const uint32_t bits = LessEqualMask(DistSquaredPack(originX, originY, xs, ys, i), limit);
+				outMask[i / 64] |= static_cast<uint64_t>(bits) << (i % 64);
+				inRange += std::bitset<32>(bits).count();
+			}
+			return i;
+		}
+
+		template<typename PackT, typename T>
+		inline size_t ArgMinLoop(const Point& origin, const T* xs, const T* ys, size_t begin, size_t end, T& best, size_t& bestIndex)
+		{
+			const PackT originX = PackT::Broadcast(static_cast<T>(origin.X));
+			const PackT originY = PackT::Broadcast(static_cast<T>(origin.Y));
+			size_t i = begin;
+			for (; i + PackT::Width <= end; i += PackT::Width)
+			{
+				const PackT distSquared = DistSquaredPack(originX, originY, xs, ys, i);
+				//Improvements become rare after the first few blocks, so the lane scan is off the hot path
+				if (LessMask(distSquared, PackT::Broadcast(best)) != 0)
+				{
+					T lanes[PackT::Width];
+					distSquared.Store(lanes);
+					for (size_t lane = 0; lane < PackT::Width; ++lane)
+					{
+						if (lanes[lane] < best)
+						{
+							best = lanes[lane];
+							bestIndex = i + lane;
+						}
+					}
+				}
+			}
+			return i;
+		}
+	}
+
+	/// <summary>
+	/// Computes squared distances from origin to each point of the batch.
+	/// Cheaper than DistBatch; compare against squared ranges where possible.
+	/// </summary>
+	/// <param name="origin">The point to measure from</param>
+	/// <param name="xs">X coordinates of the batch</param>
+	/// <param name="ys">Y coordinates of the batch</param>
+	/// <param name="count">Number of points in the batch</param>
+	/// <param name="outDistSquared">Receives count squared distances</param>
+	template<typename T>
+	inline void DistSquaredBatch(const Point& origin, const T* xs, const T* ys, size_t count, T* outDistSquared)
+	{
+		size_t i = Internal::DistLoop<Simd::Pack<T>, T, false>(origin, xs, ys, 0, count, outDistSquared);
+		Internal::DistLoop<Simd::ScalarPack<T>, T, false>(origin, xs, ys, i, count, outDistSquared);
+	}
+
+	/// <summary>
+	/// Computes distances from origin to each point of the batch. Batched equivalent of Point::Dist.
+	/// </summary>
+	/// <param name="origin">The point to measure from</param>
+	/// <param name="xs">X coordinates of the batch</param>
+	/// <param name="ys">Y coordinates of the batch</param>
+	/// <param name="count">Number of points in the batch</param>
+	/// <param name="outDist">Receives count distances</param>
+	template<typename T>
+	inline void DistBatch(const Point& origin, const T* xs, const T* ys, size_t count, T* outDist)
+	{
+		size_t i = Internal::DistLoop<Simd::Pack<T>, T, true>(origin, xs, ys, 0, count, outDist);
+		Internal::DistLoop<Simd::ScalarPack<T>, T, true>(origin, xs, ys, i, count, outDist);
+	}
+
+	/// <summary>
+	/// Marks points of the batch within range of origin (distance less than or equal to range).
+	/// Bit i % 64 of outMask[i / 64] is set for point i; bits past count are cleared.
+	/// </summary>
+	/// <param name="origin">The point to measure from</param>
+	/// <param name="xs">X coordinates of the batch</param>
+	/// <param name="ys">Y coordinates of the batch</param>
+	/// <param name="count">Number of points in the batch</param>
+	/// <param name="range">The range to test</param>
+	/// <param name="outMask">Receives the mask, must hold RangeMaskWords(count) words</param>
+	/// <returns>Number of points in range</returns>
+	template<typename T>
+	inline size_t InRangeMask(const Point& origin, const T* xs, const T* ys, size_t count, T range, uint64_t* outMask)
+	{
+		std::fill(outMask, outMask + RangeMaskWords(count), 0ULL);
+		size_t inRange = 0;
+		size_t i = Internal::InRangeLoop<Simd::Pack<T>, T>(origin, xs, ys, 0, count, range * range, outMask, inRange);
+		Internal::InRangeLoop<Simd::ScalarPack<T>, T>(origin, xs, ys, i, count, range * range, outMask, inRange);
+		return inRange;
+	}
+
+	/// <summary>
+	/// Finds the point of the batch nearest to origin. Ties resolve to the lowest index.
+	/// Points whose distance is NaN or infinite never win; if all are like that, the first point is returned.
+	/// </summary>
+	/// <param name="origin">The point to measure from</param>
+	/// <param name="xs">X coordinates of the batch</param>
+	/// <param name="ys">Y coordinates of the batch</param>
+	/// <param name="count">Number of points in the batch</param>
+	/// <returns>Index of the nearest point, or empty value if the batch is empty</returns>
+	template<typename T>
+	inline Optional<size_t> ArgMinDist(const Point& origin, const T* xs, const T* ys, size_t count)
+	{
+		T best = std::numeric_limits<T>::infinity();
+		size_t bestIndex = count;
+		size_t i = Internal::ArgMinLoop<Simd::Pack<T>, T>(origin, xs, ys, 0, count, best, bestIndex);
+		Internal::ArgMinLoop<Simd::ScalarPack<T>, T>(origin, xs, ys, i, count, best, bestIndex);
+		if (count == 0)
+		{
+			return{};
+		}
+		return bestIndex != count ? bestIndex : 0;
+	}
+
+	template<typename T>
+	inline void DistSquaredBatch(const Point& origin, const PointArray<T>& points, T* outDistSquared)
+	{
+		DistSquaredBatch(origin, points.X.data(), points.Y.data(), points.Count(), outDistSquared);
+	}
+
+	template<typename T>
+	inline void DistBatch(const Point& origin, const PointArray<T>& points, T* outDist)
+	{
+		DistBatch(origin, points.X.data(), points.Y.data(), points.Count(), outDist);
+	}
+
+	template<typename T>
+	inline size_t InRangeMask(const Point& origin, const PointArray<T>& points, T range, uint64_t* outMask)
+	{
+		return InRangeMask(origin, points.X.data(), points.Y.data(), points.Count(), range, outMask);
+	}
+
+	template<typename T>
+	inline Optional<size_t> ArgMinDist(const Point& origin, const PointArray<T>& points)
+	{
+		return ArgMinDist(origin, points.X.data(), points.Y.data(), points.Count());
+	}
+	#pragma endregion
+}
@@ -0,0 +1,591 @@
+#pragma once
+#include "SC2API.h"
+
+//Profiling is compiled in with SC2API_PROFILING defined; otherwise the macros below expand to nothing.
+//Timing every slot of every signal additionally needs ZYCORE_SIGNAL_PROFILING, defined the same for all sources.
+#if defined(SC2API_PROFILING)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define SC2API_PROFILING_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SC2API_PROFILING_RDTSC 1
+#endif
+
+namespace SC2API
+{
+	/// <summary>
+	/// Timing of one zone over one frame. Times are in milliseconds and include nested zones.
+	/// </summary>
+	struct ProfileZoneStats
+	{
+		std::string Name;
+		uint32_t Count = 0;
+		double Total = 0.0;
+		double P50 = 0.0;
+		double P99 = 0.0;
+		double Max = 0.0;
+	};
+
+	/// <summary>
+	/// Summary of one frame, see Profiler::EndFrame.
+	/// </summary>
+	struct ProfileFrame
+	{
+		uint64_t Index = 0;
+
+		/// <summary>
+		/// Milliseconds since the previous frame ended.
+		/// </summary>
+		double Duration = 0.0;
+
+		/// <summary>
+		/// Events lost because a thread filled its buffer; zones they belong to are missing from the frame.
+		/// </summary>
+		uint64_t DroppedEvents = 0;
+
+		/// <summary>
+		/// Zones that ended during the frame, most expensive first.
+		/// </summary>
+		std::vector<ProfileZoneStats> Zones;
+	};
+
+	/// <summary>
+	/// One zone or mark on the timeline, see ProfileTraceSink. Times are in microseconds since the profiler started.
+	/// </summary>
+	struct ProfileTraceEvent
+	{
+		enum EventType : uint8_t
+		{
+			Complete,
+			Instant,
+		};
+
+		double Start;
+		double Duration;
+		uint32_t Zone;
+
+		/// <summary>
+		/// Index of the recording thread, counting from 1 in order of first use; 0 is the frame track.
+		/// </summary>
+		uint32_t Thread;
+
+		EventType Type;
+	};
+
+	/// <summary>
+	/// Receives the timeline of the profiler, e.g. to write a trace file. Called by EndFrame under the profiler lock,
+	/// so implementations should hand the events off rather than process them in place.
+	/// </summary>
+	class ProfileTraceSink
+	{
+	public:
+		virtual ~ProfileTraceSink() = default;
+
+		/// <summary>
+		/// Called for every zone before its first event, and for all known zones when the sink is set.
+		/// </summary>
+		virtual void OnZoneNamed(uint32_t zone, const std::string& name) = 0;
+
+		/// <summary>
+		/// Called once per frame with the events that ended during the frame, in no particular order.
+		/// </summary>
+		virtual void OnFrame(std::vector<ProfileTraceEvent>&& events) = 0;
+	};
+
+	/// <summary>
+	/// Low-overhead frame profiler. Zones are marked with SC2API_PROFILE_ZONE; with ZYCORE_SIGNAL_PROFILING every slot
+	/// called by a signal is a zone of its own. Recording a zone boundary reads the time stamp counter and appends to a
+	/// ring buffer owned by the calling thread, without locks. EndFrame collects all buffers and summarizes the frame.
+	/// Only slots of signals emitted by code compiled with ZYCORE_SIGNAL_PROFILING are timed.
+	/// </summary>
+	class Profiler
+#if defined(ZYCORE_SIGNAL_PROFILING)
+		: public zycore::SlotProfiler
+#endif
+	{
+	public:
+		static Profiler& Get()
+		{
+			static Profiler profiler;
+			return profiler;
+		}
+
+		/// <summary>
+		/// Registers a named zone. Done once per SC2API_PROFILE_ZONE.
+		/// </summary>
+		/// <returns>Id of the zone for Begin and End</returns>
+		uint32_t RegisterZone(const char* name)
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			return AddZone(name);
+		}
+
+		/// <summary>
+		/// Names a signal so its slots show up as "name #handle" instead of "Signal #handle", which all unnamed signals
+		/// share. Slots are zones by name, so short-lived signals such as one-shot timers do not add zones.
+		/// Unname a signal before it dies, or its address passes the name on to the next signal allocated there.
+		/// </summary>
+		void NameSignal(const void* signal, const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			SignalNames[signal] = name;
+			SlotZones.clear();
+		}
+
+		void UnnameSignal(const void* signal)
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			SignalNames.erase(signal);
+			SlotZones.clear();
+		}
+
+		void Begin(uint32_t zone)
+		{
+			Record(ZoneBegin, nullptr, zone);
+		}
+
+		void End(uint32_t zone)
+		{
+			Record(ZoneEnd, nullptr, zone);
+		}
+
+		/// <summary>
+		/// Marks a point in time, e.g. an order submission. Marks only show up on the trace timeline.
+		/// </summary>
+		void Mark(uint32_t zone)
+		{
+			Record(ZoneMark, nullptr, zone);
+		}
+
+		/// <summary>
+		/// Sets the sink receiving the timeline of every frame, or nullptr to stop. The sink must outlive its use.
+		/// </summary>
+		void SetTraceSink(ProfileTraceSink* sink)
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			TraceSink = sink;
+			TraceEvents.clear();
+			if (TraceSink != nullptr)
+			{
+				for (size_t zone = 0; zone < ZoneNames.size(); ++zone)
+				{
+					TraceSink->OnZoneNamed(static_cast<uint32_t>(zone), ZoneNames[zone]);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Ends the current frame: collects the zones recorded by all threads and summarizes them into the last frame.
+		/// Zones still open carry over to the frame they end in. Call once per game tick, from one thread.
+		/// </summary>
+		void EndFrame()
+		{
+			const uint64_t now = Now();
+			std::lock_guard<std::mutex> lock(Mutex);
+			Calibrate(now);
+			for (std::vector<uint64_t>& samples : Samples)
+			{
+				samples.clear();
+			}
+			uint64_t dropped = 0;
+			for (size_t i = 0; i < Rings.size();)
+			{
+				Ring& ring = *Rings[i];
+				//Checked first: everything the thread recorded before exiting is visible to the drain below
+				const bool retired = ring.Retired.load(std::memory_order_acquire);
+				Drain(ring);
+				dropped += ring.Dropped.exchange(0, std::memory_order_relaxed);
+				if (retired)
+				{
+					Rings[i] = std::move(Rings.back());
+					Rings.pop_back();
+				}
+				else
+				{
+					++i;
+				}
+			}
+			SlotZones.clear();
+
+			if (TraceSink != nullptr)
+			{
+				if (FrameZone == NoZone)
+				{
+					FrameZone = AddZone("Frame");
+				}
+				TraceEvents.push_back(ProfileTraceEvent{ ToMicroseconds(FrameStart), ToMicroseconds(now) - ToMicroseconds(FrameStart), FrameZone, 0, ProfileTraceEvent::Complete });
+				TraceSink->OnFrame(std::move(TraceEvents));
+				TraceEvents.clear();
+			}
+
+			LastFrame.Index = FrameIndex++;
+			LastFrame.Duration = ToMilliseconds(now - FrameStart);
+			LastFrame.DroppedEvents = dropped;
+			LastFrame.Zones.clear();
+			FrameStart = now;
+			for (size_t zone = 0; zone < Samples.size(); ++zone)
+			{
+				std::vector<uint64_t>& samples = Samples[zone];
+				if (samples.empty())
+				{
+					continue;
+				}
+				ProfileZoneStats stats;
+				stats.Name = ZoneNames[zone];
+				stats.Count = static_cast<uint32_t>(samples.size());
+				uint64_t total = 0;
+				for (const uint64_t sample : samples)
+				{
+					total += sample;
+				}
+				stats.Total = ToMilliseconds(total);
+				stats.P50 = ToMilliseconds(Percentile(samples, 0.50));
+				stats.P99 = ToMilliseconds(Percentile(samples, 0.99));
+				stats.Max = ToMilliseconds(*std::max_element(samples.begin(), samples.end()));
+				LastFrame.Zones.push_back(std::move(stats));
+			}
+			std::sort(LastFrame.Zones.begin(), LastFrame.Zones.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b)
+			{
+				return a.Total > b.Total;
+			});
+		}
+
+		/// <summary>
+		/// Gets the summary of the last ended frame. Valid until the next EndFrame.
+		/// </summary>
+		const ProfileFrame& GetLastFrame() const
+		{
+			return LastFrame;
+		}
+
+#if defined(ZYCORE_SIGNAL_PROFILING)
+		void onSlotBegin(const zycore::internal::SignalBase* signal, zycore::SlotHandle handle) override
+		{
+			Record(SlotBegin, signal, static_cast<uint32_t>(handle));
+		}
+
+		void onSlotEnd(const zycore::internal::SignalBase* signal, zycore::SlotHandle handle) override
+		{
+			Record(SlotEnd, signal, static_cast<uint32_t>(handle));
+		}
+#endif
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		#pragma region Implementations
+	private:
+		enum : uint32_t
+		{
+			//Events per thread between two frames, a power of two
+			RingSize = 1 << 14,
+		};
+
+		enum : uint32_t
+		{
+			NoZone = ~0u,
+		};
+
+		enum EventKind : uint32_t
+		{
+			ZoneBegin,
+			ZoneEnd,
+			SlotBegin,
+			SlotEnd,
+			ZoneMark,
+		};
+
+		struct Event
+		{
+			uint64_t Time;
+			const void* Signal;
+			uint32_t Id;
+			uint32_t Kind;
+		};
+
+		//Written by its thread only, read by EndFrame
+		struct Ring
+		{
+			std::vector<Event> Events = std::vector<Event>(RingSize);
+			std::atomic<uint32_t> Head{ 0 };
+			std::atomic<uint32_t> Tail{ 0 };
+			std::atomic<uint64_t> Dropped{ 0 };
+			std::atomic<bool> Retired{ false };
+			uint32_t Thread = 0;
+
+			//Begin events waiting for their end, used by EndFrame only
+			std::vector<Event> Open;
+		};
+
+		//Keeps the ring alive until EndFrame drained it, even after the thread exited
+		struct RingOwner
+		{
+			std::shared_ptr<Ring> Owned;
+
+			~RingOwner()
+			{
+				if (Owned)
+				{
+					Owned->Retired.store(true, std::memory_order_release);
+				}
+			}
+		};
+
+		std::mutex Mutex;
+		std::vector<std::shared_ptr<Ring>> Rings;
+		std::vector<std::string> ZoneNames;
+		std::vector<std::vector<uint64_t>> Samples;
+		std::unordered_map<std::string, uint32_t> SlotZonesByName;
+
+		//Zones of the slots drained since the last frame, cleared every frame and whenever the signal names change
+		std::map<std::pair<const void*, uint32_t>, uint32_t> SlotZones;
+		std::unordered_map<const void*, std::string> SignalNames;
+		ProfileTraceSink* TraceSink = nullptr;
+		std::vector<ProfileTraceEvent> TraceEvents;
+		uint32_t ThreadCount = 0;
+		uint32_t FrameZone = NoZone;
+		ProfileFrame LastFrame;
+		uint64_t FrameIndex = 0;
+		uint64_t FrameStart;
+		uint64_t CalibrationTicks;
+		std::chrono::steady_clock::time_point CalibrationClock;
+		double TicksPerMillisecond = 1.0;
+
+		Profiler()
+		{
+			//Rough rate of the counter to start with, refined every frame
+			CalibrationClock = std::chrono::steady_clock::now();
+			CalibrationTicks = Now();
+			while (std::chrono::steady_clock::now() - CalibrationClock < std::chrono::milliseconds(1))
+			{
+			}
+			Calibrate(Now());
+			FrameStart = Now();
+#if defined(ZYCORE_SIGNAL_PROFILING)
+			zycore::slotProfiler() = this;
+#endif
+		}
+
+#if defined(ZYCORE_SIGNAL_PROFILING)
+		~Profiler()
+		{
+			if (zycore::slotProfiler() == this)
+			{
+				zycore::slotProfiler() = nullptr;
+			}
+		}
+#endif
+
+		static uint64_t Now()
+		{
+#if defined(SC2API_PROFILING_RDTSC)
+			return __rdtsc();
+#else
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+		}
+
+		void Calibrate(uint64_t now)
+		{
+			const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - CalibrationClock).count();
+			if (elapsed > 0.0 && now > CalibrationTicks)
+			{
+				TicksPerMillisecond = (now - CalibrationTicks) / elapsed;
+			}
+		}
+
+		double ToMilliseconds(uint64_t ticks) const
+		{
+			return ticks / TicksPerMillisecond;
+		}
+
+		double ToMicroseconds(uint64_t time) const
+		{
+			return ToMilliseconds(time - CalibrationTicks) * 1000.0;
+		}
+
+		uint32_t AddZone(std::string name)
+		{
+			ZoneNames.push_back(std::move(name));
+			const uint32_t zone = static_cast<uint32_t>(ZoneNames.size() - 1);
+			if (TraceSink != nullptr)
+			{
+				TraceSink->OnZoneNamed(zone, ZoneNames[zone]);
+			}
+			return zone;
+		}
+
+		//Nearest-rank percentile, reorders the samples
+		static uint64_t Percentile(std::vector<uint64_t>& samples, double fraction)
+		{
+			const size_t rank = static_cast<size_t>(std::ceil(fraction * samples.size()));
+			const auto nth = samples.begin() + (rank > 0 ? rank - 1 : 0);
+			std::nth_element(samples.begin(), nth, samples.end());
+			return *nth;
+		}
+
+		Ring& GetThreadRing()
+		{
+			thread_local RingOwner owner;
+			if (!owner.Owned)
+			{
+				owner.Owned = std::make_shared<Ring>();
+				std::lock_guard<std::mutex> lock(Mutex);
+				owner.Owned->Thread = ++ThreadCount;
+				Rings.push_back(owner.Owned);
+			}
+			return *owner.Owned;
+		}
+
+		void Record(uint32_t kind, const void* signal, uint32_t id)
+		{
+			Ring& ring = GetThreadRing();
+			const uint32_t head = ring.Head.load(std::memory_order_relaxed);
+			if (head - ring.Tail.load(std::memory_order_acquire) >= RingSize)
+			{
+				ring.Dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			ring.Events[head & (RingSize - 1)] = Event{ Now(), signal, id, kind };
+			ring.Head.store(head + 1, std::memory_order_release);
+		}
+
+		void Drain(Ring& ring)
+		{
+			const uint32_t head = ring.Head.load(std::memory_order_acquire);
+			for (uint32_t i = ring.Tail.load(std::memory_order_relaxed); i != head; ++i)
+			{
+				const Event& event = ring.Events[i & (RingSize - 1)];
+				if (event.Kind == ZoneBegin || event.Kind == SlotBegin)
+				{
+					ring.Open.push_back(event);
+					continue;
+				}
+				if (event.Kind == ZoneMark)
+				{
+					if (TraceSink != nullptr)
+					{
+						TraceEvents.push_back(ProfileTraceEvent{ ToMicroseconds(event.Time), 0.0, event.Id, ring.Thread, ProfileTraceEvent::Instant });
+					}
+					continue;
+				}
+				//Match the innermost open zone; a lost begin or end only drops the zones it breaks
+				for (size_t open = ring.Open.size(); open-- > 0;)
+				{
+					const Event& begin = ring.Open[open];
+					if (begin.Kind + 1 == event.Kind && begin.Id == event.Id && begin.Signal == event.Signal)
+					{
+						const uint32_t zone = event.Kind == ZoneEnd ? event.Id : GetSlotZone(event.Signal, event.Id);
+						AddSample(zone, event.Time - begin.Time);
+						if (TraceSink != nullptr)
+						{
+							TraceEvents.push_back(ProfileTraceEvent{ ToMicroseconds(begin.Time), ToMilliseconds(event.Time - begin.Time) * 1000.0, zone, ring.Thread, ProfileTraceEvent::Complete });
+						}
+						ring.Open.resize(open);
+						break;
+					}
+				}
+			}
+			ring.Tail.store(head, std::memory_order_release);
+		}
+
+		uint32_t GetSlotZone(const void* signal, uint32_t handle)
+		{
+			const auto key = std::make_pair(signal, handle);
+			const auto it = SlotZones.find(key);
+			if (it != SlotZones.end())
+			{
+				return it->second;
+			}
+			const auto signalName = SignalNames.find(signal);
+			const std::string name = (signalName != SignalNames.end() ? signalName->second : std::string("Signal")) + " #" + std::to_string(handle);
+			auto zone = SlotZonesByName.find(name);
+			if (zone == SlotZonesByName.end())
+			{
+				zone = SlotZonesByName.emplace(name, AddZone(name)).first;
+			}
+			SlotZones.emplace(key, zone->second);
+			return zone->second;
+		}
+
+		void AddSample(uint32_t zone, uint64_t ticks)
+		{
+			if (Samples.size() <= zone)
+			{
+				Samples.resize(ZoneNames.size());
+			}
+			Samples[zone].push_back(ticks);
+		}
+		#pragma endregion
+	};
+
+	/// <summary>
+	/// Times a zone from construction to destruction, see SC2API_PROFILE_ZONE.
+	/// </summary>
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(uint32_t zone)
+			: Zone(zone)
+		{
+			Profiler::Get().Begin(zone);
+		}
+
+		~ProfileScope()
+		{
+			Profiler::Get().End(Zone);
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		uint32_t Zone;
+	};
+}
+
+#define SC2API_PROFILE_CONCAT_INNER(a, b) a##b
+#define SC2API_PROFILE_CONCAT(a, b) SC2API_PROFILE_CONCAT_INNER(a, b)
+
+//Times the rest of the enclosing scope as a zone with the given name (a string literal)
+#define SC2API_PROFILE_ZONE(name)																							\
+	static const uint32_t SC2API_PROFILE_CONCAT(profileZone, __LINE__) = SC2API::Profiler::Get().RegisterZone(name);		\
+	const SC2API::ProfileScope SC2API_PROFILE_CONCAT(profileScope, __LINE__)(SC2API_PROFILE_CONCAT(profileZone, __LINE__))
+
+//Times the rest of the enclosing function as a zone named after it
+#define SC2API_PROFILE_FUNCTION() SC2API_PROFILE_ZONE(__FUNCTION__)
+
+//Marks the current time with the given name (a string literal), see Profiler::Mark
+#define SC2API_PROFILE_MARK(name)																							\
+do																															\
+{																															\
+	static const uint32_t profileMarkZone = SC2API::Profiler::Get().RegisterZone(name);										\
+	SC2API::Profiler::Get().Mark(profileMarkZone);																			\
+} while (0)
+
+//Ends the profiler frame, see Profiler::EndFrame
+#define SC2API_PROFILE_END_FRAME() SC2API::Profiler::Get().EndFrame()
+
+#else
+
+#define SC2API_PROFILE_ZONE(name)
+#define SC2API_PROFILE_FUNCTION()
+#define SC2API_PROFILE_MARK(name) do {} while (0)
+#define SC2API_PROFILE_END_FRAME() do {} while (0)
+
+#endif
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+//Instruction set selection. AVX2 and SSE2 are picked up from the compiler switches (/arch:AVX2, /arch:SSE2, -mavx2...).
+//Define SC2API_SIMD_DISABLE to force the scalar fallback, e.g. to compare results against the vector paths.
+#if !defined(SC2API_SIMD_DISABLE)
+	#if defined(__AVX2__)
+		#define SC2API_SIMD_AVX2 1
+	#endif
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define SC2API_SIMD_SSE2 1
+	#endif
+#endif
+
+#if defined(SC2API_SIMD_AVX2)
+	#include <immintrin.h>
+#elif defined(SC2API_SIMD_SSE2)
+	#include <emmintrin.h>
+#endif
+
+namespace SC2API
+{
+	namespace Simd
+	{
+		/// <summary>
+		/// Single lane pack. Used as the fallback when no vector instruction set is enabled, and for loop tails.
+		/// </summary>
+		template<typename T>
+		struct ScalarPack
+		{
+			static constexpr size_t Width = 1;
+			T V;
+
+			static ScalarPack Load(const T* p) { return{ *p }; }
+			static ScalarPack Broadcast(T t) { return{ t }; }
+			void Store(T* p) const { *p = V; }
+
+			friend ScalarPack operator+(ScalarPack a, ScalarPack b) { return{ a.V + b.V }; }
+			friend ScalarPack operator-(ScalarPack a, ScalarPack b) { return{ a.V - b.V }; }
+			friend ScalarPack operator*(ScalarPack a, ScalarPack b) { return{ a.V * b.V }; }
+			friend ScalarPack Min(ScalarPack a, ScalarPack b) { return{ b.V < a.V ? b.V : a.V }; }
+			friend ScalarPack Max(ScalarPack a, ScalarPack b) { return{ a.V < b.V ? b.V : a.V }; }
+			friend ScalarPack Sqrt(ScalarPack a) { return{ std::sqrt(a.V) }; }
+			friend uint32_t LessEqualMask(ScalarPack a, ScalarPack b) { return a.V <= b.V ? 1u : 0u; }
+			friend uint32_t LessMask(ScalarPack a, ScalarPack b) { return a.V < b.V ? 1u : 0u; }
+		};
+
+		template<typename T>
+		struct PackSelector
+		{
+			using Type = ScalarPack<T>;
+		};
+
+#if defined(SC2API_SIMD_AVX2)
+		struct PackFloat8
+		{
+			static constexpr size_t Width = 8;
+			__m256 V;
+
+			static PackFloat8 Load(const float* p) { return{ _mm256_loadu_ps(p) }; }
+			static PackFloat8 Broadcast(float f) { return{ _mm256_set1_ps(f) }; }
+			void Store(float* p) const { _mm256_storeu_ps(p, V); }
+
+			friend PackFloat8 operator+(PackFloat8 a, PackFloat8 b) { return{ _mm256_add_ps(a.V, b.V) }; }
+			friend PackFloat8 operator-(PackFloat8 a, PackFloat8 b) { return{ _mm256_sub_ps(a.V, b.V) }; }
+			friend PackFloat8 operator*(PackFloat8 a, PackFloat8 b) { return{ _mm256_mul_ps(a.V, b.V) }; }
+			friend PackFloat8 Min(PackFloat8 a, PackFloat8 b) { return{ _mm256_min_ps(a.V, b.V) }; }
+			friend PackFloat8 Max(PackFloat8 a, PackFloat8 b) { return{ _mm256_max_ps(a.V, b.V) }; }
+			friend PackFloat8 Sqrt(PackFloat8 a) { return{ _mm256_sqrt_ps(a.V) }; }
+			friend uint32_t LessEqualMask(PackFloat8 a, PackFloat8 b) { return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a.V, b.V, _CMP_LE_OQ)); }
+			friend uint32_t LessMask(PackFloat8 a, PackFloat8 b) { return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a.V, b.V, _CMP_LT_OQ)); }
+		};
+
+		template<>
+		struct PackSelector<float>
+		{
+			using Type = PackFloat8;
+		};
+
+		struct PackDouble4
+		{
+			static constexpr size_t Width = 4;
+			__m256d V;
+
+			static PackDouble4 Load(const double* p) { return{ _mm256_loadu_pd(p) }; }
+			static PackDouble4 Broadcast(double d) { return{ _mm256_set1_pd(d) }; }
+			void Store(double* p) const { _mm256_storeu_pd(p, V); }
+
+			friend PackDouble4 operator+(PackDouble4 a, PackDouble4 b) { return{ _mm256_add_pd(a.V, b.V) }; }
+			friend PackDouble4 operator-(PackDouble4 a, PackDouble4 b) { return{ _mm256_sub_pd(a.V, b.V) }; }
+			friend PackDouble4 operator*(PackDouble4 a, PackDouble4 b) { return{ _mm256_mul_pd(a.V, b.V) }; }
+			friend PackDouble4 Min(PackDouble4 a, PackDouble4 b) { return{ _mm256_min_pd(a.V, b.V) }; }
+			friend PackDouble4 Max(PackDouble4 a, PackDouble4 b) { return{ _mm256_max_pd(a.V, b.V) }; }
+			friend PackDouble4 Sqrt(PackDouble4 a) { return{ _mm256_sqrt_pd(a.V) }; }
+			friend uint32_t LessEqualMask(PackDouble4 a, PackDouble4 b) { return (uint32_t)_mm256_movemask_pd(_mm256_cmp_pd(a.V, b.V, _CMP_LE_OQ)); }
+			friend uint32_t LessMask(PackDouble4 a, PackDouble4 b) { return (uint32_t)_mm256_movemask_pd(_mm256_cmp_pd(a.V, b.V, _CMP_LT_OQ)); }
+		};
+
+		template<>
+		struct PackSelector<double>
+		{
+			using Type = PackDouble4;
+		};
+#elif defined(SC2API_SIMD_SSE2)
+		struct PackFloat4
+		{
+			static constexpr size_t Width = 4;
+			__m128 V;
+
+			static PackFloat4 Load(const float* p) { return{ _mm_loadu_ps(p) }; }
+			static PackFloat4 Broadcast(float f) { return{ _mm_set1_ps(f) }; }
+			void Store(float* p) const { _mm_storeu_ps(p, V); }
+
+			friend PackFloat4 operator+(PackFloat4 a, PackFloat4 b) { return{ _mm_add_ps(a.V, b.V) }; }
+			friend PackFloat4 operator-(PackFloat4 a, PackFloat4 b) { return{ _mm_sub_ps(a.V, b.V) }; }
+			friend PackFloat4 operator*(PackFloat4 a, PackFloat4 b) { return{ _mm_mul_ps(a.V, b.V) }; }
+			friend PackFloat4 Min(PackFloat4 a, PackFloat4 b) { return{ _mm_min_ps(a.V, b.V) }; }
+			friend PackFloat4 Max(PackFloat4 a, PackFloat4 b) { return{ _mm_max_ps(a.V, b.V) }; }
+			friend PackFloat4 Sqrt(PackFloat4 a) { return{ _mm_sqrt_ps(a.V) }; }
+			friend uint32_t LessEqualMask(PackFloat4 a, PackFloat4 b) { return (uint32_t)_mm_movemask_ps(_mm_cmple_ps(a.V, b.V)); }
+			friend uint32_t LessMask(PackFloat4 a, PackFloat4 b) { return (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(a.V, b.V)); }
+		};
+
+		template<>
+		struct PackSelector<float>
+		{
+			using Type = PackFloat4;
+		};
+
+		struct PackDouble2
+		{
+			static constexpr size_t Width = 2;
+			__m128d V;
+
+			static PackDouble2 Load(const double* p) { return{ _mm_loadu_pd(p) }; }
+			static PackDouble2 Broadcast(double d) { return{ _mm_set1_pd(d) }; }
+			void Store(double* p) const { _mm_storeu_pd(p, V); }
+
+			friend PackDouble2 operator+(PackDouble2 a, PackDouble2 b) { return{ _mm_add_pd(a.V, b.V) }; }
+			friend PackDouble2 operator-(PackDouble2 a, PackDouble2 b) { return{ _mm_sub_pd(a.V, b.V) }; }
+			friend PackDouble2 operator*(PackDouble2 a, PackDouble2 b) { return{ _mm_mul_pd(a.V, b.V) }; }
+			friend PackDouble2 Min(PackDouble2 a, PackDouble2 b) { return{ _mm_min_pd(a.V, b.V) }; }
+			friend PackDouble2 Max(PackDouble2 a, PackDouble2 b) { return{ _mm_max_pd(a.V, b.V) }; }
+			friend PackDouble2 Sqrt(PackDouble2 a) { return{ _mm_sqrt_pd(a.V) }; }
+			friend uint32_t LessEqualMask(PackDouble2 a, PackDouble2 b) { return (uint32_t)_mm_movemask_pd(_mm_cmple_pd(a.V, b.V)); }
+			friend uint32_t LessMask(PackDouble2 a, PackDouble2 b) { return (uint32_t)_mm_movemask_pd(_mm_cmplt_pd(a.V, b.V)); }
+		};
+
+		template<>
+		struct PackSelector<double>
+		{
+			using Type = PackDouble2;
+		};
+#endif
+
+		/// <summary>
+		/// Fixed width pack of T lanes mapped to the widest instruction set enabled at compile time.
+		/// Kernels written against Pack work unchanged on AVX2, SSE2 and the scalar fallback (Width = 1).
+		/// All loads and stores are unaligned. Comparison masks hold one bit per lane, lane 0 in bit 0.
+		/// </summary>
+		template<typename T>
+		using Pack = typename PackSelector<T>::Type;
+	}
+}
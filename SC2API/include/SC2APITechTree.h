@@ -0,0 +1,405 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIUnitGroup.h"
+#include "SC2APIPlayer.h"
+#include "SC2APIUnitStats.h"
+#include "SC2APICallCounters.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Set of unit types as a bitmask, one bit per UnitTypeId.
+	/// </summary>
+	class TechSet
+	{
+	public:
+		void Set(UnitTypeId type)
+		{
+			Words[Word(type)] |= Bit(type);
+		}
+
+		void Reset(UnitTypeId type)
+		{
+			Words[Word(type)] &= ~Bit(type);
+		}
+
+		bool Test(UnitTypeId type) const
+		{
+			return (Words[Word(type)] & Bit(type)) != 0;
+		}
+
+		/// <summary>
+		/// Whether every type of the other set is in this set.
+		/// </summary>
+		bool Contains(const TechSet& other) const
+		{
+			uint64_t missing = 0;
+			for (size_t i = 0; i < WordCount; ++i)
+			{
+				missing |= other.Words[i] & ~Words[i];
+			}
+			return missing == 0;
+		}
+
+		bool IsEmpty() const
+		{
+			uint64_t any = 0;
+			for (size_t i = 0; i < WordCount; ++i)
+			{
+				any |= Words[i];
+			}
+			return any == 0;
+		}
+
+		TechSet& operator|=(const TechSet& other)
+		{
+			for (size_t i = 0; i < WordCount; ++i)
+			{
+				Words[i] |= other.Words[i];
+			}
+			return *this;
+		}
+
+		#pragma region Implementations
+	private:
+		enum : size_t
+		{
+			WordCount = (static_cast<size_t>(UnitTypeId::Count) + 63) / 64,
+		};
+
+		std::array<uint64_t, WordCount> Words = {};
+
+		static size_t Word(UnitTypeId type)
+		{
+			return static_cast<size_t>(type) / 64;
+		}
+
+		static uint64_t Bit(UnitTypeId type)
+		{
+			return 1ULL << (static_cast<size_t>(type) % 64);
+		}
+		#pragma endregion
+	};
+
+	/// <summary>
+	/// Tech of the local player, maintained from unit events, with constant-time requirement checks.
+	/// The dependency graph comes from the unit stats table: a type requires its producer, its required structure and
+	/// the add-on its producer must carry. Morphed structures count as their base (a Lair is a Hatchery) and units
+	/// trained from larvae require a Hatchery.
+	/// Structures count once construction completes and morphs in place fire no event; Update() detects both.
+	/// </summary>
+	class TechTree : public SignalObject
+	{
+	public:
+		/// <summary>
+		/// Takes the current tech of the local player and starts tracking it.
+		/// </summary>
+		TechTree()
+		{
+			Unit::SignalUnitCreated().connect(this, &TechTree::OnUnitCreated);
+			Unit::SignalUnitDestroyed().connect(this, &TechTree::OnUnitDestroyed);
+			Refresh();
+		}
+
+		/// <summary>
+		/// Gets the types a type requires, see the class summary.
+		/// </summary>
+		static const TechSet& GetRequirements(UnitTypeId type)
+		{
+			return GetGraph().Requirements[static_cast<size_t>(type)];
+		}
+
+		/// <summary>
+		/// Gets the types owning a unit of the type provides: the type itself and the bases it morphed from.
+		/// </summary>
+		static const TechSet& GetProvides(UnitTypeId type)
+		{
+			return GetGraph().Provides[static_cast<size_t>(type)];
+		}
+
+		/// <summary>
+		/// Gets the missing prerequisites of a type, including indirect ones, in an order they can be built in.
+		/// </summary>
+		/// <param name="type">The wanted type</param>
+		/// <param name="outMissing">Receives the missing types, cleared first</param>
+		void GetMissing(UnitTypeId type, std::vector<UnitTypeId>& outMissing) const
+		{
+			outMissing.clear();
+			TechSet visited;
+			CollectMissing(type, visited, outMissing);
+		}
+
+		/// <summary>
+		/// Whether all requirements of a type are owned. Resources, supply and idle producers are not checked.
+		/// </summary>
+		bool CanBuild(UnitTypeId type) const
+		{
+			return Owned.Contains(GetRequirements(type));
+		}
+
+		/// <summary>
+		/// Whether a completed unit of the type, or of a type morphed from it, is owned.
+		/// </summary>
+		bool Has(UnitTypeId type) const
+		{
+			return Owned.Test(type);
+		}
+
+		/// <summary>
+		/// Number of completed units of the type, not counting types morphed from it.
+		/// </summary>
+		int GetCount(UnitTypeId type) const
+		{
+			return Counts[static_cast<size_t>(type)];
+		}
+
+		/// <summary>
+		/// Gets the set of owned types.
+		/// </summary>
+		const TechSet& GetOwned() const
+		{
+			return Owned;
+		}
+
+		/// <summary>
+		/// Counts structures that finished construction or morphed in place since the last call. Costs one unit query
+		/// while anything is under construction plus one type query per structure that can still morph, e.g. each
+		/// Hatchery, Lair and Gateway; call once per game tick.
+		/// </summary>
+		void Update()
+		{
+			UpdateMorphs();
+			if (Unfinished.empty())
+			{
+				return;
+			}
+			const UnitGroup underConstruction = SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self | UnitFilterFlag::UnderConstruction));
+			for (size_t i = 0; i < Unfinished.size();)
+			{
+				if (SC2API_COUNT_CALL(UnitGroupHas, underConstruction.Has(Unfinished[i])))
+				{
+					++i;
+					continue;
+				}
+				const auto it = Tracked.find(Unfinished[i].id);
+				if (it != Tracked.end())
+				{
+					it->second.Completed = true;
+					AddCount(it->second.Type, 1);
+					TrackMorphable(Unfinished[i], it->second.Type);
+				}
+				Unfinished[i] = Unfinished.back();
+				Unfinished.pop_back();
+			}
+		}
+
+		/// <summary>
+		/// Rebuilds the tech from the units of the local player.
+		/// </summary>
+		void Refresh()
+		{
+			Counts.fill(0);
+			Owned = TechSet();
+			Tracked.clear();
+			Unfinished.clear();
+			Morphable.clear();
+			const UnitGroup underConstruction = SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self | UnitFilterFlag::UnderConstruction));
+			for (const Unit& unit : SC2API_COUNT_CALL(UnitGroupGetAccessibleUnits, UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self)))
+			{
+				Track(unit, !SC2API_COUNT_CALL(UnitGroupHas, underConstruction.Has(unit)));
+			}
+		}
+
+		#pragma region Implementations
+	private:
+		struct Graph
+		{
+			std::vector<TechSet> Requirements;
+			std::vector<TechSet> Provides;
+
+			//Types that morph in place into another type, e.g. Hatchery and Lair
+			TechSet MorphSources;
+		};
+
+		struct TrackedUnit
+		{
+			UnitTypeId Type;
+			bool Completed;
+		};
+
+		std::array<uint16_t, static_cast<size_t>(UnitTypeId::Count)> Counts = {};
+		TechSet Owned;
+		std::unordered_map<HandleId, TrackedUnit> Tracked;
+		std::vector<Unit> Unfinished;
+
+		//Completed units of a type in Graph::MorphSources, whose type Update() checks
+		std::vector<Unit> Morphable;
+
+		static const Graph& GetGraph()
+		{
+			static const Graph graph = []()
+			{
+				Graph result;
+				result.Requirements.resize(static_cast<size_t>(UnitTypeId::Count));
+				result.Provides.resize(static_cast<size_t>(UnitTypeId::Count));
+				for (size_t i = 0; i < result.Requirements.size(); ++i)
+				{
+					const UnitTypeId type = static_cast<UnitTypeId>(i);
+					const UnitTypeStats& stats = GetUnitStats(type);
+					const UnitTypeId producer = stats.ProducedBy == UnitTypeId::Larva ? UnitTypeId::Hatchery : stats.ProducedBy;
+					for (const UnitTypeId requirement : { producer, stats.Requires, stats.AddOn })
+					{
+						if (requirement != UnitTypeId::Invalid)
+						{
+							result.Requirements[i].Set(requirement);
+						}
+					}
+					for (UnitTypeId provided = type; provided != UnitTypeId::Invalid; provided = GetMorphBase(provided))
+					{
+						result.Provides[i].Set(provided);
+					}
+					if (GetMorphBase(type) != UnitTypeId::Invalid)
+					{
+						result.MorphSources.Set(GetMorphBase(type));
+					}
+				}
+				return result;
+			}();
+			return graph;
+		}
+
+		void CollectMissing(UnitTypeId type, TechSet& visited, std::vector<UnitTypeId>& outMissing) const
+		{
+			const TechSet& requirements = GetRequirements(type);
+			for (size_t i = 0; i < static_cast<size_t>(UnitTypeId::Count); ++i)
+			{
+				const UnitTypeId requirement = static_cast<UnitTypeId>(i);
+				if (requirements.Test(requirement) && !Owned.Test(requirement) && !visited.Test(requirement))
+				{
+					visited.Set(requirement);
+					CollectMissing(requirement, visited, outMissing);
+					outMissing.push_back(requirement);
+				}
+			}
+		}
+
+		void RebuildOwned()
+		{
+			Owned = TechSet();
+			for (size_t i = 0; i < Counts.size(); ++i)
+			{
+				if (Counts[i] > 0)
+				{
+					Owned |= GetProvides(static_cast<UnitTypeId>(i));
+				}
+			}
+		}
+
+		void AddCount(UnitTypeId type, int delta)
+		{
+			uint16_t& count = Counts[static_cast<size_t>(type)];
+			const bool had = count > 0;
+			count = static_cast<uint16_t>(count + delta);
+			//Only a count crossing zero changes the set; removals rebuild it as bases can be provided by several types
+			if (!had && count > 0)
+			{
+				Owned |= GetProvides(type);
+			}
+			else if (had && count == 0)
+			{
+				RebuildOwned();
+			}
+		}
+
+		void TrackMorphable(const Unit& unit, UnitTypeId type)
+		{
+			if (GetGraph().MorphSources.Test(type))
+			{
+				Morphable.push_back(unit);
+			}
+		}
+
+		void UpdateMorphs()
+		{
+			for (size_t i = 0; i < Morphable.size();)
+			{
+				const auto it = Tracked.find(Morphable[i].id);
+				const Optional<UnitTypeId> type = GetUnitTypeId(Morphable[i]);
+				if (it != Tracked.end() && type.hasValue() && type.value() != it->second.Type)
+				{
+					//Add first so the base stays owned while the count of the old type drops to zero
+					AddCount(type.value(), 1);
+					AddCount(it->second.Type, -1);
+					it->second.Type = type.value();
+				}
+				if (it == Tracked.end() || !GetGraph().MorphSources.Test(it->second.Type))
+				{
+					Morphable[i] = Morphable.back();
+					Morphable.pop_back();
+					continue;
+				}
+				++i;
+			}
+		}
+
+		void Track(const Unit& unit, bool completed)
+		{
+			const Optional<UnitTypeId> type = GetUnitTypeId(unit);
+			if (!type.hasValue() || Tracked.count(unit.id) != 0)
+			{
+				return;
+			}
+			Tracked.emplace(unit.id, TrackedUnit{ type.value(), completed });
+			if (completed)
+			{
+				AddCount(type.value(), 1);
+				TrackMorphable(unit, type.value());
+			}
+			else
+			{
+				Unfinished.push_back(unit);
+			}
+		}
+
+		void OnUnitCreated(Unit eventUnit, int eventPlayerId)
+		{
+			if (eventPlayerId != PlayerLocal())
+			{
+				return;
+			}
+			const Optional<UnitTypeId> type = GetUnitTypeId(eventUnit);
+			if (!type.hasValue())
+			{
+				return;
+			}
+			//Structures are created when placed and only count once finished
+			Track(eventUnit, !GetUnitStats(type.value()).Is(UnitFilterFlag::Structure));
+		}
+
+		void OnUnitDestroyed(Unit eventUnit, Optional<Unit> /*killerUnit*/)
+		{
+			const auto it = Tracked.find(eventUnit.id);
+			if (it == Tracked.end())
+			{
+				return;
+			}
+			if (it->second.Completed)
+			{
+				AddCount(it->second.Type, -1);
+				Morphable.erase(std::remove(Morphable.begin(), Morphable.end(), eventUnit), Morphable.end());
+			}
+			else
+			{
+				Unfinished.erase(std::remove(Unfinished.begin(), Unfinished.end(), eventUnit), Unfinished.end());
+			}
+			Tracked.erase(it);
+		}
+		#pragma endregion
+	};
+}
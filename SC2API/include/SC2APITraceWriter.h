@@ -0,0 +1,208 @@
+#pragma once
+#include "SC2APIProfiler.h"
+
+#if defined(SC2API_PROFILING)
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Streams the profiler timeline to a Chrome trace event JSON file, which opens in chrome://tracing and Perfetto.
+	/// Every profiler zone, signal slot and mark becomes an event on the track of its thread; frames get a track of their
+	/// own, so spikes stand out. Name the timer and unit signals with Profiler::NameSignal to read their slots.
+	/// EndFrame only queues the events; a background thread formats and writes them. The queue is bounded, frames
+	/// arriving while it is full are dropped and counted instead of growing memory.
+	/// </summary>
+	class ChromeTraceWriter : public ProfileTraceSink
+	{
+	public:
+		/// <summary>
+		/// Opens the file and attaches the writer to the profiler.
+		/// </summary>
+		/// <param name="path">Path of the trace file, overwritten</param>
+		/// <param name="maxQueuedEvents">Most events waiting to be written</param>
+		explicit ChromeTraceWriter(const std::string& path, size_t maxQueuedEvents = 1 << 20)
+			: File(path, std::ios::out | std::ios::trunc)
+			, MaxQueuedEvents(maxQueuedEvents)
+		{
+			File << "{\"traceEvents\":[\n";
+			File << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Frames\"}}";
+			Writer = std::thread(&ChromeTraceWriter::Run, this);
+			Profiler::Get().SetTraceSink(this);
+		}
+
+		/// <summary>
+		/// Detaches from the profiler, writes what is queued and closes the file.
+		/// </summary>
+		~ChromeTraceWriter()
+		{
+			Profiler::Get().SetTraceSink(nullptr);
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Stopping = true;
+			}
+			QueueChanged.notify_one();
+			Writer.join();
+			File << "\n]}\n";
+		}
+
+		bool IsOpen() const
+		{
+			return File.is_open();
+		}
+
+		/// <summary>
+		/// Number of events dropped because the queue was full.
+		/// </summary>
+		uint64_t GetDroppedEvents() const
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			return DroppedEvents;
+		}
+
+		void OnZoneNamed(uint32_t zone, const std::string& name) override
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			Queue.emplace_back();
+			Queue.back().Zone = zone;
+			Queue.back().Name = name;
+			QueueChanged.notify_one();
+		}
+
+		void OnFrame(std::vector<ProfileTraceEvent>&& events) override
+		{
+			std::lock_guard<std::mutex> lock(Mutex);
+			if (QueuedEvents + events.size() > MaxQueuedEvents)
+			{
+				DroppedEvents += events.size();
+				return;
+			}
+			QueuedEvents += events.size();
+			Queue.emplace_back();
+			Queue.back().Events = std::move(events);
+			QueueChanged.notify_one();
+		}
+
+		ChromeTraceWriter(const ChromeTraceWriter&) = delete;
+		ChromeTraceWriter& operator=(const ChromeTraceWriter&) = delete;
+
+		#pragma region Implementations
+	private:
+		//Either a zone name or the events of a frame, kept in one queue so names always precede their events
+		struct Item
+		{
+			uint32_t Zone = 0;
+			std::string Name;
+			std::vector<ProfileTraceEvent> Events;
+		};
+
+		std::ofstream File;
+		size_t MaxQueuedEvents;
+		mutable std::mutex Mutex;
+		std::condition_variable QueueChanged;
+		std::deque<Item> Queue;
+		size_t QueuedEvents = 0;
+		uint64_t DroppedEvents = 0;
+		bool Stopping = false;
+		std::thread Writer;
+
+		//Owned by the writer thread
+		std::vector<std::string> ZoneNames;
+		std::vector<bool> NamedThreads;
+
+		void Run()
+		{
+			std::unique_lock<std::mutex> lock(Mutex);
+			for (;;)
+			{
+				QueueChanged.wait(lock, [this]() { return Stopping || !Queue.empty(); });
+				if (Queue.empty())
+				{
+					break;
+				}
+				Item item = std::move(Queue.front());
+				Queue.pop_front();
+				QueuedEvents -= item.Events.size();
+				lock.unlock();
+				Write(item);
+				lock.lock();
+			}
+			File.flush();
+		}
+
+		void Write(const Item& item)
+		{
+			if (item.Events.empty())
+			{
+				if (ZoneNames.size() <= item.Zone)
+				{
+					ZoneNames.resize(item.Zone + 1);
+				}
+				ZoneNames[item.Zone] = Escape(item.Name);
+				return;
+			}
+			char buffer[128];
+			for (const ProfileTraceEvent& event : item.Events)
+			{
+				if (event.Thread != 0 && (NamedThreads.size() <= event.Thread || !NamedThreads[event.Thread]))
+				{
+					if (NamedThreads.size() <= event.Thread)
+					{
+						NamedThreads.resize(event.Thread + 1);
+					}
+					NamedThreads[event.Thread] = true;
+					File << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << event.Thread
+						<< ",\"args\":{\"name\":\"Thread " << event.Thread << "\"}}";
+				}
+				const std::string& name = event.Zone < ZoneNames.size() ? ZoneNames[event.Zone] : std::string();
+				if (event.Type == ProfileTraceEvent::Complete)
+				{
+					std::snprintf(buffer, sizeof(buffer), "\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", event.Thread, event.Start, event.Duration);
+				}
+				else
+				{
+					std::snprintf(buffer, sizeof(buffer), "\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", event.Thread, event.Start);
+				}
+				File << ",\n{\"name\":\"" << name << "\"," << buffer;
+			}
+		}
+
+		static std::string Escape(const std::string& text)
+		{
+			std::string escaped;
+			escaped.reserve(text.size());
+			for (const char c : text)
+			{
+				if (c == '"' || c == '\\')
+				{
+					escaped += '\\';
+					escaped += c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20)
+				{
+					char code[8];
+					std::snprintf(code, sizeof(code), "\\u%04x", c);
+					escaped += code;
+				}
+				else
+				{
+					escaped += c;
+				}
+			}
+			return escaped;
+		}
+		#pragma endregion
+	};
+}
+
+#endif
@@ -2,10 +2,49 @@
 #include "SC2API.h"
 #include "SC2APIUnit.h"
 #include "SC2APIUnitFilterFlag.h"
+#include "SC2APIPointBatch.h"
+#include "SC2APICallCounters.h"
 #include <set>
+#include <vector>
 
 namespace SC2API
 {
+	/// <summary>
+	/// Per-unit state of a unit group in structure-of-arrays layout, see FillUnitGroupState.
+	/// Entry i describes Units[i]. Fields of inaccessible units hold 0 (Owner -1) and their bit in AccessibleMask is clear,
+	/// so scoring loops can run over the arrays without branching per unit and mask the result afterwards.
+	/// Reuse one instance across frames to avoid reallocating the buffers.
+	/// </summary>
+	struct UnitGroupState
+	{
+		std::vector<Unit> Units;
+		std::vector<float> Life;
+		std::vector<float> Shield;
+		std::vector<float> Energy;
+		std::vector<int> Owner;
+		PointArray<float> Positions;
+
+		/// <summary>
+		/// Bit i % 64 of AccessibleMask[i / 64] is set when Units[i] is accessible.
+		/// </summary>
+		std::vector<uint64_t> AccessibleMask;
+
+		/// <summary>
+		/// Number of accessible units.
+		/// </summary>
+		size_t AccessibleCount = 0;
+
+		size_t Count() const
+		{
+			return Units.size();
+		}
+
+		bool IsAccessible(size_t index) const
+		{
+			return ((AccessibleMask[index / 64] >> (index % 64)) & 1) != 0;
+		}
+	};
+
 	/// <summary>
 	/// SC2API UnitGroup is a collection of units. Note the content is copied when assigned to another variable.
 	/// </summary>
@@ -152,4 +191,50 @@ namespace SC2API
 		}
 		#pragma endregion
 	};
+
+	/// <summary>
+	/// Fills life, shield, energy, owner and position of every unit in the group into a caller-provided buffer,
+	/// together with one accessibility bitmask for the whole group.
+	/// A free function because UnitGroup is exported by SC2API.dll, which has no such member.
+	/// </summary>
+	/// <param name="group">The units</param>
+	/// <param name="outState">The buffer to fill, previous content is replaced</param>
+	inline void FillUnitGroupState(const UnitGroup& group, UnitGroupState& outState)
+	{
+		outState.Units.assign(group.begin(), group.end());
+		const size_t count = outState.Units.size();
+		outState.Life.assign(count, 0.0f);
+		outState.Shield.assign(count, 0.0f);
+		outState.Energy.assign(count, 0.0f);
+		outState.Owner.assign(count, -1);
+		outState.Positions.X.assign(count, 0.0f);
+		outState.Positions.Y.assign(count, 0.0f);
+		outState.AccessibleMask.assign(RangeMaskWords(count), 0);
+		outState.AccessibleCount = 0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Unit& unit = outState.Units[i];
+			//Every getter is empty for an inaccessible unit, so life doubles as the accessibility query
+			const Optional<double> life = SC2API_COUNT_CALL(UnitGetLife, unit.GetLife());
+			if (!life.hasValue())
+			{
+				continue;
+			}
+			const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition());
+			if (position.hasValue())
+			{
+				outState.Positions.X[i] = static_cast<float>(position.value().X);
+				outState.Positions.Y[i] = static_cast<float>(position.value().Y);
+			}
+			const Optional<double> shield = SC2API_COUNT_CALL(UnitGetShield, unit.GetShield());
+			const Optional<double> energy = SC2API_COUNT_CALL(UnitGetEnergy, unit.GetEnergy());
+			outState.Life[i] = static_cast<float>(life.value());
+			outState.Shield[i] = shield.hasValue() ? static_cast<float>(shield.value()) : 0.0f;
+			outState.Energy[i] = energy.hasValue() ? static_cast<float>(energy.value()) : 0.0f;
+			outState.Owner[i] = SC2API_COUNT_CALL(UnitGetOwner, unit.GetOwner());
+			outState.AccessibleMask[i / 64] |= 1ULL << (i % 64);
+			++outState.AccessibleCount;
+		}
+	}
 }
@@ -0,0 +1,208 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APICallCounters.h"
+#include "SC2APIUnit.h"
+#include "SC2APIGame.h"
+#include "SC2APIPoint.h"
+#include "SC2APIHandleMap.h"
+#include "SC2APIUnitStats.h"
+#include <utility>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Last observed state of a unit.
+	/// </summary>
+	struct UnitSnapshot
+	{
+		/// <summary>
+		/// Type of the unit, Invalid if it is not in the unit stats table.
+		/// </summary>
+		UnitTypeId Type = UnitTypeId::Invalid;
+
+		Point Position = {};
+		float Life = 0.0f;
+		float Shield = 0.0f;
+		float Energy = 0.0f;
+		bool IsEnemy = false;
+
+		/// <summary>
+		/// Whether the unit is visible now.
+		/// </summary>
+		bool IsVisible = false;
+
+		/// <summary>
+		/// Game time in seconds when the snapshot was taken, see UnitMemory::GetTime.
+		/// </summary>
+		double Time = 0.0;
+	};
+
+	/// <summary>
+	/// Remembers the last observed state of every unit that was seen, so units in fog of war keep their last position,
+	/// type and health. Snapshots are taken when units enter and leave vision, refreshed for visible units every clock
+	/// tick and dropped when units die.
+	/// Lookups are by handle in a HandleMap, so the memory can be shared instead of keeping per-bot copies.
+	/// </summary>
+	class UnitMemory : public SignalObject
+	{
+	public:
+		/// <summary>
+		/// Starts remembering units.
+		/// </summary>
+		/// <param name="timeResolution">Game seconds between clock ticks; snapshot times are multiples of it</param>
+		explicit UnitMemory(double timeResolution = 0.25)
+			: TimeResolution(timeResolution)
+		{
+			Unit::SignalUnitEnterVision().connect(this, &UnitMemory::OnUnitEnterVision);
+			Unit::SignalUnitLeaveVision().connect(this, &UnitMemory::OnUnitLeaveVision);
+			Unit::SignalUnitDestroyed().connect(this, &UnitMemory::OnUnitDestroyed);
+			SignalTimer(timeResolution, true).connect(this, &UnitMemory::OnTimer);
+		}
+
+		/// <summary>
+		/// Gets the last snapshot of a unit.
+		/// </summary>
+		/// <returns>The snapshot, or nullptr if the unit was never seen or is dead</returns>
+		const UnitSnapshot* Get(const Unit& unit) const
+		{
+			return Snapshots.Find(unit.id);
+		}
+
+		/// <summary>
+		/// Gets the last known position of a unit, the current one if the unit is accessible.
+		/// </summary>
+		Optional<Point> GetLastPosition(const Unit& unit) const
+		{
+			const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition());
+			if (position.hasValue())
+			{
+				return position;
+			}
+			const UnitSnapshot* snapshot = Snapshots.Find(unit.id);
+			if (snapshot == nullptr)
+			{
+				return{};
+			}
+			return snapshot->Position;
+		}
+
+		/// <summary>
+		/// Gets the game time in seconds since the memory was created.
+		/// </summary>
+		double GetTime() const
+		{
+			return Time;
+		}
+
+		/// <summary>
+		/// Gets all snapshots.
+		/// </summary>
+		const HandleMap<UnitSnapshot>& GetSnapshots() const
+		{
+			return Snapshots;
+		}
+
+		/// <summary>
+		/// Takes a snapshot of an accessible unit now, e.g. one seen before the memory was created.
+		/// </summary>
+		void Remember(const Unit& unit)
+		{
+			TakeSnapshot(unit, SC2API_COUNT_CALL(UnitIsAccessible, unit.IsAccessible()));
+		}
+
+		void Forget(const Unit& unit)
+		{
+			Snapshots.Erase(unit.id);
+		}
+
+		/// <summary>
+		/// Forgets units out of vision that were last seen longer ago than the given game seconds.
+		/// </summary>
+		void ForgetOlderThan(double age)
+		{
+			const double limit = Time - age;
+			Snapshots.EraseIf([limit](HandleId, const UnitSnapshot& snapshot)
+			{
+				return !snapshot.IsVisible && snapshot.Time < limit;
+			});
+		}
+
+		#pragma region Implementations
+	private:
+		double TimeResolution;
+		double Time = 0.0;
+		HandleMap<UnitSnapshot> Snapshots;
+
+		void TakeSnapshot(const Unit& unit, bool visible)
+		{
+			const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition());
+			if (!position.hasValue())
+			{
+				//Inaccessible already, keep what was seen last
+				UnitSnapshot* known = Snapshots.Find(unit.id);
+				if (known != nullptr)
+				{
+					known->IsVisible = visible;
+				}
+				return;
+			}
+			UnitSnapshot snapshot;
+			const Optional<UnitTypeId> type = GetUnitTypeId(unit);
+			snapshot.Type = type.hasValue() ? type.value() : UnitTypeId::Invalid;
+			snapshot.Position = position.value();
+			const Optional<double> life = SC2API_COUNT_CALL(UnitGetLife, unit.GetLife());
+			const Optional<double> shield = SC2API_COUNT_CALL(UnitGetShield, unit.GetShield());
+			const Optional<double> energy = SC2API_COUNT_CALL(UnitGetEnergy, unit.GetEnergy());
+			snapshot.Life = life.hasValue() ? static_cast<float>(life.value()) : 0.0f;
+			snapshot.Shield = shield.hasValue() ? static_cast<float>(shield.value()) : 0.0f;
+			snapshot.Energy = energy.hasValue() ? static_cast<float>(energy.value()) : 0.0f;
+			snapshot.IsEnemy = SC2API_COUNT_CALL(UnitIsOwnedByEnemyPlayer, unit.IsOwnedByEnemyPlayer());
+			snapshot.IsVisible = visible;
+			snapshot.Time = Time;
+			Snapshots.Insert(unit.id, snapshot);
+		}
+
+		void OnUnitEnterVision(Unit eventUnit)
+		{
+			TakeSnapshot(eventUnit, true);
+		}
+
+		void OnUnitLeaveVision(Unit eventUnit)
+		{
+			TakeSnapshot(eventUnit, false);
+		}
+
+		void OnUnitDestroyed(Unit eventUnit, Optional<Unit> /*killerUnit*/)
+		{
+			Snapshots.Erase(eventUnit.id);
+		}
+
+		void OnTimer()
+		{
+			Time += TimeResolution;
+			Snapshots.ForEach([this](HandleId id, UnitSnapshot& snapshot)
+			{
+				if (!snapshot.IsVisible)
+				{
+					return;
+				}
+				Unit unit;
+				unit.id = id;
+				const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition());
+				if (!position.hasValue())
+				{
+					return;
+				}
+				const Optional<double> life = SC2API_COUNT_CALL(UnitGetLife, unit.GetLife());
+				const Optional<double> shield = SC2API_COUNT_CALL(UnitGetShield, unit.GetShield());
+				const Optional<double> energy = SC2API_COUNT_CALL(UnitGetEnergy, unit.GetEnergy());
+				snapshot.Position = position.value();
+				snapshot.Life = life.hasValue() ? static_cast<float>(life.value()) : snapshot.Life;
+				snapshot.Shield = shield.hasValue() ? static_cast<float>(shield.value()) : snapshot.Shield;
+				snapshot.Energy = energy.hasValue() ? static_cast<float>(energy.value()) : snapshot.Energy;
+				snapshot.Time = Time;
+			});
+		}
+		#pragma endregion
+	};
+}
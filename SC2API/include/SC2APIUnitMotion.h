@@ -0,0 +1,290 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APICallCounters.h"
+#include "SC2APIUnit.h"
+#include "SC2APIUnitGroup.h"
+#include "SC2APIGame.h"
+#include "SC2APIPoint.h"
+#include "SC2APIPointBatch.h"
+#include "SC2APIHandleMap.h"
+#include "SC2APISimd.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Estimates unit velocities from position samples and extrapolates positions ahead in time, e.g. to intercept,
+	/// kite or aim skillshots. Units are tracked while visible and sampled every clock tick into a small ring buffer;
+	/// the velocity is the least-squares fit over the buffer, which smooths out the jitter of single-tick differences.
+	/// History is reset when a unit jumps farther than any unit can move (blink, warp), so predictions restart cleanly.
+	/// Predictions are linear and do not know about terrain or orders.
+	/// </summary>
+	class UnitMotionTracker : public SignalObject
+	{
+	public:
+		/// <summary>
+		/// Starts tracking units as they become visible.
+		/// </summary>
+		/// <param name="sampleInterval">Game seconds between samples</param>
+		explicit UnitMotionTracker(double sampleInterval = 1.0 / 16.0)
+			: SampleInterval(static_cast<float>(sampleInterval))
+		{
+			Unit::SignalUnitEnterVision().connect(this, &UnitMotionTracker::OnUnitEnterVision);
+			Unit::SignalUnitLeaveVision().connect(this, &UnitMotionTracker::OnUnitLeaveVision);
+			Unit::SignalUnitDestroyed().connect(this, &UnitMotionTracker::OnUnitDestroyed);
+			SignalTimer(sampleInterval, true).connect(this, &UnitMotionTracker::OnTimer);
+		}
+
+		/// <summary>
+		/// Starts tracking a unit, e.g. one visible before the tracker was created.
+		/// </summary>
+		void Track(const Unit& unit)
+		{
+			if (!Tracks.Contains(unit.id))
+			{
+				Tracks.Insert(unit.id, Motion());
+				AddSample(unit.id, *Tracks.Find(unit.id));
+			}
+		}
+
+		void Untrack(const Unit& unit)
+		{
+			Tracks.Erase(unit.id);
+		}
+
+		size_t GetTrackedCount() const
+		{
+			return Tracks.Size();
+		}
+
+		/// <summary>
+		/// Gets the estimated velocity of a unit in map units per game second.
+		/// </summary>
+		/// <returns>The velocity, or empty value if the unit is not tracked</returns>
+		Optional<Point> GetVelocity(const Unit& unit) const
+		{
+			const Motion* motion = Tracks.Find(unit.id);
+			if (motion == nullptr)
+			{
+				return{};
+			}
+			return Point{ motion->VelocityX, motion->VelocityY };
+		}
+
+		/// <summary>
+		/// Predicts the position of a unit.
+		/// </summary>
+		/// <param name="unit">The unit</param>
+		/// <param name="time">Game seconds ahead</param>
+		/// <returns>The predicted position, or empty value if the unit is neither tracked nor accessible</returns>
+		Optional<Point> PredictPosition(const Unit& unit, float time) const
+		{
+			const Motion* motion = Tracks.Find(unit.id);
+			const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition());
+			if (motion == nullptr)
+			{
+				return position;
+			}
+			const Point origin = position.hasValue() ? position.value() : motion->LastPosition();
+			return Point{ origin.X + motion->VelocityX * time, origin.Y + motion->VelocityY * time };
+		}
+
+		/// <summary>
+		/// Predicts the positions of all units of a group in one pass.
+		/// </summary>
+		/// <param name="group">The units</param>
+		/// <param name="time">Game seconds ahead</param>
+		/// <param name="outState">Receives the state of the group, see FillUnitGroupState</param>
+		/// <param name="outPositions">Receives the predicted position of unit i of outState at index i</param>
+		void PredictPositions(const UnitGroup& group, float time, UnitGroupState& outState, PointArray<float>& outPositions) const
+		{
+			FillUnitGroupState(group, outState);
+			PredictPositions(outState, time, outPositions);
+		}
+
+		/// <summary>
+		/// Predicts the positions of the units of a filled group state in one pass.
+		/// Inaccessible units start from their last sample; untracked ones are predicted not to move.
+		/// </summary>
+		void PredictPositions(const UnitGroupState& state, float time, PointArray<float>& outPositions) const
+		{
+			const size_t count = state.Count();
+			outPositions.X.assign(state.Positions.X.begin(), state.Positions.X.end());
+			outPositions.Y.assign(state.Positions.Y.begin(), state.Positions.Y.end());
+			VelocityX.assign(count, 0.0f);
+			VelocityY.assign(count, 0.0f);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const Motion* motion = Tracks.Find(state.Units[i].id);
+				if (motion == nullptr)
+				{
+					continue;
+				}
+				VelocityX[i] = motion->VelocityX;
+				VelocityY[i] = motion->VelocityY;
+				if (!state.IsAccessible(i))
+				{
+					outPositions.X[i] = motion->X[motion->Newest()];
+					outPositions.Y[i] = motion->Y[motion->Newest()];
+				}
+			}
+
+			using PackT = Simd::Pack<float>;
+			const PackT ahead = PackT::Broadcast(time);
+			size_t i = 0;
+			for (; i + PackT::Width <= count; i += PackT::Width)
+			{
+				(PackT::Load(&outPositions.X[i]) + PackT::Load(&VelocityX[i]) * ahead).Store(&outPositions.X[i]);
+				(PackT::Load(&outPositions.Y[i]) + PackT::Load(&VelocityY[i]) * ahead).Store(&outPositions.Y[i]);
+			}
+			for (; i < count; ++i)
+			{
+				outPositions.X[i] += VelocityX[i] * time;
+				outPositions.Y[i] += VelocityY[i] * time;
+			}
+		}
+
+		/// <summary>
+		/// Samples all tracked units now. Called by the clock; call directly to drive the tracker without game timers.
+		/// </summary>
+		/// <param name="elapsed">Game seconds since the previous sample</param>
+		void Sample(double elapsed)
+		{
+			Time += elapsed;
+			Tracks.ForEach([this](HandleId id, Motion& motion)
+			{
+				AddSample(id, motion);
+			});
+		}
+
+		#pragma region Implementations
+	private:
+		enum : uint32_t
+		{
+			HistorySize = 8,
+		};
+
+		struct Motion
+		{
+			float X[HistorySize];
+			float Y[HistorySize];
+			double T[HistorySize];
+			uint32_t Head = 0;
+			uint32_t Size = 0;
+			float VelocityX = 0.0f;
+			float VelocityY = 0.0f;
+
+			uint32_t Newest() const
+			{
+				return (Head + HistorySize - 1) % HistorySize;
+			}
+
+			Point LastPosition() const
+			{
+				return Size > 0 ? Point{ X[Newest()], Y[Newest()] } : Point{};
+			}
+		};
+
+		float SampleInterval;
+		double Time = 0.0;
+		HandleMap<Motion> Tracks;
+
+		//Scratch buffers of PredictPositions, which makes the tracker unsafe to share between threads
+		mutable std::vector<float> VelocityX;
+		mutable std::vector<float> VelocityY;
+
+		void AddSample(HandleId id, Motion& motion) const
+		{
+			//Faster than any unit moves, even with speed upgrades on creep
+			const float maxSpeed = 12.0f;
+
+			Unit unit;
+			unit.id = id;
+			const Optional<Point> position = SC2API_COUNT_CALL(UnitGetPosition, unit.GetPosition());
+			if (!position.hasValue())
+			{
+				return;
+			}
+			const float x = static_cast<float>(position.value().X);
+			const float y = static_cast<float>(position.value().Y);
+			if (motion.Size > 0)
+			{
+				const uint32_t newest = motion.Newest();
+				const float step = maxSpeed * std::max(static_cast<float>(Time - motion.T[newest]), SampleInterval);
+				const float dx = x - motion.X[newest];
+				const float dy = y - motion.Y[newest];
+				if (dx * dx + dy * dy > step * step)
+				{
+					motion.Size = 0;
+				}
+			}
+			motion.X[motion.Head] = x;
+			motion.Y[motion.Head] = y;
+			motion.T[motion.Head] = Time;
+			motion.Head = (motion.Head + 1) % HistorySize;
+			motion.Size = std::min(motion.Size + 1, static_cast<uint32_t>(HistorySize));
+			FitVelocity(motion);
+		}
+
+		//Least-squares slope of position over time
+		static void FitVelocity(Motion& motion)
+		{
+			if (motion.Size < 2)
+			{
+				motion.VelocityX = motion.VelocityY = 0.0f;
+				return;
+			}
+			double meanT = 0.0;
+			float meanX = 0.0f, meanY = 0.0f;
+			for (uint32_t k = 0; k < motion.Size; ++k)
+			{
+				const uint32_t i = (motion.Head + HistorySize - 1 - k) % HistorySize;
+				meanT += motion.T[i];
+				meanX += motion.X[i];
+				meanY += motion.Y[i];
+			}
+			meanT /= motion.Size;
+			meanX /= motion.Size;
+			meanY /= motion.Size;
+			float varianceT = 0.0f, covarianceX = 0.0f, covarianceY = 0.0f;
+			for (uint32_t k = 0; k < motion.Size; ++k)
+			{
+				const uint32_t i = (motion.Head + HistorySize - 1 - k) % HistorySize;
+				const float dt = static_cast<float>(motion.T[i] - meanT);
+				varianceT += dt * dt;
+				covarianceX += dt * (motion.X[i] - meanX);
+				covarianceY += dt * (motion.Y[i] - meanY);
+			}
+			if (varianceT <= 0.0f)
+			{
+				motion.VelocityX = motion.VelocityY = 0.0f;
+				return;
+			}
+			motion.VelocityX = covarianceX / varianceT;
+			motion.VelocityY = covarianceY / varianceT;
+		}
+
+		void OnUnitEnterVision(Unit eventUnit)
+		{
+			Track(eventUnit);
+		}
+
+		void OnUnitLeaveVision(Unit eventUnit)
+		{
+			Untrack(eventUnit);
+		}
+
+		void OnUnitDestroyed(Unit eventUnit, Optional<Unit> /*killerUnit*/)
+		{
+			Untrack(eventUnit);
+		}
+
+		void OnTimer()
+		{
+			Sample(SampleInterval);
+		}
+		#pragma endregion
+	};
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIGameData.h"
+#include "SC2APIUnitFilterFlag.h"
+#include "SC2APICallCounters.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+//Stats of the melee unit and structure roster, one row per type:
+//  X(Id, Race, Minerals, Vespene, Supply, SupplyProvided, BuildTime,
+//    Life, Shield, Armor, GroundDamage, GroundCooldown, GroundRange, AirDamage, AirCooldown, AirRange,
+//    Footprint, Attributes, ProducedBy, Requires, AddOn)
+//Times are in seconds at faster game speed. Damage is per attack, summed over the hits of one attack, without bonuses.
+//Footprint is the edge length in cells of a structure's square footprint. ProducedBy is the unit that trains, builds or
+//morphs into the type, Requires the tech structure needed and AddOn the add-on the producer must carry (Invalid if none).
+//Zerglings are trained in pairs; their row holds the cost and supply of a single zergling.
+#define SC2API_UNIT_STATS(X) \
+	X(SCV,               Terran,   50,   0,   1,    0,  12,   45,    0,   0,   5,  1.07f, 0.1f,  0,  0.0f,  0,  0, Ground | Light | Biological | Mechanical | Worker,     CommandCenter,     Invalid,          Invalid) \
+	X(Marine,            Terran,   50,   0,   1,    0,  18,   45,    0,   0,   6,  0.61f, 5,     6,  0.61f, 5,  0, Ground | Light | Biological,                           Barracks,          Invalid,          Invalid) \
+	X(Marauder,          Terran,  100,  25,   2,    0,  21,  125,    0,   1,  10,  1.07f, 6,     0,  0.0f,  0,  0, Ground | Armored | Biological,                         Barracks,          Invalid,          BarracksTechLab) \
+	X(Reaper,            Terran,   50,  50,   1,    0,  32,   60,    0,   0,   8,  0.79f, 5,     0,  0.0f,  0,  0, Ground | Light | Biological,                           Barracks,          Invalid,          Invalid) \
+	X(Ghost,             Terran,  150, 125,   2,    0,  29,  100,    0,   0,  10,  1.07f, 6,    10,  1.07f, 6,  0, Ground | Biological | Psionic,                         Barracks,          GhostAcademy,     BarracksTechLab) \
+	X(Hellion,           Terran,  100,   0,   2,    0,  21,   90,    0,   0,   8,  1.79f, 5,     0,  0.0f,  0,  0, Ground | Light | Mechanical,                           Factory,           Invalid,          Invalid) \
+	X(WidowMine,         Terran,   75,  25,   2,    0,  21,   90,    0,   0,   0,  0.0f,  0,     0,  0.0f,  0,  0, Ground | Light | Mechanical,                           Factory,           Invalid,          Invalid) \
+	X(SiegeTank,         Terran,  150, 125,   3,    0,  32,  175,    0,   1,  15,  0.74f, 7,     0,  0.0f,  0,  0, Ground | Armored | Mechanical,                         Factory,           Invalid,          FactoryTechLab) \
+	X(Cyclone,           Terran,  150, 100,   3,    0,  32,  120,    0,   1,  18,  0.71f, 5,    18,  0.71f, 5,  0, Ground | Armored | Mechanical,                         Factory,           Invalid,          FactoryTechLab) \
+	X(Thor,              Terran,  300, 200,   6,    0,  43,  400,    0,   1,  60,  0.91f, 7,    24,  2.14f, 10, 0, Ground | Armored | Mechanical | Massive,               Factory,           Armory,           FactoryTechLab) \
+	X(VikingFighter,     Terran,  150,  75,   2,    0,  30,  135,    0,   0,   0,  0.0f,  0,    20,  1.43f, 9,  0, Air | Armored | Mechanical,                            Starport,          Invalid,          Invalid) \
+	X(Medivac,           Terran,  100, 100,   2,    0,  30,  150,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  0, Air | Armored | Mechanical,                            Starport,          Invalid,          Invalid) \
+	X(Liberator,         Terran,  150, 150,   3,    0,  43,  180,    0,   0,   0,  0.0f,  0,    10,  1.29f, 5,  0, Air | Armored | Mechanical,                            Starport,          Invalid,          Invalid) \
+	X(Raven,             Terran,  100, 200,   2,    0,  34,  140,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  0, Air | Light | Mechanical | Detector,                    Starport,          Invalid,          StarportTechLab) \
+	X(Banshee,           Terran,  150, 100,   3,    0,  43,  140,    0,   0,  24,  0.89f, 6,     0,  0.0f,  0,  0, Air | Light | Mechanical,                              Starport,          Invalid,          StarportTechLab) \
+	X(Battlecruiser,     Terran,  400, 300,   6,    0,  64,  550,    0,   3,   8,  0.16f, 6,     5,  0.16f, 6,  0, Air | Armored | Mechanical | Massive,                  Starport,          FusionCore,       StarportTechLab) \
+	X(CommandCenter,     Terran,  400,   0,   0,   15,  71, 1500,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  5, Ground | Armored | Mechanical | Structure,             SCV,               Invalid,          Invalid) \
+	X(OrbitalCommand,    Terran,  150,   0,   0,   15,  25, 1500,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  5, Ground | Armored | Mechanical | Structure,             CommandCenter,     Barracks,         Invalid) \
+	X(PlanetaryFortress, Terran,  150, 150,   0,   15,  36, 1500,    0,   3,  40,  1.43f, 6,     0,  0.0f,  0,  5, Ground | Armored | Mechanical | Structure,             CommandCenter,     EngineeringBay,   Invalid) \
+	X(SupplyDepot,       Terran,  100,   0,   0,    8,  21,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             SCV,               Invalid,          Invalid) \
+	X(Refinery,          Terran,   75,   0,   0,    0,  21,  500,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               Invalid,          Invalid) \
+	X(Barracks,          Terran,  150,   0,   0,    0,  46, 1000,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               SupplyDepot,      Invalid) \
+	X(EngineeringBay,    Terran,  125,   0,   0,    0,  25,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               CommandCenter,    Invalid) \
+	X(Bunker,            Terran,  100,   0,   0,    0,  29,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               Barracks,         Invalid) \
+	X(MissileTurret,     Terran,  100,   0,   0,    0,  18,  250,    0,   0,   0,  0.0f,  0,    24,  0.61f, 7,  2, Ground | Armored | Mechanical | Structure | Detector,  SCV,               EngineeringBay,   Invalid) \
+	X(SensorTower,       Terran,  125, 100,   0,    0,  18,  200,    0,   0,   0,  0.0f,  0,     0,  0.0f,  0,  1, Ground | Armored | Mechanical | Structure,             SCV,               EngineeringBay,   Invalid) \
+	X(GhostAcademy,      Terran,  150,  50,   0,    0,  29, 1250,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               Barracks,         Invalid) \
+	X(Factory,           Terran,  150, 100,   0,    0,  43, 1250,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               Barracks,         Invalid) \
+	X(Starport,          Terran,  150, 100,   0,    0,  36, 1300,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               Factory,          Invalid) \
+	X(Armory,            Terran,  150, 100,   0,    0,  46,  750,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               Factory,          Invalid) \
+	X(FusionCore,        Terran,  150, 150,   0,    0,  46,  750,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             SCV,               Starport,         Invalid) \
+	X(BarracksTechLab,   Terran,   50,  25,   0,    0,  18,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Barracks,          Invalid,          Invalid) \
+	X(BarracksReactor,   Terran,   50,  50,   0,    0,  36,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Barracks,          Invalid,          Invalid) \
+	X(FactoryTechLab,    Terran,   50,  25,   0,    0,  18,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Factory,           Invalid,          Invalid) \
+	X(FactoryReactor,    Terran,   50,  50,   0,    0,  36,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Factory,           Invalid,          Invalid) \
+	X(StarportTechLab,   Terran,   50,  25,   0,    0,  18,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Starport,          Invalid,          Invalid) \
+	X(StarportReactor,   Terran,   50,  50,   0,    0,  36,  400,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Starport,          Invalid,          Invalid) \
+	X(Larva,             Zerg,      0,   0,   0,    0,   0,   10,    0,  10,   0,  0.0f,  0,     0,  0.0f,  0,  0, Ground | Light | Biological,                           Invalid,           Invalid,          Invalid) \
+	X(Drone,             Zerg,     50,   0,   1,    0,  12,   40,    0,   0,   5,  1.07f, 0.1f,  0,  0.0f,  0,  0, Ground | Light | Biological | Worker,                  Larva,             Invalid,          Invalid) \
+	X(Overlord,          Zerg,    100,   0,   0,    8,  18,  200,    0,   0,   0,  0.0f,  0,     0,  0.0f,  0,  0, Air | Armored | Biological,                            Larva,             Invalid,          Invalid) \
+	X(Zergling,          Zerg,     25,   0, 0.5f,   0,  17,   35,    0,   0,   5,  0.497f, 0.1f, 0,  0.0f,  0,  0, Ground | Light | Biological,                           Larva,             SpawningPool,     Invalid) \
+	X(Queen,             Zerg,    150,   0,   2,    0,  36,  175,    0,   1,   8,  0.71f, 5,     9,  0.71f, 7,  0, Ground | Biological | Psionic,                         Hatchery,          SpawningPool,     Invalid) \
+	X(Roach,             Zerg,     75,  25,   2,    0,  19,  145,    0,   1,  16,  1.43f, 4,     0,  0.0f,  0,  0, Ground | Armored | Biological,                         Larva,             RoachWarren,      Invalid) \
+	X(Ravager,           Zerg,     25,  75,   3,    0,   9,  120,    0,   1,  16,  1.14f, 6,     0,  0.0f,  0,  0, Ground | Biological,                                   Roach,             RoachWarren,      Invalid) \
+	X(Baneling,          Zerg,     25,  25, 0.5f,   0,  14,   30,    0,   0,   0,  0.0f,  0,     0,  0.0f,  0,  0, Ground | Biological,                                   Zergling,          BanelingNest,     Invalid) \
+	X(Hydralisk,         Zerg,    100,  50,   2,    0,  24,   90,    0,   0,  12,  0.59f, 5,    12,  0.59f, 5,  0, Ground | Light | Biological,                           Larva,             HydraliskDen,     Invalid) \
+	X(Mutalisk,          Zerg,    100, 100,   2,    0,  24,  120,    0,   0,   9,  1.09f, 3,     9,  1.09f, 3,  0, Air | Light | Biological,                              Larva,             Spire,            Invalid) \
+	X(Corruptor,         Zerg,    150, 100,   2,    0,  29,  200,    0,   2,   0,  0.0f,  0,    14,  1.36f, 6,  0, Air | Armored | Biological,                            Larva,             Spire,            Invalid) \
+	X(Infestor,          Zerg,    100, 150,   2,    0,  36,   90,    0,   0,   0,  0.0f,  0,     0,  0.0f,  0,  0, Ground | Armored | Biological | Psionic,               Larva,             InfestationPit,   Invalid) \
+	X(SwarmHostMP,       Zerg,    100,  75,   3,    0,  29,  160,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  0, Ground | Armored | Biological,                         Larva,             InfestationPit,   Invalid) \
+	X(Ultralisk,         Zerg,    275, 200,   6,    0,  39,  500,    0,   2,  35,  0.61f, 1,     0,  0.0f,  0,  0, Ground | Armored | Biological | Massive,               Larva,             UltraliskCavern,  Invalid) \
+	X(BroodLord,         Zerg,    150, 150,   4,    0,  24,  225,    0,   1,  20,  1.79f, 10,    0,  0.0f,  0,  0, Air | Armored | Biological | Massive,                  Corruptor,         GreaterSpire,     Invalid) \
+	X(Overseer,          Zerg,     50,  50,   0,    8,  12,  200,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  0, Air | Armored | Biological | Detector,                 Overlord,          Lair,             Invalid) \
+	X(Viper,             Zerg,    100, 200,   3,    0,  29,  150,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  0, Air | Armored | Biological | Psionic,                  Larva,             Hive,             Invalid) \
+	X(Hatchery,          Zerg,    300,   0,   0,    6,  71, 1500,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  5, Ground | Armored | Biological | Structure,             Drone,             Invalid,          Invalid) \
+	X(Lair,              Zerg,    150, 100,   0,    6,  57, 2000,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  5, Ground | Armored | Biological | Structure,             Hatchery,          SpawningPool,     Invalid) \
+	X(Hive,              Zerg,    200, 150,   0,    6,  71, 2500,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  5, Ground | Armored | Biological | Structure,             Lair,              InfestationPit,   Invalid) \
+	X(Extractor,         Zerg,     25,   0,   0,    0,  21,  500,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             Invalid,          Invalid) \
+	X(SpawningPool,      Zerg,    200,   0,   0,    0,  46, 1000,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             Hatchery,         Invalid) \
+	X(EvolutionChamber,  Zerg,     75,   0,   0,    0,  25,  750,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             Hatchery,         Invalid) \
+	X(RoachWarren,       Zerg,    150,   0,   0,    0,  39,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             SpawningPool,     Invalid) \
+	X(BanelingNest,      Zerg,    100,  50,   0,    0,  43,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             SpawningPool,     Invalid) \
+	X(SpineCrawler,      Zerg,    100,   0,   0,    0,  36,  300,    0,   2,  25,  1.32f, 7,     0,  0.0f,  0,  2, Ground | Armored | Biological | Structure,             Drone,             SpawningPool,     Invalid) \
+	X(SporeCrawler,      Zerg,     75,   0,   0,    0,  21,  400,    0,   1,   0,  0.0f,  0,    15,  0.61f, 7,  2, Ground | Armored | Biological | Structure | Detector,  Drone,             SpawningPool,     Invalid) \
+	X(HydraliskDen,      Zerg,    100, 100,   0,    0,  29,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             Lair,             Invalid) \
+	X(InfestationPit,    Zerg,    100, 100,   0,    0,  36,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             Lair,             Invalid) \
+	X(Spire,             Zerg,    200, 200,   0,    0,  71,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Biological | Structure,             Drone,             Lair,             Invalid) \
+	X(GreaterSpire,      Zerg,    100, 150,   0,    0,  71, 1000,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Biological | Structure,             Spire,             Hive,             Invalid) \
+	X(UltraliskCavern,   Zerg,    150, 200,   0,    0,  46,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             Hive,             Invalid) \
+	X(NydusNetwork,      Zerg,    150, 150,   0,    0,  36,  850,    0,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Biological | Structure,             Drone,             Lair,             Invalid) \
+	X(Probe,             Protoss,  50,   0,   1,    0,  12,   20,   20,   0,   5,  1.07f, 0.1f,  0,  0.0f,  0,  0, Ground | Light | Mechanical | Worker,                  Nexus,             Invalid,          Invalid) \
+	X(Zealot,            Protoss, 100,   0,   2,    0,  27,  100,   50,   1,  16,  0.86f, 0.1f,  0,  0.0f,  0,  0, Ground | Light | Biological,                           Gateway,           Invalid,          Invalid) \
+	X(Stalker,           Protoss, 125,  50,   2,    0,  30,   80,   80,   1,  13,  1.34f, 6,    13,  1.34f, 6,  0, Ground | Armored | Mechanical,                         Gateway,           CyberneticsCore,  Invalid) \
+	X(Sentry,            Protoss,  50, 100,   2,    0,  26,   40,   40,   1,   6,  0.71f, 5,     6,  0.71f, 5,  0, Ground | Light | Mechanical | Psionic,                 Gateway,           CyberneticsCore,  Invalid) \
+	X(Adept,             Protoss, 100,  25,   2,    0,  27,   70,   70,   1,  10,  1.61f, 4,     0,  0.0f,  0,  0, Ground | Light | Biological,                           Gateway,           CyberneticsCore,  Invalid) \
+	X(HighTemplar,       Protoss,  50, 150,   2,    0,  39,   40,   40,   0,   0,  0.0f,  0,     0,  0.0f,  0,  0, Ground | Light | Biological | Psionic,                 Gateway,           TemplarArchive,   Invalid) \
+	X(DarkTemplar,       Protoss, 125, 125,   2,    0,  39,   40,   80,   1,  45,  1.21f, 0.1f,  0,  0.0f,  0,  0, Ground | Light | Biological | Psionic,                 Gateway,           DarkShrine,       Invalid) \
+	X(Archon,            Protoss,   0,   0,   4,    0,   9,   10,  350,   0,  25,  0.89f, 3,    25,  0.89f, 3,  0, Ground | Psionic | Massive,                             HighTemplar,       Invalid,          Invalid) \
+	X(Observer,          Protoss,  25,  75,   1,    0,  21,   40,   20,   0,   0,  0.0f,  0,     0,  0.0f,  0,  0, Air | Light | Mechanical | Detector,                    RoboticsFacility,  Invalid,          Invalid) \
+	X(WarpPrism,         Protoss, 250,   0,   2,    0,  36,   80,  100,   0,   0,  0.0f,  0,     0,  0.0f,  0,  0, Air | Armored | Mechanical | Psionic,                  RoboticsFacility,  Invalid,          Invalid) \
+	X(Immortal,          Protoss, 275, 100,   4,    0,  39,  200,  100,   1,  20,  1.04f, 6,     0,  0.0f,  0,  0, Ground | Armored | Mechanical,                         RoboticsFacility,  Invalid,          Invalid) \
+	X(Colossus,          Protoss, 300, 200,   6,    0,  54,  200,  150,   1,  20,  1.07f, 7,     0,  0.0f,  0,  0, Ground | Armored | Mechanical | Massive,               RoboticsFacility,  RoboticsBay,      Invalid) \
+	X(Disruptor,         Protoss, 150, 150,   3,    0,  36,  100,  100,   1,   0,  0.0f,  0,     0,  0.0f,  0,  0, Ground | Armored | Mechanical,                         RoboticsFacility,  RoboticsBay,      Invalid) \
+	X(Phoenix,           Protoss, 150, 100,   2,    0,  25,  120,   60,   0,   0,  0.0f,  0,    10,  0.79f, 5,  0, Air | Light | Mechanical,                              Stargate,          Invalid,          Invalid) \
+	X(Oracle,            Protoss, 150, 150,   3,    0,  37,  100,   60,   0,  15,  0.61f, 4,     0,  0.0f,  0,  0, Air | Armored | Mechanical | Psionic,                  Stargate,          Invalid,          Invalid) \
+	X(VoidRay,           Protoss, 250, 150,   4,    0,  43,  150,  100,   0,   6,  0.36f, 6,     6,  0.36f, 6,  0, Air | Armored | Mechanical,                            Stargate,          Invalid,          Invalid) \
+	X(Tempest,           Protoss, 250, 175,   5,    0,  43,  200,  150,   2,  40,  2.36f, 10,   30,  2.36f, 14, 0, Air | Armored | Mechanical | Massive,                  Stargate,          FleetBeacon,      Invalid) \
+	X(Carrier,           Protoss, 350, 250,   6,    0,  64,  300,  150,   2,  80,  3.0f,  8,    80,  3.0f,  8,  0, Air | Armored | Mechanical | Massive,                  Stargate,          FleetBeacon,      Invalid) \
+	X(Mothership,        Protoss, 400, 400,   8,    0,  79,  350,  350,   2,  24,  2.21f, 7,    24,  2.21f, 7,  0, Air | Armored | Mechanical | Psionic | Massive | Heroic, Nexus,          FleetBeacon,      Invalid) \
+	X(Nexus,             Protoss, 400,   0,   0,   15,  71, 1000, 1000,   1,   0,  0.0f,  0,     0,  0.0f,  0,  5, Ground | Armored | Mechanical | Structure,             Probe,             Invalid,          Invalid) \
+	X(Pylon,             Protoss, 100,   0,   0,    8,  18,  200,  200,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Probe,             Invalid,          Invalid) \
+	X(Assimilator,       Protoss,  75,   0,   0,    0,  21,  450,  450,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             Invalid,          Invalid) \
+	X(Gateway,           Protoss, 150,   0,   0,    0,  46,  500,  500,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             Pylon,            Invalid) \
+	X(WarpGate,          Protoss,   0,   0,   0,    0,   7,  500,  500,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Gateway,           CyberneticsCore,  Invalid) \
+	X(Forge,             Protoss, 150,   0,   0,    0,  32,  400,  400,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             Pylon,            Invalid) \
+	X(PhotonCannon,      Protoss, 150,   0,   0,    0,  29,  150,  150,   1,  20,  0.89f, 7,    20,  0.89f, 7,  2, Ground | Armored | Mechanical | Structure | Detector,  Probe,             Forge,            Invalid) \
+	X(CyberneticsCore,   Protoss, 150,   0,   0,    0,  36,  550,  550,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             Gateway,          Invalid) \
+	X(TwilightCouncil,   Protoss, 150, 100,   0,    0,  36,  500,  500,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             CyberneticsCore,  Invalid) \
+	X(RoboticsFacility,  Protoss, 150, 100,   0,    0,  46,  450,  450,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             CyberneticsCore,  Invalid) \
+	X(Stargate,          Protoss, 150, 150,   0,    0,  43,  600,  600,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             CyberneticsCore,  Invalid) \
+	X(TemplarArchive,    Protoss, 150, 200,   0,    0,  36,  500,  500,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             TwilightCouncil,  Invalid) \
+	X(DarkShrine,        Protoss, 150, 150,   0,    0,  71,  500,  500,   1,   0,  0.0f,  0,     0,  0.0f,  0,  2, Ground | Armored | Mechanical | Structure,             Probe,             TwilightCouncil,  Invalid) \
+	X(RoboticsBay,       Protoss, 150, 150,   0,    0,  46,  500,  500,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             RoboticsFacility, Invalid) \
+	X(FleetBeacon,       Protoss, 300, 200,   0,    0,  43,  500,  500,   1,   0,  0.0f,  0,     0,  0.0f,  0,  3, Ground | Armored | Mechanical | Structure,             Probe,             Stargate,         Invalid)
+
+namespace SC2API
+{
+	/// <summary>
+	/// Dense id of the unit types in the stats table, usable as an array index.
+	/// Convert from the type names of SC2API::Units with UnitTypeIdFromName.
+	/// </summary>
+	enum class UnitTypeId : uint16_t
+	{
+#define SC2API_UNIT_STATS_ENUM(Id, ...) Id,
+		SC2API_UNIT_STATS(SC2API_UNIT_STATS_ENUM)
+#undef SC2API_UNIT_STATS_ENUM
+
+		/// <summary>
+		/// Number of unit types in the table.
+		/// </summary>
+		Count,
+
+		Invalid = 0xFFFF,
+	};
+
+	enum class UnitRace : uint8_t
+	{
+		Terran,
+		Zerg,
+		Protoss,
+	};
+
+	/// <summary>
+	/// Stats of a unit type, see SC2API_UNIT_STATS for units and meaning of the fields.
+	/// </summary>
+	struct UnitTypeStats
+	{
+		UnitTypeId Id;
+		const char* Name;
+		UnitRace Race;
+		int Minerals;
+		int Vespene;
+		float Supply;
+		float SupplyProvided;
+		float BuildTime;
+		float Life;
+		float Shield;
+		float Armor;
+		float GroundDamage;
+		float GroundCooldown;
+		float GroundRange;
+		float AirDamage;
+		float AirCooldown;
+		float AirRange;
+		int Footprint;
+		UnitFilterFlag Attributes;
+		UnitTypeId ProducedBy;
+		UnitTypeId Requires;
+		UnitTypeId AddOn;
+
+		constexpr float GroundDps() const
+		{
+			return GroundCooldown > 0.0f ? GroundDamage / GroundCooldown : 0.0f;
+		}
+
+		constexpr float AirDps() const
+		{
+			return AirCooldown > 0.0f ? AirDamage / AirCooldown : 0.0f;
+		}
+
+		constexpr bool Is(UnitFilterFlag flags) const
+		{
+			return (Attributes & flags) == flags;
+		}
+	};
+
+	#pragma region Implementations
+	namespace Internal
+	{
+		using UF = UnitFilterFlag;
+
+#define SC2API_UNIT_STATS_ROW(Id, Race, Minerals, Vespene, Supply, SupplyProvided, BuildTime, Life, Shield, Armor, \
+	GroundDamage, GroundCooldown, GroundRange, AirDamage, AirCooldown, AirRange, Footprint, Attributes, ProducedBy, Requires, AddOn) \
+		{ UnitTypeId::Id, #Id, UnitRace::Race, Minerals, Vespene, Supply, SupplyProvided, BuildTime, Life, Shield, Armor, \
+			GroundDamage, GroundCooldown, GroundRange, AirDamage, AirCooldown, AirRange, Footprint, \
+			Attributes, UnitTypeId::ProducedBy, UnitTypeId::Requires, UnitTypeId::AddOn },
+
+		//Attribute names of the table expand to UnitFilterFlag values here
+		constexpr UF Ground = UF::Ground, Air = UF::Air, Light = UF::Light, Armored = UF::Armored, Biological = UF::Biological,
+			Mechanical = UF::Mechanical, Psionic = UF::Psionic, Massive = UF::Massive, Structure = UF::Structure,
+			Heroic = UF::Heroic, Worker = UF::Worker, Detector = UF::Detector;
+
+		constexpr UnitTypeStats UnitStatsTable[] =
+		{
+			SC2API_UNIT_STATS(SC2API_UNIT_STATS_ROW)
+		};
+
+#undef SC2API_UNIT_STATS_ROW
+
+		//Entry i must describe UnitTypeId i; recursive to stay within C++11 constexpr rules
+		constexpr bool IsUnitStatsTableOrdered(size_t index)
+		{
+			return index == static_cast<size_t>(UnitTypeId::Count)
+				|| (UnitStatsTable[index].Id == static_cast<UnitTypeId>(index) && IsUnitStatsTableOrdered(index + 1));
+		}
+
+		static_assert(sizeof(UnitStatsTable) / sizeof(UnitStatsTable[0]) == static_cast<size_t>(UnitTypeId::Count), "Unit stats table size mismatch");
+		static_assert(IsUnitStatsTableOrdered(0), "Unit stats table is out of order");
+	}
+	#pragma endregion
+
+	/// <summary>
+	/// Gets the stats of a unit type. Constant time, and usable in constant expressions.
+	/// </summary>
+	constexpr const UnitTypeStats& GetUnitStats(UnitTypeId id)
+	{
+		return Internal::UnitStatsTable[static_cast<size_t>(id)];
+	}
+
+	/// <summary>
+	/// Gets the structure a structure morphs from in place, e.g. Hatchery for Lair.
+	/// A morphed structure still serves as its base as producer and requirement.
+	/// </summary>
+	/// <returns>The base type, or Invalid if the type is not a morphed structure</returns>
+	constexpr UnitTypeId GetMorphBase(UnitTypeId id)
+	{
+		return id == UnitTypeId::Lair || id == UnitTypeId::Hive || id == UnitTypeId::GreaterSpire
+			|| id == UnitTypeId::OrbitalCommand || id == UnitTypeId::PlanetaryFortress || id == UnitTypeId::WarpGate
+			? GetUnitStats(id).ProducedBy : UnitTypeId::Invalid;
+	}
+
+	/// <summary>
+	/// Gets the id of a unit type name, see SC2API::Units. Convert once at the API boundary and keep the id.
+	/// </summary>
+	/// <returns>The id, or empty value if the type is not in the table</returns>
+	inline Optional<UnitTypeId> UnitTypeIdFromName(const std::string& unitType)
+	{
+		static const std::unordered_map<std::string, UnitTypeId> ids =
+		{
+#define SC2API_UNIT_STATS_NAME(Id, ...) { Units::Id, UnitTypeId::Id },
+			SC2API_UNIT_STATS(SC2API_UNIT_STATS_NAME)
+#undef SC2API_UNIT_STATS_NAME
+		};
+		const auto it = ids.find(unitType);
+		if (it == ids.end())
+		{
+			return{};
+		}
+		return it->second;
+	}
+
+	/// <summary>
+	/// Gets the type id of a unit.
+	/// </summary>
+	/// <returns>The id, or empty value if the unit is inaccessible or its type is not in the table</returns>
+	inline Optional<UnitTypeId> GetUnitTypeId(const Unit& unit)
+	{
+		const Optional<std::string> type = SC2API_COUNT_CALL(UnitGetType, unit.GetType());
+		if (!type.hasValue())
+		{
+			return{};
+		}
+		return UnitTypeIdFromName(type.value());
+	}
+}
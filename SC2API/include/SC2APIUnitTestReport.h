@@ -0,0 +1,359 @@
+#pragma once
+#include "SC2APIBenchmarkTest.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Result of one test run by UnitTestScheduler.
+	/// </summary>
+	struct UnitTestResult
+	{
+		std::string Name;
+		bool Success = false;
+		bool TimedOut = false;
+
+		/// <summary>
+		/// Game seconds from SetupTest to the end of the test.
+		/// </summary>
+		double Duration = 0.0;
+
+		/// <summary>
+		/// Wall-clock seconds from SetupTest to the end of the test.
+		/// </summary>
+		double WallDuration = 0.0;
+
+		/// <summary>
+		/// Scheduler clock ticks the test ran for.
+		/// </summary>
+		int GameTicks = 0;
+
+		/// <summary>
+		/// Messages of the failed checks, see ReportUnitTestFailure.
+		/// </summary>
+		std::vector<std::string> Failures;
+
+		/// <summary>
+		/// Whether the test is a BenchmarkTestBase; Benchmark holds its measurements if so.
+		/// </summary>
+		bool IsBenchmark = false;
+		BenchmarkStats Benchmark;
+	};
+
+	/// <summary>
+	/// Selects the tests to run by name and shard, so large suites can be split across machines.
+	/// The pattern has the form "Positive:Patterns-Negative:Patterns", like the filters of other test frameworks:
+	/// a test runs if its name matches any positive pattern (all names if there is none) and no negative pattern.
+	/// In patterns, '*' matches any text and '?' any single character.
+	/// Shards are chosen by a hash of the test name, so every machine agrees on them without sharing the list of tests.
+	/// </summary>
+	struct UnitTestFilter
+	{
+		std::string Pattern;
+		int ShardIndex = 0;
+		int ShardCount = 1;
+
+		bool Matches(const std::string& name) const
+		{
+			const size_t split = Pattern.find('-');
+			const std::string positive = Pattern.substr(0, split);
+			const std::string negative = split != std::string::npos ? Pattern.substr(split + 1) : std::string();
+			if (!positive.empty() && !MatchesAny(positive, name))
+			{
+				return false;
+			}
+			if (!negative.empty() && MatchesAny(negative, name))
+			{
+				return false;
+			}
+			return ShardCount <= 1 || static_cast<int>(Hash(name) % static_cast<uint32_t>(ShardCount)) == ShardIndex;
+		}
+
+		/// <summary>
+		/// Reads the filter from the environment variables SC2API_TEST_FILTER, SC2API_TEST_SHARD_INDEX and
+		/// SC2API_TEST_SHARD_COUNT, as the bot has no command line of its own.
+		/// </summary>
+		static UnitTestFilter FromEnvironment()
+		{
+			UnitTestFilter filter;
+			const char* pattern = std::getenv("SC2API_TEST_FILTER");
+			const char* shardIndex = std::getenv("SC2API_TEST_SHARD_INDEX");
+			const char* shardCount = std::getenv("SC2API_TEST_SHARD_COUNT");
+			if (pattern != nullptr)
+			{
+				filter.Pattern = pattern;
+			}
+			if (shardIndex != nullptr && shardCount != nullptr)
+			{
+				filter.ShardIndex = std::atoi(shardIndex);
+				filter.ShardCount = std::max(std::atoi(shardCount), 1);
+			}
+			return filter;
+		}
+
+		#pragma region Implementations
+	private:
+		static bool MatchesAny(const std::string& patterns, const std::string& name)
+		{
+			size_t begin = 0;
+			for (;;)
+			{
+				const size_t end = patterns.find(':', begin);
+				const std::string pattern = patterns.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+				if (!pattern.empty() && MatchesWildcard(pattern.c_str(), name.c_str()))
+				{
+					return true;
+				}
+				if (end == std::string::npos)
+				{
+					return false;
+				}
+				begin = end + 1;
+			}
+		}
+
+		static bool MatchesWildcard(const char* pattern, const char* name)
+		{
+			//Greedy with backtracking to the last '*'
+			const char* star = nullptr;
+			const char* resume = nullptr;
+			while (*name != '\0')
+			{
+				if (*pattern == '?' || *pattern == *name)
+				{
+					++pattern;
+					++name;
+				}
+				else if (*pattern == '*')
+				{
+					star = pattern++;
+					resume = name;
+				}
+				else if (star != nullptr)
+				{
+					pattern = star + 1;
+					name = ++resume;
+				}
+				else
+				{
+					return false;
+				}
+			}
+			while (*pattern == '*')
+			{
+				++pattern;
+			}
+			return *pattern == '\0';
+		}
+
+		//FNV-1a, stable across compilers unlike std::hash
+		static uint32_t Hash(const std::string& name)
+		{
+			uint32_t hash = 2166136261u;
+			for (const char c : name)
+			{
+				hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+			}
+			return hash;
+		}
+		#pragma endregion
+	};
+
+	/// <summary>
+	/// Writes the results as JUnit XML, read by most continuous integration servers. Game ticks and benchmark
+	/// measurements are written as properties of the test cases.
+	/// </summary>
+	/// <returns>Whether the file could be written</returns>
+	inline bool WriteUnitTestJUnit(const std::string& path, const std::vector<UnitTestResult>& results, const std::string& suiteName = "SC2API");
+
+	/// <summary>
+	/// Writes the results as JSON: the suite totals and one object per test with all fields of UnitTestResult.
+	/// </summary>
+	/// <returns>Whether the file could be written</returns>
+	inline bool WriteUnitTestJson(const std::string& path, const std::vector<UnitTestResult>& results, const std::string& suiteName = "SC2API");
+
+	#pragma region Implementations
+	namespace Internal
+	{
+		inline std::string EscapeXml(const std::string& text)
+		{
+			std::string escaped;
+			escaped.reserve(text.size());
+			for (const char c : text)
+			{
+				switch (c)
+				{
+				case '&': escaped += "&amp;"; break;
+				case '<': escaped += "&lt;"; break;
+				case '>': escaped += "&gt;"; break;
+				case '"': escaped += "&quot;"; break;
+				case '\'': escaped += "&apos;"; break;
+				default:
+					//Control characters other than tab and newlines are not allowed in XML 1.0
+					if (static_cast<unsigned char>(c) >= 0x20 || c == '\t' || c == '\n' || c == '\r')
+					{
+						escaped += c;
+					}
+				}
+			}
+			return escaped;
+		}
+
+		inline std::string EscapeJson(const std::string& text)
+		{
+			std::string escaped;
+			escaped.reserve(text.size());
+			for (const char c : text)
+			{
+				if (c == '"' || c == '\\')
+				{
+					escaped += '\\';
+					escaped += c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20)
+				{
+					char code[8];
+					std::snprintf(code, sizeof(code), "\\u%04x", c);
+					escaped += code;
+				}
+				else
+				{
+					escaped += c;
+				}
+			}
+			return escaped;
+		}
+
+		inline std::string FormatNumber(double value)
+		{
+			char text[32];
+			std::snprintf(text, sizeof(text), "%.6g", value);
+			return text;
+		}
+
+		inline int CountFailures(const std::vector<UnitTestResult>& results)
+		{
+			int failures = 0;
+			for (const UnitTestResult& result : results)
+			{
+				failures += result.Success ? 0 : 1;
+			}
+			return failures;
+		}
+	}
+
+	inline bool WriteUnitTestJUnit(const std::string& path, const std::vector<UnitTestResult>& results, const std::string& suiteName)
+	{
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+		double time = 0.0;
+		for (const UnitTestResult& result : results)
+		{
+			time += result.WallDuration;
+		}
+		const std::string suite = Internal::EscapeXml(suiteName);
+		const std::string counts = "tests=\"" + std::to_string(results.size()) + "\" failures=\"" + std::to_string(Internal::CountFailures(results))
+			+ "\" errors=\"0\" time=\"" + Internal::FormatNumber(time) + "\"";
+		file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+		file << "<testsuites name=\"" << suite << "\" " << counts << ">\n";
+		file << "  <testsuite name=\"" << suite << "\" " << counts << ">\n";
+		for (const UnitTestResult& result : results)
+		{
+			file << "    <testcase name=\"" << Internal::EscapeXml(result.Name) << "\" classname=\"" << suite
+				<< "\" time=\"" << Internal::FormatNumber(result.WallDuration) << "\">\n";
+			file << "      <properties>\n";
+			const auto property = [&file](const char* name, double value)
+			{
+				file << "        <property name=\"" << name << "\" value=\"" << Internal::FormatNumber(value) << "\"/>\n";
+			};
+			property("gameDuration", result.Duration);
+			property("gameTicks", result.GameTicks);
+			if (result.IsBenchmark)
+			{
+				property("benchmark.iterations", result.Benchmark.Iterations);
+				property("benchmark.mean", result.Benchmark.Mean);
+				property("benchmark.stddev", result.Benchmark.StdDev);
+				property("benchmark.min", result.Benchmark.Min);
+				property("benchmark.p50", result.Benchmark.P50);
+				property("benchmark.p90", result.Benchmark.P90);
+				property("benchmark.p99", result.Benchmark.P99);
+				property("benchmark.max", result.Benchmark.Max);
+				property("benchmark.baseline", result.Benchmark.Baseline);
+			}
+			file << "      </properties>\n";
+			if (!result.Success)
+			{
+				std::string details;
+				for (const std::string& failure : result.Failures)
+				{
+					details += failure + "\n";
+				}
+				const std::string message = result.TimedOut ? "Timed out"
+					: !result.Failures.empty() ? result.Failures.front() : "Finished with failure";
+				file << "      <failure type=\"" << (result.TimedOut ? "timeout" : "failure") << "\" message=\""
+					<< Internal::EscapeXml(message) << "\">" << Internal::EscapeXml(details) << "</failure>\n";
+			}
+			file << "    </testcase>\n";
+		}
+		file << "  </testsuite>\n";
+		file << "</testsuites>\n";
+		return static_cast<bool>(file);
+	}
+
+	inline bool WriteUnitTestJson(const std::string& path, const std::vector<UnitTestResult>& results, const std::string& suiteName)
+	{
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file)
+		{
+			return false;
+		}
+		file << "{\n  \"suite\": \"" << Internal::EscapeJson(suiteName) << "\",\n";
+		file << "  \"tests\": " << results.size() << ",\n";
+		file << "  \"failures\": " << Internal::CountFailures(results) << ",\n";
+		file << "  \"results\": [";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const UnitTestResult& result = results[i];
+			file << (i == 0 ? "\n" : ",\n");
+			file << "    {\"name\": \"" << Internal::EscapeJson(result.Name) << "\""
+				<< ", \"success\": " << (result.Success ? "true" : "false")
+				<< ", \"timedOut\": " << (result.TimedOut ? "true" : "false")
+				<< ", \"duration\": " << Internal::FormatNumber(result.Duration)
+				<< ", \"wallDuration\": " << Internal::FormatNumber(result.WallDuration)
+				<< ", \"gameTicks\": " << result.GameTicks
+				<< ", \"failures\": [";
+			for (size_t j = 0; j < result.Failures.size(); ++j)
+			{
+				file << (j == 0 ? "\"" : ", \"") << Internal::EscapeJson(result.Failures[j]) << "\"";
+			}
+			file << "]";
+			if (result.IsBenchmark)
+			{
+				const BenchmarkStats& stats = result.Benchmark;
+				file << ", \"benchmark\": {\"iterations\": " << stats.Iterations
+					<< ", \"gameTicks\": " << stats.GameTicks
+					<< ", \"mean\": " << Internal::FormatNumber(stats.Mean)
+					<< ", \"stddev\": " << Internal::FormatNumber(stats.StdDev)
+					<< ", \"min\": " << Internal::FormatNumber(stats.Min)
+					<< ", \"p50\": " << Internal::FormatNumber(stats.P50)
+					<< ", \"p90\": " << Internal::FormatNumber(stats.P90)
+					<< ", \"p99\": " << Internal::FormatNumber(stats.P99)
+					<< ", \"max\": " << Internal::FormatNumber(stats.Max)
+					<< ", \"baseline\": " << Internal::FormatNumber(stats.Baseline) << "}";
+			}
+			file << "}";
+		}
+		file << (results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+		return static_cast<bool>(file);
+	}
+	#pragma endregion
+}
@@ -0,0 +1,407 @@
+#pragma once
+#include "SC2API.h"
+#include "SC2APIUnit.h"
+#include "SC2APIUnitGroup.h"
+#include "SC2APIGame.h"
+#include "SC2APIPoint.h"
+#include "SC2APIUnitTestSystem.h"
+#include "SC2APIUnitTestReport.h"
+#include "Cheats.h"
+#include "Creator.h"
+#include "Utils.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Base of tests that create all their units inside the region given by the scheduler, so they can run next to
+	/// other tests. Create units around GetRegion().Center instead of GetTownCandidatePositionStandard(); tests that
+	/// create no units and finish inside RunTest qualify as they are.
+	/// The scheduler finds these tests with dynamic_cast: UnitTestBase is exported by SC2API.dll and keeps its layout.
+	/// </summary>
+	class RegionalUnitTestBase : public UnitTestBase
+	{
+	public:
+		//Called by UnitTestScheduler before SetupTest with the region to create units in
+		virtual void SetRegion(const UnitTestRegion& region)
+		{
+			Region = region;
+		}
+
+		const UnitTestRegion& GetRegion() const
+		{
+			return Region;
+		}
+
+	private:
+		UnitTestRegion Region;
+	};
+
+	/// <summary>
+	/// Lays out test regions in a grid.
+	/// </summary>
+	/// <param name="origin">Center of the first region, e.g. GetTownCandidatePositionStandard()</param>
+	/// <param name="columns">Regions along X</param>
+	/// <param name="rows">Regions along Y</param>
+	/// <param name="spacing">Distance between region centers; keep it above sight plus weapon range</param>
+	inline std::vector<UnitTestRegion> GetUnitTestRegionGrid(Point origin, int columns, int rows, double spacing)
+	{
+		std::vector<UnitTestRegion> regions;
+		for (int row = 0; row < rows; ++row)
+		{
+			for (int column = 0; column < columns; ++column)
+			{
+				UnitTestRegion region;
+				region.Index = static_cast<int>(regions.size());
+				region.Center = Point{ origin.X + column * spacing, origin.Y + row * spacing };
+				region.Radius = spacing / 2;
+				regions.push_back(region);
+			}
+		}
+		return regions;
+	}
+
+	/// <summary>
+	/// Runs unit tests concurrently, one per region of the test map, instead of one after another like
+	/// RegisterUnitTest. Tests derived from RegionalUnitTestBase get a free region each; others run alone, after all
+	/// tests before them finished and before any test after them starts.
+	/// Units created while a test runs belong to the test whose region they were created in (to the only running test
+	/// for tests that run alone), see GetTestUnits. Units a test leaves behind are removed after its TeardownTest.
+	/// Needs a single player game, like the cheats. Write the results with WriteUnitTestJUnit or WriteUnitTestJson.
+	/// Failures of tests the scheduler does not run go to the failure handler set before it, so schedulers may nest.
+	/// </summary>
+	class UnitTestScheduler : public SignalObject
+	{
+	public:
+		/// <summary>
+		/// Fires when all added tests finished.
+		/// Connect: void OnAllFinished(int failedCount);
+		/// </summary>
+		Signal<int /*failedCount*/> AllFinished;
+
+		/// <summary>
+		/// Creates a scheduler with one slot per region.
+		/// </summary>
+		/// <param name="regions">Non-overlapping regions, see GetUnitTestRegionGrid</param>
+		/// <param name="clockInterval">Game seconds between checks for finished and timed out tests</param>
+		explicit UnitTestScheduler(std::vector<UnitTestRegion> regions, double clockInterval = 0.125)
+			: ClockInterval(clockInterval)
+		{
+			Slots.resize(std::max<size_t>(regions.size(), 1));
+			for (size_t i = 0; i < regions.size(); ++i)
+			{
+				Slots[i].Region = regions[i];
+			}
+			Unit::SignalUnitCreated().connect(this, &UnitTestScheduler::OnUnitCreated);
+			Unit::SignalUnitDestroyed().connect(this, &UnitTestScheduler::OnUnitDestroyed);
+			PreviousFailureHandler = GetUnitTestFailureHandler();
+			GetUnitTestFailureHandler() = [this](const UnitTestBase& test, std::string const& errorMessage)
+			{
+				for (Slot& slot : Slots)
+				{
+					if (slot.Test.get() == &test)
+					{
+						slot.Failures.push_back(errorMessage);
+						return;
+					}
+				}
+				if (PreviousFailureHandler)
+				{
+					PreviousFailureHandler(test, errorMessage);
+				}
+			};
+		}
+
+		~UnitTestScheduler()
+		{
+			GetUnitTestFailureHandler() = PreviousFailureHandler;
+		}
+
+		void Add(const char* name, InlineCreator<UnitTestBase> creator)
+		{
+			Add(name, Creator<UnitTestBase>(std::move(creator)));
+		}
+
+		//Takes the creators given to RegisterUnitTest
+		void Add(const char* name, Creator<UnitTestBase> creator)
+		{
+			Pending.push_back(Entry{ name, std::move(creator) });
+		}
+
+		/// <summary>
+		/// Runs only the added tests the filter matches, e.g. UnitTestFilter::FromEnvironment(). Set before Run.
+		/// </summary>
+		void SetFilter(UnitTestFilter filter)
+		{
+			Filter = std::move(filter);
+		}
+
+		/// <summary>
+		/// Starts running the added tests. Call once the match started.
+		/// </summary>
+		void Run()
+		{
+			if (Running)
+			{
+				return;
+			}
+			Running = true;
+			Pending.erase(std::remove_if(Pending.begin(), Pending.end(), [this](const Entry& entry)
+			{
+				return !Filter.Matches(entry.Name);
+			}), Pending.end());
+			SignalTimer(ClockInterval, true).connect(this, &UnitTestScheduler::OnTimer);
+			StartPending();
+		}
+
+		bool IsDone() const
+		{
+			return Running && Next >= Pending.size() && GetRunningCount() == 0;
+		}
+
+		const std::vector<UnitTestResult>& GetResults() const
+		{
+			return Results;
+		}
+
+		int GetFailedCount() const
+		{
+			return static_cast<int>(std::count_if(Results.begin(), Results.end(), [](const UnitTestResult& result)
+			{
+				return !result.Success;
+			}));
+		}
+
+		/// <summary>
+		/// Gets the units created by a running test that are still alive.
+		/// </summary>
+		UnitGroup GetTestUnits(const UnitTestBase& test) const
+		{
+			UnitGroup group;
+			for (const Slot& slot : Slots)
+			{
+				if (slot.Test.get() == &test)
+				{
+					for (const Unit& unit : slot.Units)
+					{
+						group.Add(unit);
+					}
+				}
+			}
+			return group;
+		}
+
+		#pragma region Implementations
+	private:
+		struct Entry
+		{
+			std::string Name;
+			Creator<UnitTestBase> Create;
+		};
+
+		struct Slot
+		{
+			UnitTestRegion Region;
+			std::unique_ptr<UnitTestBase> Test;
+			std::string Name;
+			double StartTime = 0.0;
+			int StartTick = 0;
+			std::chrono::steady_clock::time_point StartWallTime;
+			bool HasResult = false;
+			bool Success = false;
+			std::vector<Unit> Units;
+			std::vector<std::string> Failures;
+		};
+
+		double ClockInterval;
+		double Time = 0.0;
+		int Ticks = 0;
+		UnitTestFilter Filter;
+		bool Running = false;
+		bool Exclusive = false;
+		size_t Next = 0;
+		std::vector<Entry> Pending;
+		std::vector<Slot> Slots;
+		std::vector<UnitTestResult> Results;
+		UnitTestFailureHandler PreviousFailureHandler;
+
+		//Next test, created but waiting for the running tests to finish
+		std::unique_ptr<UnitTestBase> Waiting;
+
+		size_t GetRunningCount() const
+		{
+			return std::count_if(Slots.begin(), Slots.end(), [](const Slot& slot)
+			{
+				return slot.Test != nullptr;
+			});
+		}
+
+		void StartPending()
+		{
+			while (Next < Pending.size() && !Exclusive)
+			{
+				const auto free = std::find_if(Slots.begin(), Slots.end(), [](const Slot& slot)
+				{
+					return slot.Test == nullptr;
+				});
+				if (free == Slots.end())
+				{
+					return;
+				}
+				if (Waiting == nullptr)
+				{
+					Waiting = Pending[Next].Create();
+				}
+				if (dynamic_cast<RegionalUnitTestBase*>(Waiting.get()) == nullptr)
+				{
+					//Runs alone in the first region
+					if (GetRunningCount() > 0)
+					{
+						return;
+					}
+					Exclusive = true;
+					Start(Slots.front(), std::move(Waiting));
+					return;
+				}
+				Start(*free, std::move(Waiting));
+			}
+		}
+
+		void Start(Slot& slot, std::unique_ptr<UnitTestBase> test)
+		{
+			slot.Test = std::move(test);
+			slot.Name = Pending[Next].Name;
+			slot.StartTime = Time;
+			slot.StartTick = Ticks;
+			slot.StartWallTime = std::chrono::steady_clock::now();
+			slot.HasResult = false;
+			slot.Units.clear();
+			slot.Failures.clear();
+			++Next;
+
+			Slot* const started = &slot;
+			//Tests may report several times or from inside RunTest; the first report counts and is handled on the clock
+			slot.Test->Finished.connect(this, std::function<void(bool)>([started](bool success)
+			{
+				if (!started->HasResult)
+				{
+					started->HasResult = true;
+					started->Success = success;
+				}
+			}));
+			RegionalUnitTestBase* const regional = dynamic_cast<RegionalUnitTestBase*>(slot.Test.get());
+			if (regional != nullptr)
+			{
+				regional->SetRegion(slot.Region);
+			}
+			slot.Test->SetupTest();
+			slot.Test->RunTest();
+		}
+
+		void Finish(Slot& slot, bool timedOut)
+		{
+			UnitTestResult result;
+			result.Name = slot.Name;
+			result.Success = slot.HasResult && slot.Success;
+			result.TimedOut = timedOut;
+			result.Duration = Time - slot.StartTime;
+			result.WallDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - slot.StartWallTime).count();
+			result.GameTicks = Ticks - slot.StartTick;
+			result.Failures = slot.Failures;
+			const BenchmarkTestBase* benchmark = dynamic_cast<const BenchmarkTestBase*>(slot.Test.get());
+			if (benchmark != nullptr)
+			{
+				result.IsBenchmark = true;
+				result.Benchmark = benchmark->GetStats();
+			}
+			Results.push_back(result);
+			SC2API_LOG(result.Success ? "[PASS] " : timedOut ? "[TIMEOUT] " : "[FAIL] ", result.Name);
+
+			slot.Test->TeardownTest();
+			slot.Test.reset();
+			for (const Unit& unit : slot.Units)
+			{
+				if (unit.IsAccessible())
+				{
+					CheatRemoveUnit(unit);
+				}
+			}
+			slot.Units.clear();
+			if (&slot == &Slots.front())
+			{
+				Exclusive = false;
+			}
+		}
+
+		Slot* FindOwner(const Unit& unit)
+		{
+			if (Exclusive)
+			{
+				return &Slots.front();
+			}
+			const Optional<Point> position = unit.GetPosition();
+			if (!position.hasValue())
+			{
+				return nullptr;
+			}
+			for (Slot& slot : Slots)
+			{
+				if (slot.Test != nullptr && slot.Region.Contains(position.value()))
+				{
+					return &slot;
+				}
+			}
+			return nullptr;
+		}
+
+		void OnUnitCreated(Unit eventUnit, int /*eventPlayerId*/)
+		{
+			Slot* owner = FindOwner(eventUnit);
+			if (owner != nullptr)
+			{
+				owner->Units.push_back(eventUnit);
+			}
+		}
+
+		void OnUnitDestroyed(Unit eventUnit, Optional<Unit> /*killerUnit*/)
+		{
+			for (Slot& slot : Slots)
+			{
+				slot.Units.erase(std::remove(slot.Units.begin(), slot.Units.end(), eventUnit), slot.Units.end());
+			}
+		}
+
+		void OnTimer()
+		{
+			if (IsDone())
+			{
+				return;
+			}
+			Time += ClockInterval;
+			++Ticks;
+			for (Slot& slot : Slots)
+			{
+				if (slot.Test == nullptr)
+				{
+					continue;
+				}
+				const bool timedOut = !slot.HasResult && Time - slot.StartTime >= slot.Test->GetTimeOutDuration();
+				if (slot.HasResult || timedOut)
+				{
+					Finish(slot, timedOut);
+				}
+			}
+			StartPending();
+			if (IsDone())
+			{
+				AllFinished(GetFailedCount());
+			}
+		}
+		#pragma endregion
+	};
+}
@@ -1,10 +1,57 @@
 #pragma once
+#include <functional>
+#include <sstream>
+#include <string>
 #include <type_traits>
+#include <vector>
 #include "SC2APIPoint.h"
+#include "SC2APILogger.h"
 #include "Creator.h"
 
 namespace SC2API
 {
+	//Area of the test map a test creates its units in, see UnitTestScheduler
+	struct UnitTestRegion
+	{
+		int			Index = 0;
+		Point		Center = {};
+		double		Radius = 0.0;
+
+		bool Contains(const Point& point) const
+		{
+			const double dx = point.X - Center.X;
+			const double dy = point.Y - Center.Y;
+			return dx * dx + dy * dy <= Radius * Radius;
+		}
+	};
+
+	class UnitTestBase;
+
+	//Receives the messages of failed checks next to ReportError, e.g. for the reports of UnitTestScheduler.
+	//Kept outside UnitTestBase, which SC2API.dll exports with a fixed layout.
+	using UnitTestFailureHandler = std::function<void(const UnitTestBase& test, std::string const& errorMessage)>;
+
+	inline UnitTestFailureHandler& GetUnitTestFailureHandler()
+	{
+		static UnitTestFailureHandler handler;
+		return handler;
+	}
+
+	//Reports the error, passes it to the failure handler and fails the test
+	inline void ReportUnitTestFailure(UnitTestBase& test, std::string const& errorMessage);
+
+	#pragma region Implementations
+	namespace Internal
+	{
+		//Characters of checked values are printed as text, not as their code.
+		//Kept outside UnitTestBase, which SC2API.dll exports with a fixed layout.
+		inline std::string StringifyUnitTestChar(char t)
+		{
+			return std::string(1, t);
+		}
+	}
+	#pragma endregion
+
 	class SC2API_API UnitTestBase
 	{
 	public:
@@ -31,8 +78,7 @@ namespace SC2API
 			if (!(valueA == valueB))
 			{
 				std::string thisName{ GetName() };
-				ReportError("TestEqual failed in " + thisName + ": " + stringify(valueA) + " is not equal to " + stringify(valueB));
-				Finished(false);
+				ReportUnitTestFailure(*this, "TestEqual failed in " + thisName + ": " + stringify(valueA) + " is not equal to " + stringify(valueB));
 			}
 		}
 
@@ -42,31 +88,38 @@ namespace SC2API
 			if (!(valueA > valueB))
 			{
 				std::string thisName{ GetName() };
-				ReportError("TestEqual failed in " + thisName + ": " + stringify(valueA) + " is not greater than " + stringify(valueB));
-				Finished(false);
+				ReportUnitTestFailure(*this, "TestGreater failed in " + thisName + ": " + stringify(valueA) + " is not greater than " + stringify(valueB));
 			}
 		}
 
 	protected:
 
 		template<typename T>
-		static std::enable_if_t<std::is_arithmetic_v<T>, std::string> stringify(T t)
+		static std::enable_if_t<std::is_arithmetic<T>::value, std::string> stringify(T t)
 		{
-			return std::to_string(t);
+			return std::is_same<T, char>::value ? Internal::StringifyUnitTestChar(static_cast<char>(t)) : std::to_string(t);
 		}
 
 		template<typename T>
-		static std::enable_if_t<!std::is_arithmetic_v<T>, std::string> stringify(T t)
+		static std::enable_if_t<!std::is_arithmetic<T>::value, std::string> stringify(T t)
 		{
-			return static_cast<std::ostringstream&>(std::ostringstream() << t).str();
+			std::ostringstream stream;
+			stream << t;
+			return stream.str();
 		}
+	};
 
-		template<>
-		static std::string stringify<char>(char t)
+	inline void ReportUnitTestFailure(UnitTestBase& test, std::string const& errorMessage)
+	{
+		//ReportError writes synchronously; lines logged before the failure go first
+		Logger::Get().Flush();
+		test.ReportError(errorMessage);
+		if (GetUnitTestFailureHandler())
 		{
-			return std::string(1, t);
+			GetUnitTestFailureHandler()(test, errorMessage);
 		}
-	};
+		test.Finished(false);
+	}
 
 	//Helper functions to interact with setups in the test map
 
@@ -0,0 +1,183 @@
+#pragma once
+#include "SC2API.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SC2API
+{
+	/// <summary>
+	/// Fixed set of threads running parallel loops, so searches that run a loop every tick do not pay for starting
+	/// threads each time. The threads start with the first loop and sleep between loops. The calling thread works too,
+	/// so a pool of one thread runs everything inline.
+	/// Owners that live in static storage of a bot DLL should destroy the pool in the cleanup export: joining a thread
+	/// while the DLL unloads can deadlock.
+	/// </summary>
+	class WorkerPool
+	{
+	public:
+		/// <summary>
+		/// Creates a pool, without starting its threads yet.
+		/// </summary>
+		/// <param name="threads">Threads running a loop including the calling one, hardware concurrency if 0</param>
+		explicit WorkerPool(unsigned threads = 0)
+			: ThreadCount(std::max(1u, threads != 0 ? threads : std::thread::hardware_concurrency()))
+		{
+		}
+
+		~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				Stopping = true;
+			}
+			Wake.notify_all();
+			for (std::thread& worker : Workers)
+			{
+				worker.join();
+			}
+		}
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		unsigned GetThreadCount() const
+		{
+			return ThreadCount;
+		}
+
+		/// <summary>
+		/// Calls the body once per task index in [0, count), spread over the threads, and returns when all calls
+		/// returned. Tasks are handed out in index order but may run in any order and concurrently.
+		/// Loops of different threads run one after another. A loop started from a body of the same pool runs on the
+		/// thread of that body, since the other threads are busy with the outer loop.
+		/// When a body throws, the tasks not started yet are skipped and the first exception is rethrown once all
+		/// running bodies returned.
+		/// </summary>
+		void ParallelFor(size_t count, const std::function<void(size_t)>& body)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+			if (ThreadCount == 1 || count == 1 || RunningPool() == this)
+			{
+				for (size_t task = 0; task < count; ++task)
+				{
+					body(task);
+				}
+				return;
+			}
+			std::lock_guard<std::mutex> loop(LoopMutex);
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				if (Workers.empty())
+				{
+					for (unsigned i = 1; i < ThreadCount; ++i)
+					{
+						Workers.emplace_back(&WorkerPool::Run, this);
+					}
+				}
+				Body = &body;
+				TaskCount = count;
+				Error = nullptr;
+				NextTask.store(0, std::memory_order_relaxed);
+				Busy = static_cast<unsigned>(Workers.size());
+				++Generation;
+			}
+			Wake.notify_all();
+			RunTasks(body, count);
+			std::unique_lock<std::mutex> lock(Mutex);
+			Idle.wait(lock, [this]() { return Busy == 0; });
+			Body = nullptr;
+			if (Error != nullptr)
+			{
+				std::exception_ptr error = nullptr;
+				std::swap(error, Error);
+				lock.unlock();
+				std::rethrow_exception(error);
+			}
+		}
+
+		#pragma region Implementations
+	private:
+		const unsigned ThreadCount;
+		std::vector<std::thread> Workers;
+
+		//Held for a whole loop, so loops from different threads do not mix
+		std::mutex LoopMutex;
+
+		std::mutex Mutex;
+		std::condition_variable Wake;
+		std::condition_variable Idle;
+		const std::function<void(size_t)>* Body = nullptr;
+		size_t TaskCount = 0;
+		uint64_t Generation = 0;
+		unsigned Busy = 0;
+		bool Stopping = false;
+		std::exception_ptr Error;
+		std::atomic<size_t> NextTask{ 0 };
+
+		//Pool whose tasks the current thread runs, to run nested loops inline instead of waiting for busy threads
+		static const WorkerPool*& RunningPool()
+		{
+			static thread_local const WorkerPool* pool = nullptr;
+			return pool;
+		}
+
+		//Catches what the body throws, so the loop still waits for the other threads before rethrowing
+		void RunTasks(const std::function<void(size_t)>& body, size_t count)
+		{
+			const WorkerPool* outer = RunningPool();
+			RunningPool() = this;
+			try
+			{
+				for (size_t task = NextTask.fetch_add(1, std::memory_order_relaxed); task < count; task = NextTask.fetch_add(1, std::memory_order_relaxed))
+				{
+					body(task);
+				}
+			}
+			catch (...)
+			{
+				NextTask.store(count, std::memory_order_relaxed);
+				std::lock_guard<std::mutex> lock(Mutex);
+				if (Error == nullptr)
+				{
+					Error = std::current_exception();
+				}
+			}
+			RunningPool() = outer;
+		}
+
+		void Run()
+		{
+			uint64_t seen = 0;
+			std::unique_lock<std::mutex> lock(Mutex);
+			for (;;)
+			{
+				Wake.wait(lock, [this, seen]() { return Stopping || Generation != seen; });
+				if (Stopping)
+				{
+					return;
+				}
+				seen = Generation;
+				const std::function<void(size_t)>& body = *Body;
+				const size_t count = TaskCount;
+				lock.unlock();
+				RunTasks(body, count);
+				lock.lock();
+				if (--Busy == 0)
+				{
+					Idle.notify_one();
+				}
+			}
+		}
+		#pragma endregion
+	};
+}
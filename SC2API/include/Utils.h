@@ -10,12 +10,15 @@ namespace SC2API
 	SC2API_API void LogLoader(std::string message);
 }
 
-//Outputs a warning message to loader window if expression evaluates to false
+//After LogLoader, which the logger writes to
+#include "SC2APILogger.h"
+
+//Outputs a warning message to loader window through the logger if expression evaluates to false
 #define SC2API_ASSERT(expr)												\
 do 																		\
 {																		\
 	if ((expr) != true)													\
 	{																	\
-		SC2API::LogLoader("ASSERT failed: " #expr " at " __FUNCTION__);	\
+		SC2API_LOG("ASSERT failed: " #expr " at ", __FUNCTION__);		\
 	}																	\
 } while (0)
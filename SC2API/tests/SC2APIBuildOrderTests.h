@@ -0,0 +1,251 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIBuildOrder.h"
+#include "SC2API/include/SC2APIUnitStats.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/SC2APIBenchmarkTest.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			//Opening of a standard game: 12 workers, a town hall and 50 minerals
+			inline BuildOrderState GetBuildOrderStart(UnitRace race)
+			{
+				BuildOrderState state;
+				state.Minerals = 50.0f;
+				if (race == UnitRace::Terran)
+				{
+					state.Owned[static_cast<size_t>(UnitTypeId::SCV)] = 12;
+					state.Owned[static_cast<size_t>(UnitTypeId::CommandCenter)] = 1;
+				}
+				else if (race == UnitRace::Protoss)
+				{
+					state.Owned[static_cast<size_t>(UnitTypeId::Probe)] = 12;
+					state.Owned[static_cast<size_t>(UnitTypeId::Nexus)] = 1;
+				}
+				else
+				{
+					state.Owned[static_cast<size_t>(UnitTypeId::Drone)] = 12;
+					state.Owned[static_cast<size_t>(UnitTypeId::Hatchery)] = 1;
+					state.Owned[static_cast<size_t>(UnitTypeId::Overlord)] = 1;
+					state.Larva = 3.0f;
+				}
+				return state;
+			}
+
+			inline BuildOrderPlan SearchBuildOrder(const BuildOrderState& initial, const BuildOrderTarget& target, unsigned threads)
+			{
+				BuildOrderSearch search;
+				search.Threads = threads;
+				search.Start(initial, target);
+				search.Run();
+				return search.GetBestPlan();
+			}
+
+			//Whether the type or a structure morphed from it exists at the given time of the plan
+			inline bool IsBuildOrderTypeReady(const BuildOrderState& initial, const BuildOrderPlan& plan, UnitTypeId type, float time)
+			{
+				const auto isFamily = [type](UnitTypeId candidate)
+				{
+					for (; candidate != UnitTypeId::Invalid; candidate = GetMorphBase(candidate))
+					{
+						if (candidate == type)
+						{
+							return true;
+						}
+					}
+					return false;
+				};
+				for (size_t i = 0; i < initial.Owned.size(); ++i)
+				{
+					if (initial.Owned[i] > 0 && isFamily(static_cast<UnitTypeId>(i)))
+					{
+						return true;
+					}
+				}
+				for (const BuildOrderStep& step : plan.Steps)
+				{
+					if (isFamily(step.Type) && step.StartTime + GetUnitStats(step.Type).BuildTime <= time + 0.01f)
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+
+			//Steps out of order, or started before their producer, requirement or add-on existed
+			inline int CountBuildOrderViolations(const BuildOrderState& initial, const BuildOrderPlan& plan)
+			{
+				int violations = 0;
+				for (size_t i = 0; i < plan.Steps.size(); ++i)
+				{
+					const BuildOrderStep& step = plan.Steps[i];
+					if (i > 0 && step.StartTime < plan.Steps[i - 1].StartTime)
+					{
+						++violations;
+					}
+					const UnitTypeStats& stats = GetUnitStats(step.Type);
+					for (const UnitTypeId prerequisite : { stats.ProducedBy, stats.Requires, stats.AddOn })
+					{
+						if (prerequisite != UnitTypeId::Invalid && prerequisite != UnitTypeId::Larva
+							&& !IsBuildOrderTypeReady(initial, plan, prerequisite, step.StartTime))
+						{
+							++violations;
+						}
+					}
+				}
+				return violations;
+			}
+
+			inline bool HasBuildOrderStep(const BuildOrderPlan& plan, UnitTypeId type)
+			{
+				return std::any_of(plan.Steps.begin(), plan.Steps.end(), [type](const BuildOrderStep& step) { return step.Type == type; });
+			}
+
+			inline bool IsSameBuildOrder(const BuildOrderPlan& a, const BuildOrderPlan& b)
+			{
+				return a.FinishTime == b.FinishTime && a.Steps.size() == b.Steps.size()
+					&& std::equal(a.Steps.begin(), a.Steps.end(), b.Steps.begin(), [](const BuildOrderStep& x, const BuildOrderStep& y)
+					{
+						return x.Type == y.Type && x.StartTime == y.StartTime;
+					});
+			}
+		}
+
+		//Fixed goals from a standard opening: valid plans, finishing when they did when the test was written
+		class BuildOrderTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "BuildOrder"; }
+			float GetTimeOutDuration() const override { return 10.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				struct Goal
+				{
+					UnitRace Race;
+					UnitTypeId Type;
+					uint16_t Count;
+					float FinishTime;
+					std::vector<UnitTypeId> Prerequisites;
+				};
+				for (const Goal& goal : std::vector<Goal>{
+					{ UnitRace::Terran, UnitTypeId::Marine, 4, 117.94f, { UnitTypeId::SupplyDepot, UnitTypeId::Barracks } },
+					{ UnitRace::Terran, UnitTypeId::SiegeTank, 2, 196.39f, { UnitTypeId::Refinery, UnitTypeId::Barracks, UnitTypeId::Factory, UnitTypeId::FactoryTechLab } },
+					{ UnitRace::Zerg, UnitTypeId::Roach, 8, 202.28f, { UnitTypeId::Extractor, UnitTypeId::SpawningPool, UnitTypeId::RoachWarren, UnitTypeId::Overlord } },
+					{ UnitRace::Protoss, UnitTypeId::Stalker, 2, 134.39f, { UnitTypeId::Pylon, UnitTypeId::Assimilator, UnitTypeId::Gateway, UnitTypeId::CyberneticsCore } },
+				})
+				{
+					const BuildOrderState initial = Internal::GetBuildOrderStart(goal.Race);
+					const BuildOrderPlan plan = Internal::SearchBuildOrder(initial, BuildOrderTarget().Add(goal.Type, goal.Count), 1);
+					TestGreater(0.5f, std::abs(plan.FinishTime - goal.FinishTime));
+					TestEqual(Internal::CountBuildOrderViolations(initial, plan), 0);
+					for (const UnitTypeId prerequisite : goal.Prerequisites)
+					{
+						TestEqual(Internal::HasBuildOrderStep(plan, prerequisite), true);
+					}
+					float finish = 0.0f;
+					int count = 0;
+					for (const BuildOrderStep& step : plan.Steps)
+					{
+						if (step.Type == goal.Type)
+						{
+							++count;
+							finish = std::max(finish, step.StartTime + GetUnitStats(step.Type).BuildTime);
+						}
+					}
+					TestEqual(count, static_cast<int>(goal.Count));
+					TestEqual(finish, plan.FinishTime);
+				}
+
+				//A target already reached needs no steps; one that cannot be reached in time has no plan
+				BuildOrderSearch search;
+				search.Threads = 1;
+				search.Start(Internal::GetBuildOrderStart(UnitRace::Terran), BuildOrderTarget().Add(UnitTypeId::SCV, 12));
+				TestEqual(search.IsDone(), true);
+				TestEqual(search.HasPlan(), true);
+				TestEqual(search.GetBestPlan().FinishTime, 0.0f);
+				TestEqual(search.GetBestPlan().Steps.size(), 0u);
+				search.MaxTime = 60.0f;
+				search.Start(Internal::GetBuildOrderStart(UnitRace::Terran), BuildOrderTarget().Add(UnitTypeId::Battlecruiser, 1));
+				TestEqual(search.Run(), false);
+				Finished(true);
+			}
+		};
+
+		//The plan depends neither on the number of threads nor on how the search is sliced
+		class BuildOrderDeterminismTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "BuildOrderDeterminism"; }
+			float GetTimeOutDuration() const override { return 10.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				const BuildOrderState zerg = Internal::GetBuildOrderStart(UnitRace::Zerg);
+				const BuildOrderTarget roaches = BuildOrderTarget().Add(UnitTypeId::Roach, 8).Add(UnitTypeId::Queen, 2);
+				const BuildOrderPlan expected = Internal::SearchBuildOrder(zerg, roaches, 1);
+				TestEqual(expected.Steps.empty(), false);
+				for (const unsigned threads : { 2u, 3u, 8u })
+				{
+					TestEqual(Internal::IsSameBuildOrder(Internal::SearchBuildOrder(zerg, roaches, threads), expected), true);
+				}
+
+				//A deadline already passed expands one layer per call
+				BuildOrderSearch search;
+				search.Threads = 2;
+				search.Start(zerg, roaches);
+				size_t slices = 0;
+				while (!search.Step(std::chrono::steady_clock::now()))
+				{
+					++slices;
+					TestEqual(search.GetLayerCount(), slices);
+				}
+				TestGreater(slices, 1u);
+				TestEqual(Internal::IsSameBuildOrder(search.GetBestPlan(), expected), true);
+				Finished(true);
+			}
+		};
+
+		//Plans the eight roaches of BuildOrderTest on the threads of the machine
+		class BuildOrderBenchmark : public BenchmarkTestBase
+		{
+		public:
+			const char* GetName() const override { return "BuildOrderSearch"; }
+			float GetTimeOutDuration() const override { return 30.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+		protected:
+			void RunIteration() override
+			{
+				Search.Start(Internal::GetBuildOrderStart(UnitRace::Zerg), BuildOrderTarget().Add(UnitTypeId::Roach, 8));
+				Search.Run();
+				Sink = Search.GetBestPlan().FinishTime;
+			}
+
+		private:
+			BuildOrderSearch Search;
+			volatile float Sink = 0.0f;
+		};
+
+		inline void RegisterBuildOrderTests()
+		{
+			RegisterUnitTest("BuildOrder", Creator<BuildOrderTest>());
+			RegisterUnitTest("BuildOrderDeterminism", Creator<BuildOrderDeterminismTest>());
+			RegisterUnitTest("BuildOrderSearch", Creator<BuildOrderBenchmark>());
+		}
+	}
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APICombatSimulator.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIUnitGroup.h"
+#include "SC2API/include/SC2APIUnitStats.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/SC2APIBenchmarkTest.h"
+#if defined(SC2API_HEADLESS)
+#include "SC2API/headless/SC2APIHeadless.h"
+#endif
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			//Army of full health units from the unit stats table
+			inline CombatArmy GetCombatArmy(const std::vector<std::pair<std::string, int>>& units)
+			{
+				CombatArmy army;
+				for (const std::pair<std::string, int>& entry : units)
+				{
+					const UnitTypeStats& stats = GetUnitStats(UnitTypeIdFromName(entry.first).value());
+					for (int i = 0; i < entry.second; ++i)
+					{
+						army.Add(GetCombatStats(entry.first).value(), stats.Life + stats.Shield);
+					}
+				}
+				return army;
+			}
+
+			//Stats with damage and cooldowns that are exact in binary, so outcomes can be worked out by hand
+			inline CombatStats GetExactCombatStats(float armor, bool isAir, float groundDamage, float groundCooldown, float airDamage = 0.0f, float airCooldown = 0.0f)
+			{
+				return CombatStats{ armor, isAir, groundDamage, groundCooldown, airDamage, airCooldown };
+			}
+		}
+
+		//Outcomes worked out by hand for the default time step of a quarter second
+		class CombatSimulatorTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "CombatSimulator"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				CombatSimulator simulator;
+				const CombatStats soldier = Internal::GetExactCombatStats(0.0f, false, 5.0f, 1.0f);
+
+				//2.5 damage per step against 1.25: the defender falls after four steps, the attacker front unit is at 5
+				CombatArmy attacker, defender;
+				attacker.Add(soldier, 10.0f);
+				attacker.Add(soldier, 10.0f);
+				defender.Add(soldier, 10.0f);
+				CombatOutcome outcome = simulator.Simulate(attacker, defender);
+				TestEqual(static_cast<int>(outcome.Winner), static_cast<int>(CombatWinner::Attacker));
+				TestEqual(outcome.Duration, 1.0f);
+				TestEqual(outcome.AttackerSurvivors, 2u);
+				TestEqual(outcome.DefenderSurvivors, 0u);
+				TestEqual(outcome.AttackerHealth, 15.0f);
+				TestEqual(outcome.DefenderHealth, 0.0f);
+
+				//Damage spills over: 7.5 per step kills one and a half units of 5
+				attacker.Clear();
+				defender.Clear();
+				attacker.Add(Internal::GetExactCombatStats(0.0f, false, 30.0f, 1.0f), 10.0f);
+				for (int i = 0; i < 3; ++i)
+				{
+					defender.Add(Internal::GetExactCombatStats(0.0f, false, 0.0f, 0.0f), 5.0f);
+				}
+				outcome = simulator.Simulate(attacker, defender);
+				TestEqual(outcome.Duration, 0.5f);
+				TestEqual(outcome.DefenderSurvivors, 0u);
+				TestEqual(outcome.AttackerHealth, 10.0f);
+
+				//Armor above the damage leaves MinDamage: 0.5 at two hits per second, 16 steps for 4 health
+				attacker.Clear();
+				defender.Clear();
+				attacker.Add(Internal::GetExactCombatStats(0.0f, false, 1.0f, 0.5f), 20.0f);
+				defender.Add(Internal::GetExactCombatStats(5.0f, false, 0.0f, 0.0f), 4.0f);
+				outcome = simulator.Simulate(attacker, defender);
+				TestEqual(static_cast<int>(outcome.Winner), static_cast<int>(CombatWinner::Attacker));
+				TestEqual(outcome.Duration, 4.0f);
+
+				//Units with both weapons shoot ground targets first: four steps for the ground unit, four for the air unit
+				attacker.Clear();
+				defender.Clear();
+				attacker.Add(Internal::GetExactCombatStats(0.0f, false, 4.0f, 1.0f, 4.0f, 1.0f), 10.0f);
+				defender.Add(Internal::GetExactCombatStats(0.0f, true, 0.0f, 0.0f), 4.0f);
+				defender.Add(Internal::GetExactCombatStats(0.0f, false, 0.0f, 0.0f), 4.0f);
+				outcome = simulator.Simulate(attacker, defender);
+				TestEqual(outcome.Duration, 2.0f);
+				TestEqual(outcome.DefenderSurvivors, 0u);
+
+				//Neither side can hit the other
+				attacker.Clear();
+				defender.Clear();
+				attacker.Add(soldier, 10.0f);
+				defender.Add(Internal::GetExactCombatStats(0.0f, true, 0.0f, 0.0f), 10.0f);
+				outcome = simulator.Simulate(attacker, defender);
+				TestEqual(static_cast<int>(outcome.Winner), static_cast<int>(CombatWinner::Undecided));
+				TestEqual(outcome.Duration, simulator.MaxDuration);
+				TestEqual(outcome.AttackerSurvivors, 1u);
+				TestEqual(outcome.DefenderSurvivors, 1u);
+				Finished(true);
+			}
+		};
+
+		//Symmetric armies draw, and fixed matchups of table stats keep their outcome
+		class CombatSimulatorMatchupTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "CombatSimulatorMatchup"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				CombatSimulator simulator;
+				for (const std::vector<std::pair<std::string, int>>& units : std::vector<std::vector<std::pair<std::string, int>>>{
+					{ { Units::Marine, 10 } },
+					{ { Units::Zergling, 24 }, { Units::Roach, 6 } },
+					{ { Units::Marine, 10 }, { Units::Stalker, 3 }, { Units::VikingFighter, 2 } },
+				})
+				{
+					const CombatArmy army = Internal::GetCombatArmy(units);
+					const CombatOutcome outcome = simulator.Simulate(army, army);
+					TestEqual(static_cast<int>(outcome.Winner), static_cast<int>(CombatWinner::Draw));
+					TestEqual(outcome.AttackerSurvivors, 0u);
+					TestEqual(outcome.DefenderSurvivors, 0u);
+				}
+
+				//Survivors of the attacker and duration; the defender never survives these
+				struct Matchup
+				{
+					std::vector<std::pair<std::string, int>> Attacker;
+					std::vector<std::pair<std::string, int>> Defender;
+					size_t Survivors;
+					float Duration;
+				};
+				for (const Matchup& matchup : std::vector<Matchup>{
+					{ { { Units::Marine, 8 } }, { { Units::Zergling, 8 } }, 4, 5.25f },
+					{ { { Units::Marine, 6 } }, { { Units::Mutalisk, 3 } }, 4, 7.75f },
+					{ { { Units::Stalker, 4 } }, { { Units::Roach, 3 } }, 3, 14.5f },
+				})
+				{
+					const CombatOutcome outcome = simulator.Simulate(Internal::GetCombatArmy(matchup.Attacker), Internal::GetCombatArmy(matchup.Defender));
+					TestEqual(static_cast<int>(outcome.Winner), static_cast<int>(CombatWinner::Attacker));
+					TestEqual(outcome.AttackerSurvivors, matchup.Survivors);
+					TestEqual(outcome.DefenderSurvivors, 0u);
+					TestEqual(outcome.Duration, matchup.Duration);
+				}
+				Finished(true);
+			}
+		};
+
+#if defined(SC2API_HEADLESS)
+		//Armies taken from units of the world draw when mirrored, and a wounded enemy tips the fight
+		class CombatSimulatorUnitsTest : public UnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "CombatSimulatorUnits"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void TeardownTest() override {}
+
+			void SetupTest() override
+			{
+				for (int i = 0; i < 6; ++i)
+				{
+					Headless::SpawnUnit(Units::Marine, Point{ 100.0 + i, 100.0 }, Headless::Settings().LocalPlayer);
+					Wounded = Headless::SpawnUnit(Units::Marine, Point{ 100.0 + i, 104.0 }, Headless::Settings().EnemyPlayer);
+				}
+				//Vision is updated by the step
+				Headless::Step();
+			}
+
+			void RunTest() override
+			{
+				CombatArmy own, enemy;
+				own.Add(UnitGroup::GetAccessibleUnits(UnitFilterFlag::Self));
+				enemy.Add(UnitGroup::GetAccessibleUnits(UnitFilterFlag::Enemy));
+				TestEqual(own.Count(), 6u);
+				TestEqual(enemy.Count(), 6u);
+				CombatSimulator simulator;
+				TestEqual(static_cast<int>(simulator.Simulate(own, enemy).Winner), static_cast<int>(CombatWinner::Draw));
+
+				Headless::SetLife(Wounded, 10.0);
+				enemy.Clear();
+				enemy.Add(UnitGroup::GetAccessibleUnits(UnitFilterFlag::Enemy));
+				float health = 0.0f;
+				for (const float unitHealth : enemy.Health)
+				{
+					health += unitHealth;
+				}
+				TestEqual(health, 5 * own.Health.front() + 10.0f);
+				TestEqual(static_cast<int>(simulator.Simulate(own, enemy).Winner), static_cast<int>(CombatWinner::Attacker));
+				Finished(true);
+			}
+
+		private:
+			Unit Wounded;
+		};
+#endif
+
+		//Mixed armies of a hundred units each, simulated to the end
+		class CombatSimulatorBenchmark : public BenchmarkTestBase
+		{
+		public:
+			const char* GetName() const override { return "CombatSimulate"; }
+			float GetTimeOutDuration() const override { return 30.0f; }
+			void TeardownTest() override {}
+
+			void SetupTest() override
+			{
+				Attacker = Internal::GetCombatArmy({ { Units::Marine, 60 }, { Units::Marauder, 20 }, { Units::VikingFighter, 20 } });
+				Defender = Internal::GetCombatArmy({ { Units::Zergling, 50 }, { Units::Roach, 30 }, { Units::Mutalisk, 20 } });
+			}
+
+		protected:
+			void RunIteration() override
+			{
+				Sink = Simulator.Simulate(Attacker, Defender).Duration;
+			}
+
+		private:
+			CombatSimulator Simulator;
+			CombatArmy Attacker;
+			CombatArmy Defender;
+			volatile float Sink = 0.0f;
+		};
+
+		inline void RegisterCombatSimulatorTests()
+		{
+			RegisterUnitTest("CombatSimulator", Creator<CombatSimulatorTest>());
+			RegisterUnitTest("CombatSimulatorMatchup", Creator<CombatSimulatorMatchupTest>());
+#if defined(SC2API_HEADLESS)
+			RegisterUnitTest("CombatSimulatorUnits", Creator<CombatSimulatorUnitsTest>());
+#endif
+			RegisterUnitTest("CombatSimulate", Creator<CombatSimulatorBenchmark>());
+		}
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIEconomy.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include <memory>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		//Bases founded by town halls, workers moving between them, a refinery that counts once finished, a town hall
+		//morphing in place, and a lost town hall whose base is taken again
+		class EconomyTrackerTest : public UnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "EconomyTracker"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void TeardownTest() override { Tracker.reset(); }
+
+			void SetupTest() override
+			{
+				const int player = Headless::Settings().LocalPlayer;
+				Main = GetTownCandidatePositionStandard();
+				Natural = Point{ Main.X + 30.0, Main.Y };
+				CommandCenter = Headless::SpawnUnit(Units::CommandCenter, Main, player);
+				for (int i = 0; i < 8; ++i)
+				{
+					Headless::SpawnUnit(Units::MineralField, Point{ Main.X - 6.0, Main.Y - 4.0 + i }, 0);
+				}
+				Headless::SpawnUnit(Units::VespeneGeyser, Point{ Main.X, Main.Y + 7.0 }, 0);
+				Headless::SpawnUnit(Units::VespeneGeyser, Point{ Main.X, Main.Y - 7.0 }, 0);
+				for (int i = 0; i < 12; ++i)
+				{
+					Workers.push_back(Headless::SpawnUnit(Units::SCV, Point{ Main.X + 2.0, Main.Y - 3.0 + 0.5 * i }, player));
+				}
+				//Resources of the natural, not near a base yet
+				for (int i = 0; i < 4; ++i)
+				{
+					Headless::SpawnUnit(Units::MineralField, Point{ Natural.X + 6.0, Natural.Y - 2.0 + i }, 0);
+				}
+				Tracker.reset(new EconomyTracker());
+			}
+
+			void RunTest() override
+			{
+				//The main, taken from the units on construction
+				TestEqual(Tracker->GetBases().size(), 1u);
+				TestEqual(Tracker->GetWorkerCount(), 12);
+				const BaseEconomy& main = Tracker->GetBases()[0];
+				TestEqual(main.IsActive, true);
+				TestEqual(main.TownHall == CommandCenter, true);
+				TestEqual(main.MineralFields, 8);
+				TestEqual(main.Geysers, 2);
+				TestEqual(main.Workers, 12);
+				TestEqual(main.GetIdealWorkers(), 16);
+				TestEqual(main.GetMissingWorkers(), 4);
+
+				//A town hall created later founds a base and takes the resources around it
+				const Unit natural = Headless::SpawnUnit(Units::CommandCenter, Natural, Headless::Settings().LocalPlayer);
+				TestEqual(Tracker->GetBases().size(), 2u);
+				TestEqual(Tracker->GetBases()[1].IsActive, true);
+				TestEqual(Tracker->GetBases()[1].MineralFields, 4);
+				TestEqual(Tracker->GetBases()[1].Workers, 0);
+				TestEqual(Tracker->GetLeastSaturatedBase().value(), 1u);
+
+				//Workers count for the base they walked to once Update sees them there
+				for (size_t i = 0; i < 4; ++i)
+				{
+					Headless::SetPosition(Workers[i], Point{ Natural.X + 3.0, Natural.Y + i });
+				}
+				TestEqual(Tracker->GetBases()[1].Workers, 0);
+				Tracker->Update();
+				TestEqual(Tracker->GetBases()[0].Workers, 8);
+				TestEqual(Tracker->GetBases()[1].Workers, 4);
+				TestEqual(Tracker->GetBaseOf(Workers[0]).value(), 1u);
+				TestEqual(Tracker->GetBaseOf(Workers[11]).value(), 0u);
+				TestEqual(Tracker->GetWorkerCount(), 12);
+				TestEqual(Tracker->GetLeastSaturatedBase().value(), 0u);
+
+				//A refinery needs no workers until it is finished
+				const Unit refinery = Headless::SpawnUnit(Units::Refinery, Point{ Main.X, Main.Y + 7.0 }, Headless::Settings().LocalPlayer, true);
+				TestEqual(Tracker->GetBases()[0].GasBuildings, 0);
+				TestEqual(Tracker->GetBases()[0].UnfinishedGasBuildings, 1);
+				TestEqual(Tracker->GetBases()[0].GetIdealWorkers(), 16);
+				Tracker->Update();
+				TestEqual(Tracker->GetBases()[0].GasBuildings, 0);
+				Headless::FinishConstruction(refinery);
+				Tracker->Update();
+				TestEqual(Tracker->GetBases()[0].GasBuildings, 1);
+				TestEqual(Tracker->GetBases()[0].UnfinishedGasBuildings, 0);
+				TestEqual(Tracker->GetBases()[0].GetIdealWorkers(), 19);
+
+				//An Orbital Command keeps the base, also when rebuilt from scratch
+				Headless::MorphUnit(CommandCenter, Units::OrbitalCommand);
+				Tracker->Update();
+				TestEqual(Tracker->GetBases()[0].IsActive, true);
+				TestEqual(Tracker->GetBases()[0].TownHall == CommandCenter, true);
+				Tracker->Refresh();
+				TestEqual(Tracker->GetBases().size(), 2u);
+				TestEqual(Tracker->GetBases()[0].TownHall == CommandCenter, true);
+				TestEqual(Tracker->GetBases()[0].MineralFields, 8);
+				TestEqual(Tracker->GetBases()[0].GasBuildings, 1);
+				TestEqual(Tracker->GetBases()[0].Workers, 8);
+				TestEqual(Tracker->GetBases()[1].Workers, 4);
+
+				//A lost town hall leaves its base inactive and its units without a base, until the spot is taken again
+				Headless::KillUnit(natural);
+				TestEqual(Tracker->GetBases()[1].IsActive, false);
+				TestEqual(Tracker->GetBases()[1].Workers, 0);
+				TestEqual(Tracker->GetBases()[1].MineralFields, 0);
+				TestEqual(Tracker->GetBaseOf(Workers[0]).hasValue(), false);
+				TestEqual(Tracker->GetWorkerCount(), 12);
+				TestEqual(Tracker->GetLeastSaturatedBase().value(), 0u);
+				Headless::SpawnUnit(Units::CommandCenter, Natural, Headless::Settings().LocalPlayer);
+				TestEqual(Tracker->GetBases().size(), 2u);
+				TestEqual(Tracker->GetBases()[1].IsActive, true);
+				TestEqual(Tracker->GetBases()[1].MineralFields, 4);
+				TestEqual(Tracker->GetBases()[1].Workers, 4);
+				Finished(true);
+			}
+
+		private:
+			std::unique_ptr<EconomyTracker> Tracker;
+			Point Main;
+			Point Natural;
+			Unit CommandCenter;
+			std::vector<Unit> Workers;
+		};
+
+		inline void RegisterEconomyTests()
+		{
+			RegisterUnitTest("EconomyTracker", Creator<EconomyTrackerTest>());
+		}
+	}
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIEventLog.h"
+#include "SC2API/include/SC2APIEventLogFormat.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			//Collects what is written, and blocks the writing thread while stalled, as a reader that stopped reading
+			class StalledEventLogBuffer : public std::streambuf
+			{
+			public:
+				void Stall()
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					Stalled = true;
+				}
+
+				void Release()
+				{
+					{
+						std::lock_guard<std::mutex> lock(Mutex);
+						Stalled = false;
+					}
+					Released.notify_all();
+				}
+
+				std::string GetData()
+				{
+					std::lock_guard<std::mutex> lock(Mutex);
+					return Data;
+				}
+
+			protected:
+				std::streamsize xsputn(const char* data, std::streamsize size) override
+				{
+					std::unique_lock<std::mutex> lock(Mutex);
+					Released.wait(lock, [this]() { return !Stalled; });
+					Data.append(data, static_cast<size_t>(size));
+					return size;
+				}
+
+				int_type overflow(int_type c) override
+				{
+					if (traits_type::eq_int_type(c, traits_type::eof()))
+					{
+						return traits_type::not_eof(c);
+					}
+					const char character = traits_type::to_char_type(c);
+					xsputn(&character, 1);
+					return c;
+				}
+
+			private:
+				std::mutex Mutex;
+				std::condition_variable Released;
+				std::string Data;
+				bool Stalled = false;
+			};
+
+			struct DecodedEvent
+			{
+				uint16_t Id;
+				uint32_t Value;
+			};
+
+			//Decodes the records like EventLogDecoder; events must have a UInt32 first field, which is returned with their id
+			inline bool DecodeEventLog(const std::string& data, std::vector<DecodedEvent>& outEvents, uint32_t& outGaps)
+			{
+				size_t offset = 0;
+				const auto read = [&data, &offset](void* value, size_t size)
+				{
+					if (offset + size > data.size())
+					{
+						return false;
+					}
+					std::memcpy(value, data.data() + offset, size);
+					offset += size;
+					return true;
+				};
+				const auto skipString = [&read, &offset]()
+				{
+					uint16_t length;
+					if (!read(&length, sizeof(length)))
+					{
+						return false;
+					}
+					offset += length;
+					return true;
+				};
+
+				uint32_t magic;
+				uint16_t version, unitTypeCount;
+				if (!read(&magic, sizeof(magic)) || !read(&version, sizeof(version)) || !read(&unitTypeCount, sizeof(unitTypeCount))
+					|| magic != EventLogMagic || version != EventLogVersion)
+				{
+					return false;
+				}
+				for (uint16_t i = 0; i < unitTypeCount; ++i)
+				{
+					skipString();
+				}
+
+				std::unordered_map<uint16_t, std::vector<EventFieldType>> formats;
+				outGaps = 0;
+				while (offset < data.size())
+				{
+					uint16_t id;
+					read(&id, sizeof(id));
+					if (id == static_cast<uint16_t>(EventRecordId::Format))
+					{
+						uint16_t formatId;
+						uint8_t count;
+						read(&formatId, sizeof(formatId));
+						skipString();
+						skipString();
+						read(&count, sizeof(count));
+						std::vector<EventFieldType>& types = formats[formatId];
+						types.clear();
+						for (uint8_t i = 0; i < count; ++i)
+						{
+							uint8_t type;
+							read(&type, sizeof(type));
+							types.push_back(static_cast<EventFieldType>(type));
+							skipString();
+						}
+						continue;
+					}
+					if (id == static_cast<uint16_t>(EventRecordId::Time))
+					{
+						offset += sizeof(double);
+						continue;
+					}
+					if (id == static_cast<uint16_t>(EventRecordId::Gap))
+					{
+						offset += sizeof(uint32_t);
+						++outGaps;
+						continue;
+					}
+					const auto format = formats.find(id);
+					if (format == formats.end() || format->second.empty() || format->second.front() != EventFieldType::UInt32)
+					{
+						return false;
+					}
+					DecodedEvent event{ id, 0 };
+					read(&event.Value, sizeof(event.Value));
+					for (size_t i = 1; i < format->second.size(); ++i)
+					{
+						offset += GetEventFieldSize(format->second[i]);
+					}
+					outEvents.push_back(event);
+				}
+				return offset == data.size();
+			}
+
+			constexpr EventFormat<uint32_t> EventLogTestFiller{ 32, "Filler", "{}", { "sequence" } };
+			constexpr EventFormat<uint32_t, Point> EventLogTestLate{ 33, "Late", "{} at {}", { "sequence", "position" } };
+		}
+
+		//Everything written decodes, also when blocks are dropped behind a stalled stream
+		class EventLogTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "EventLog"; }
+			float GetTimeOutDuration() const override { return 10.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				{
+					Internal::StalledEventLogBuffer buffer;
+					std::ostream out(&buffer);
+					{
+						EventLog log(out, 4096, 64);
+						TestEqual(log.IsOpen(), true);
+						log.MarkTime(1.0);
+						for (uint32_t i = 0; i < 3000; ++i)
+						{
+							log.Write(Internal::EventLogTestFiller, i);
+							if (i % 7 == 0)
+							{
+								log.Write(Internal::EventLogTestLate, i, Point{ 1.0, 2.0 });
+							}
+						}
+					}
+					std::vector<Internal::DecodedEvent> events;
+					uint32_t gaps = 0;
+					TestEqual(Internal::DecodeEventLog(buffer.GetData(), events, gaps), true);
+					TestEqual(gaps, 0u);
+					TestEqual(events.size(), static_cast<size_t>(3000 + 3000 / 7 + 1));
+				}
+
+				//A format used for the first time at every offset of a block: the block holding its definition is dropped
+				//when the record does not fit behind it, so the record must move to the next block with its definition
+				int undecodable = 0;
+				int withoutGaps = 0;
+				for (uint32_t filler = 0; filler < 700; ++filler)
+				{
+					Internal::StalledEventLogBuffer buffer;
+					std::ostream out(&buffer);
+					uint64_t dropped = 0;
+					{
+						EventLog log(out, 4096, 1);
+						buffer.Stall();
+						for (uint32_t i = 0; i < 2100 + filler; ++i)
+						{
+							log.Write(Internal::EventLogTestFiller, i);
+						}
+						log.Write(Internal::EventLogTestLate, 0xFFFFu, Point{ 1.0, 2.0 });
+						dropped = log.GetDroppedBlocks();
+						buffer.Release();
+					}
+					std::vector<Internal::DecodedEvent> events;
+					uint32_t gaps = 0;
+					const bool valid = Internal::DecodeEventLog(buffer.GetData(), events, gaps);
+					if (!valid || events.empty() || events.back().Id != Internal::EventLogTestLate.Id || events.back().Value != 0xFFFFu)
+					{
+						++undecodable;
+					}
+					if (dropped == 0 || gaps == 0)
+					{
+						++withoutGaps;
+					}
+				}
+				TestEqual(undecodable, 0);
+				TestEqual(withoutGaps, 0);
+				Finished(true);
+			}
+		};
+
+		inline void RegisterEventLogTests()
+		{
+			RegisterUnitTest("EventLog", Creator<EventLogTest>());
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIFlowField.h"
+#include "SC2API/include/SC2APIPathing.h"
+#include "SC2API/include/SC2APIWorkerPool.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/SC2APIBenchmarkTest.h"
+#include "SC2APIPathingTests.h"
+#include <cstring>
+#include <memory>
+#include <random>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			/// <summary>
+			/// 200 x 200 cells with scattered rocks and walls open at alternating ends, so paths wind through many tiles.
+			/// </summary>
+			inline PathingGrid GetFlowFieldTestGrid()
+			{
+				PathingGrid grid(200, 200, true);
+				std::mt19937 random(33);
+				for (int rock = 0; rock < 600; ++rock)
+				{
+					grid.SetRect(static_cast<int>(random() % 196), static_cast<int>(random() % 196), static_cast<int>(1 + random() % 4), static_cast<int>(1 + random() % 4), false);
+				}
+				for (int x = 20; x < 190; x += 40)
+				{
+					grid.SetRect(x, x % 80 == 20 ? 0 : 12, 2, 188, false);
+				}
+				return grid;
+			}
+
+			//Threads of the tiled builds; fewer build the integration field in one sweep
+			const unsigned FlowFieldThreads = 4;
+		}
+
+		//Fields built in tiles equal the fields built in one sweep
+		class FlowFieldTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "FlowField"; }
+			float GetTimeOutDuration() const override { return 5.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				WorkerPool serial(1);
+				WorkerPool tiled(Internal::FlowFieldThreads);
+				int built = 0;
+				int mismatches = 0;
+				const PathingGrid rows = PathingGrid::FromRows(Internal::GetPathingTestRows());
+				const PathingGrid large = Internal::GetFlowFieldTestGrid();
+				for (const PathingGrid* grid : { &rows, &large })
+				{
+					std::mt19937 random(33);
+					for (int goal = 0; goal < 8; ++goal)
+					{
+						const Point point{ random() % grid->GetWidth() + 0.5, random() % grid->GetHeight() + 0.5 };
+						FlowField expected, actual;
+						const bool valid = expected.Build(*grid, point, serial);
+						TestEqual(actual.Build(*grid, point, tiled), valid);
+						built += valid ? 1 : 0;
+						const size_t cells = static_cast<size_t>(grid->GetWidth()) * grid->GetHeight();
+						if (valid && (std::memcmp(expected.GetCosts(), actual.GetCosts(), cells * sizeof(uint32_t)) != 0
+							|| std::memcmp(expected.GetDirections(), actual.GetDirections(), cells) != 0))
+						{
+							++mismatches;
+						}
+					}
+				}
+				TestGreater(built, 8);
+				TestEqual(mismatches, 0);
+
+				//The closed room of the pathing grid cannot reach the outside
+				FlowField field;
+				TestEqual(field.Build(rows, Point{ 2.5, 2.5 }, tiled), true);
+				TestEqual(field.GetDistance(Point{ 2.5, 2.5 }).value(), 0.0);
+				TestEqual(field.GetDistance(Point{ 60.5, 44.5 }).hasValue(), false);
+				Finished(true);
+			}
+		};
+
+		//Builds a field per iteration, starting the threads in every build; the reference for FlowFieldBuildPool
+		class FlowFieldBuildBenchmark : public BenchmarkTestBase
+		{
+		public:
+			const char* GetName() const override { return "FlowFieldBuild"; }
+			float GetTimeOutDuration() const override { return 30.0f; }
+			void SetupTest() override { Grid = Internal::GetFlowFieldTestGrid(); }
+			void TeardownTest() override {}
+
+		protected:
+			PathingGrid Grid;
+			FlowField Field;
+			volatile uint32_t Sink = 0;
+
+			void RunIteration() override
+			{
+				Field.Build(Grid, Point{ 110.5, 100.5 }, Internal::FlowFieldThreads);
+				Sink = Field.GetCosts()[0];
+			}
+		};
+
+		//Builds a field per iteration on threads kept between builds
+		class FlowFieldBuildPoolBenchmark : public FlowFieldBuildBenchmark
+		{
+		public:
+			const char* GetName() const override { return "FlowFieldBuildPool"; }
+			void TeardownTest() override { Pool.reset(); }
+
+			void SetupTest() override
+			{
+				FlowFieldBuildBenchmark::SetupTest();
+				Pool.reset(new WorkerPool(Internal::FlowFieldThreads));
+			}
+
+		protected:
+			void RunIteration() override
+			{
+				Field.Build(Grid, Point{ 110.5, 100.5 }, *Pool);
+				Sink = Field.GetCosts()[0];
+			}
+
+		private:
+			std::unique_ptr<WorkerPool> Pool;
+		};
+
+		inline void RegisterFlowFieldTests()
+		{
+			RegisterUnitTest("FlowField", Creator<FlowFieldTest>());
+			RegisterUnitTest("FlowFieldBuild", Creator<FlowFieldBuildBenchmark>());
+			RegisterUnitTest("FlowFieldBuildPool", Creator<FlowFieldBuildPoolBenchmark>());
+		}
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIHandleMap.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <unordered_map>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			//Entries of the map that differ from the reference, both ways
+			inline int CountHandleMapDifferences(const HandleMap<int>& map, const std::unordered_map<HandleId, int>& reference)
+			{
+				int wrong = map.Size() != reference.size() ? 1 : 0;
+				size_t visited = 0;
+				map.ForEach([&](HandleId id, const int& value)
+				{
+					++visited;
+					const auto entry = reference.find(id);
+					wrong += entry == reference.end() || entry->second != value ? 1 : 0;
+				});
+				wrong += visited != reference.size() ? 1 : 0;
+				for (const auto& entry : reference)
+				{
+					const int* value = map.Find(entry.first);
+					wrong += value == nullptr || *value != entry.second ? 1 : 0;
+				}
+				return wrong;
+			}
+		}
+
+		//Random inserts, erases and lookups agree with std::unordered_map, over dense and sparse handles, through
+		//growth, backward shifts and clears; the reserved handle 0 is never stored
+		class HandleMapTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "HandleMap"; }
+			float GetTimeOutDuration() const override { return 10.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				HandleMap<int> map;
+				std::unordered_map<HandleId, int> reference;
+				std::mt19937 random(38);
+				int wrong = 0;
+				//Few handles keep the table small and collide often, many let it grow; high handles test the hash
+				const HandleId ranges[] = { 16, 300, 5000, 100000 };
+				HandleId range = ranges[0];
+				for (int op = 0; op < 2000000; ++op)
+				{
+					if (op % 100000 == 0)
+					{
+						range = ranges[(op / 100000) % 4];
+					}
+					const HandleId high = (op / 100000) % 3 == 2 ? 0xFFFF0000u : 0u;
+					const HandleId id = (1 + random() % range) | high;
+					const uint32_t choice = random() % 100;
+					if (choice < 45)
+					{
+						const int value = static_cast<int>(random());
+						wrong += map.Insert(id, value) != value ? 1 : 0;
+						reference[id] = value;
+					}
+					else if (choice < 75)
+					{
+						wrong += map.Erase(id) != (reference.erase(id) == 1) ? 1 : 0;
+					}
+					else
+					{
+						const int* value = map.Find(id);
+						const auto entry = reference.find(id);
+						wrong += (value == nullptr) != (entry == reference.end()) ? 1 : 0;
+						wrong += value != nullptr && entry != reference.end() && *value != entry->second ? 1 : 0;
+						wrong += map.Contains(id) != (entry != reference.end()) ? 1 : 0;
+					}
+
+					if (op % 65536 == 65535)
+					{
+						wrong += Internal::CountHandleMapDifferences(map, reference);
+						//Removes about half the entries, each from the middle of some probe sequence
+						map.EraseIf([](HandleId erased, const int&) { return erased % 2 == 1; });
+						for (auto entry = reference.begin(); entry != reference.end();)
+						{
+							entry = entry->first % 2 == 1 ? reference.erase(entry) : std::next(entry);
+						}
+						wrong += Internal::CountHandleMapDifferences(map, reference);
+					}
+					if (op % 500000 == 499999)
+					{
+						map.Clear();
+						reference.clear();
+						wrong += map.IsEmpty() ? 0 : 1;
+					}
+				}
+				wrong += Internal::CountHandleMapDifferences(map, reference);
+				TestEqual(wrong, 0);
+
+				//Rejected without taking a slot, in an empty map and in a full one
+				HandleMap<int> reserved;
+				reserved.Insert(0, 1);
+				TestEqual(reserved.Size(), 0u);
+				reserved.Insert(7, 2);
+				reserved.Insert(0, 3);
+				TestEqual(reserved.Size(), 1u);
+				TestEqual(reserved.Contains(0), false);
+				TestEqual(reserved.Erase(0), false);
+				TestEqual(*reserved.Find(7), 2);
+				Finished(true);
+			}
+		};
+
+		inline void RegisterHandleMapTests()
+		{
+			RegisterUnitTest("HandleMap", Creator<HandleMapTest>());
+		}
+	}
+}
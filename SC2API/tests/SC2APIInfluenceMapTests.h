@@ -0,0 +1,171 @@
+#pragma once
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIInfluenceMap.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIBenchmarkTest.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			/// <summary>
+			/// 300 enemy zerglings circling a marine that keeps them in vision, each moving a fraction of a cell per tick.
+			/// </summary>
+			class MovingEnemies
+			{
+			public:
+				static const int Count = 300;
+				const float MapSize = 200.0f;
+				const Point Center{ 100.0, 100.0 };
+
+				void Spawn()
+				{
+					Headless::SpawnUnit(Units::Marine, Center, Headless::Settings().LocalPlayer);
+					for (int i = 0; i < Count; ++i)
+					{
+						//Radii 1 to 10, inside the sight range of the marine
+						Radii.push_back(1.0 + 9.0 * i / Count);
+						Angles.push_back(0.37 * i);
+						Enemies.push_back(Headless::SpawnUnit(Units::Zergling, GetPosition(i), Headless::Settings().EnemyPlayer));
+					}
+				}
+
+				void Move()
+				{
+					for (int i = 0; i < Count; ++i)
+					{
+						//About 0.4 map units per tick at the outer radius, as fast as a zergling on creep
+						Angles[i] += 0.04;
+						Headless::SetPosition(Enemies[i], GetPosition(i));
+					}
+				}
+
+				const std::vector<Unit>& GetEnemies() const
+				{
+					return Enemies;
+				}
+
+			private:
+				std::vector<Unit> Enemies;
+				std::vector<double> Radii;
+				std::vector<double> Angles;
+
+				Point GetPosition(int i) const
+				{
+					return Point{ Center.X + Radii[i] * std::cos(Angles[i]), Center.Y + Radii[i] * std::sin(Angles[i]) };
+				}
+			};
+		}
+
+		//Moves the enemies and restamps those that changed cell
+		class InfluenceMapUpdateBenchmark : public BenchmarkTestBase
+		{
+		public:
+			const char* GetName() const override { return "InfluenceMapUpdate"; }
+			float GetTimeOutDuration() const override { return 30.0f; }
+			void TeardownTest() override { Map.reset(); }
+
+			void SetupTest() override
+			{
+				Map.reset(new InfluenceMap(Enemies.MapSize, Enemies.MapSize));
+				Enemies.Spawn();
+			}
+
+		protected:
+			void RunIteration() override
+			{
+				Enemies.Move();
+				Map->Update();
+			}
+
+		private:
+			Internal::MovingEnemies Enemies;
+			std::unique_ptr<InfluenceMap> Map;
+		};
+
+		//Moves the enemies and builds the map again from scratch, the reference for InfluenceMapUpdate
+		class InfluenceMapRebuildBenchmark : public BenchmarkTestBase
+		{
+		public:
+			const char* GetName() const override { return "InfluenceMapRebuild"; }
+			float GetTimeOutDuration() const override { return 30.0f; }
+			void SetupTest() override { Enemies.Spawn(); }
+			void TeardownTest() override {}
+
+		protected:
+			void RunIteration() override
+			{
+				Enemies.Move();
+				InfluenceMap map(Enemies.MapSize, Enemies.MapSize);
+				for (const Unit& enemy : Enemies.GetEnemies())
+				{
+					map.Track(enemy);
+				}
+				Sink = map.GetThreat(InfluenceLayer::Ground, Enemies.Center);
+			}
+
+		private:
+			Internal::MovingEnemies Enemies;
+			volatile float Sink = 0.0f;
+		};
+
+		//The incrementally updated map matches one built from scratch after the enemies moved
+		class InfluenceMapTest : public UnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "InfluenceMap"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void TeardownTest() override {}
+
+			void SetupTest() override
+			{
+				Map.reset(new InfluenceMap(Enemies.MapSize, Enemies.MapSize));
+				Enemies.Spawn();
+			}
+
+			void RunTest() override
+			{
+				TestEqual(Map->GetTrackedCount(), static_cast<size_t>(Internal::MovingEnemies::Count));
+				for (int tick = 0; tick < 50; ++tick)
+				{
+					Enemies.Move();
+					Map->Update();
+				}
+				InfluenceMap rebuilt(Enemies.MapSize, Enemies.MapSize);
+				for (const Unit& enemy : Enemies.GetEnemies())
+				{
+					rebuilt.Track(enemy);
+				}
+				const size_t cells = static_cast<size_t>(rebuilt.GetWidth()) * rebuilt.GetHeight();
+				size_t mismatches = 0;
+				for (const InfluenceLayer layer : { InfluenceLayer::Ground, InfluenceLayer::Air })
+				{
+					//Weights are multiples of 1/256, so the sums are exact whatever the order of the stamps
+					mismatches += !std::equal(Map->GetLayer(layer), Map->GetLayer(layer) + cells, rebuilt.GetLayer(layer)) ? 1 : 0;
+				}
+				TestEqual(mismatches, 0u);
+				TestGreater(Map->GetThreat(InfluenceLayer::Ground, Enemies.Center), 0.0f);
+				Finished(true);
+			}
+
+		private:
+			Internal::MovingEnemies Enemies;
+			std::unique_ptr<InfluenceMap> Map;
+		};
+
+		inline void RegisterInfluenceMapTests()
+		{
+			RegisterUnitTest("InfluenceMap", Creator<InfluenceMapTest>());
+			RegisterUnitTest("InfluenceMapUpdate", Creator<InfluenceMapUpdateBenchmark>());
+			RegisterUnitTest("InfluenceMapRebuild", Creator<InfluenceMapRebuildBenchmark>());
+		}
+	}
+}
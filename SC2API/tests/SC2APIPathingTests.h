@@ -0,0 +1,310 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIPathing.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			/// <summary>
+			/// 64 x 48 cells, 8 x 6 clusters of 8: two long walls with a gap at opposite ends, scattered rocks and a closed
+			/// room in the top right corner whose inside cell (60, 44) cannot be reached.
+			/// </summary>
+			inline std::vector<std::string> GetPathingTestRows()
+			{
+				const int width = 64;
+				const int height = 48;
+				std::vector<std::string> rows(height, std::string(width, '.'));
+				//Row y of the grid is rows[height - 1 - y]
+				const auto block = [&rows, height](int x, int y)
+				{
+					rows[height - 1 - y][x] = '#';
+				};
+				for (int y = 0; y < 40; ++y)
+				{
+					block(21, y);
+				}
+				for (int y = 8; y < height; ++y)
+				{
+					block(42, y);
+				}
+				std::mt19937 random(32);
+				std::uniform_int_distribution<int> column(0, width - 2);
+				std::uniform_int_distribution<int> row(0, height - 2);
+				for (int i = 0; i < 60; ++i)
+				{
+					const int x = column(random);
+					const int y = row(random);
+					block(x, y);
+					block(x + 1, y);
+					block(x, y + 1);
+				}
+				for (int i = 57; i <= 63; ++i)
+				{
+					block(i, 41);
+					block(i, 47);
+					block(57, 41 + i - 57);
+					block(63, 41 + i - 57);
+				}
+				for (int y = 42; y <= 46; ++y)
+				{
+					for (int x = 58; x <= 62; ++x)
+					{
+						rows[height - 1 - y][x] = '.';
+					}
+				}
+				return rows;
+			}
+
+			/// <summary>
+			/// Plain A* over every cell with the rules of PathPlanner: 8-connected, no cutting corners.
+			/// </summary>
+			/// <returns>The distance, or PathUnreachable</returns>
+			inline float GetReferencePathDistance(const PathingGrid& grid, int startX, int startY, int goalX, int goalY)
+			{
+				static const int StepX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+				static const int StepY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+				const int width = grid.GetWidth();
+				const auto heuristic = [goalX, goalY](int x, int y)
+				{
+					const int dx = std::abs(x - goalX);
+					const int dy = std::abs(y - goalY);
+					return static_cast<float>(std::max(dx, dy) - std::min(dx, dy)) + SC2API::Internal::PathDiagonalCost * static_cast<float>(std::min(dx, dy));
+				};
+				if (!grid.IsWalkable(startX, startY) || !grid.IsWalkable(goalX, goalY))
+				{
+					return SC2API::Internal::PathUnreachable;
+				}
+				std::vector<float> dist(static_cast<size_t>(width) * grid.GetHeight(), SC2API::Internal::PathUnreachable);
+				std::vector<std::pair<float, int>> open;
+				dist[startY * width + startX] = 0.0f;
+				open.push_back({ heuristic(startX, startY), startY * width + startX });
+				while (!open.empty())
+				{
+					std::pop_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+					const std::pair<float, int> top = open.back();
+					open.pop_back();
+					const int x = top.second % width;
+					const int y = top.second / width;
+					if (x == goalX && y == goalY)
+					{
+						return dist[top.second];
+					}
+					if (top.first > dist[top.second] + heuristic(x, y))
+					{
+						continue;
+					}
+					for (int direction = 0; direction < 8; ++direction)
+					{
+						const int nx = x + StepX[direction];
+						const int ny = y + StepY[direction];
+						const bool diagonal = direction >= 4;
+						if (!grid.IsWalkable(nx, ny) || (diagonal && (!grid.IsWalkable(nx, y) || !grid.IsWalkable(x, ny))))
+						{
+							continue;
+						}
+						const float g = dist[top.second] + (diagonal ? SC2API::Internal::PathDiagonalCost : 1.0f);
+						if (g < dist[ny * width + nx])
+						{
+							dist[ny * width + nx] = g;
+							open.push_back({ g + heuristic(nx, ny), ny * width + nx });
+							std::push_heap(open.begin(), open.end(), std::greater<std::pair<float, int>>());
+						}
+					}
+				}
+				return SC2API::Internal::PathUnreachable;
+			}
+
+			inline Point GetCellCenter(int x, int y)
+			{
+				return Point{ x + 0.5, y + 0.5 };
+			}
+
+			//Cluster size of the planners under test
+			const int PathClusterSize = 8;
+
+			/// <summary>
+			/// HPA* only crosses cluster borders at entrances, so a path may detour to the entrance nearest to the start and
+			/// to the goal, about a cluster edge each, on top of a small relative error. Never shorter than optimal.
+			/// </summary>
+			inline bool IsWithinOptimalityBound(double distance, float reference)
+			{
+				return distance >= reference - 1e-3 && distance <= reference * 1.1 + 2.0 * PathClusterSize + 1e-3;
+			}
+		}
+
+		/// <summary>
+		/// HPA* against plain A* on a synthetic grid: same reachability, every distance within IsWithinOptimalityBound and
+		/// at most 10% longer than optimal on average, and FindPath returns a walkable path of the length it reports.
+		/// </summary>
+		class PathPlannerTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "PathPlanner"; }
+			float GetTimeOutDuration() const override { return 5.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				const PathingGrid grid = PathingGrid::FromRows(Internal::GetPathingTestRows());
+				PathPlanner planner(grid, Internal::PathClusterSize);
+				std::mt19937 random(4);
+				std::uniform_int_distribution<int> column(0, grid.GetWidth() - 1);
+				std::uniform_int_distribution<int> row(0, grid.GetHeight() - 1);
+				int reachable = 0;
+				int reachabilityMismatches = 0;
+				int beyondBound = 0;
+				int invalidPaths = 0;
+				double ratios = 0.0;
+				for (int query = 0; query < 300; ++query)
+				{
+					const int startX = column(random), startY = row(random), goalX = column(random), goalY = row(random);
+					if (!grid.IsWalkable(startX, startY) || !grid.IsWalkable(goalX, goalY))
+					{
+						continue;
+					}
+					const float reference = Internal::GetReferencePathDistance(grid, startX, startY, goalX, goalY);
+					std::vector<Point> path;
+					const Optional<double> distance = planner.FindPath(Internal::GetCellCenter(startX, startY), Internal::GetCellCenter(goalX, goalY), path);
+					if (distance.hasValue() != (reference != SC2API::Internal::PathUnreachable))
+					{
+						++reachabilityMismatches;
+						continue;
+					}
+					if (!distance.hasValue())
+					{
+						continue;
+					}
+					++reachable;
+					beyondBound += Internal::IsWithinOptimalityBound(distance.value(), reference) ? 0 : 1;
+					ratios += reference > 0.0f ? distance.value() / reference : 1.0;
+					invalidPaths += IsValidPath(grid, path, distance.value()) ? 0 : 1;
+				}
+				TestGreater(reachable, 100);
+				TestEqual(reachabilityMismatches, 0);
+				TestEqual(beyondBound, 0);
+				TestGreater(1.1, ratios / reachable);
+				TestEqual(invalidPaths, 0);
+
+				//Into the closed room, and from a blocked cell
+				std::vector<Point> path{ Point{ 1.0, 1.0 } };
+				TestEqual(planner.FindPath(Internal::GetCellCenter(2, 2), Internal::GetCellCenter(60, 44), path).hasValue(), false);
+				TestEqual(path.empty(), true);
+				TestEqual(planner.PathDistance(Internal::GetCellCenter(60, 44), Internal::GetCellCenter(2, 2)).hasValue(), false);
+				TestEqual(planner.PathDistance(Internal::GetCellCenter(21, 10), Internal::GetCellCenter(2, 2)).hasValue(), false);
+				TestEqual(planner.PathDistance(Internal::GetCellCenter(59, 43), Internal::GetCellCenter(61, 45)).hasValue(), true);
+				Finished(true);
+			}
+
+		private:
+			//Steps between neighbouring walkable cells without cutting corners, adding up to the reported distance
+			static bool IsValidPath(const PathingGrid& grid, const std::vector<Point>& path, double distance)
+			{
+				double length = 0.0;
+				for (size_t i = 1; i < path.size(); ++i)
+				{
+					const int x0 = static_cast<int>(path[i - 1].X), y0 = static_cast<int>(path[i - 1].Y);
+					const int x1 = static_cast<int>(path[i].X), y1 = static_cast<int>(path[i].Y);
+					const int dx = std::abs(x1 - x0), dy = std::abs(y1 - y0);
+					if (dx > 1 || dy > 1 || dx + dy == 0 || !grid.IsWalkable(x1, y1))
+					{
+						return false;
+					}
+					if (dx + dy == 2 && (!grid.IsWalkable(x1, y0) || !grid.IsWalkable(x0, y1)))
+					{
+						return false;
+					}
+					length += dx + dy == 2 ? SC2API::Internal::PathDiagonalCost : 1.0;
+				}
+				return !path.empty() && std::abs(length - distance) < 1e-3;
+			}
+		};
+
+		/// <summary>
+		/// Obstacles mark their clusters dirty; the next query rebuilds them and matches plain A* on the changed grid.
+		/// </summary>
+		class PathPlannerObstacleTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "PathPlannerObstacle"; }
+			float GetTimeOutDuration() const override { return 5.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				//Two rooms joined by a door at (21, 40..47), the gap of the first wall
+				const PathingGrid grid = PathingGrid::FromRows(Internal::GetPathingTestRows());
+				PathPlanner planner(grid, Internal::PathClusterSize);
+				const Point left = Internal::GetCellCenter(3, 30);
+				const Point right = Internal::GetCellCenter(30, 30);
+				const Optional<double> open = planner.PathDistance(left, right);
+				TestEqual(open.hasValue(), true);
+
+				//Closing the door cuts the rooms apart; the clusters on both sides of it were built by the first query
+				const uint32_t version = planner.GetGridVersion();
+				planner.AddObstacle(21, 40, 1, 8);
+				TestGreater(planner.GetGridVersion(), version);
+				TestEqual(planner.PathDistance(left, right).hasValue(), false);
+
+				//Opening it again restores the first distance
+				planner.RemoveObstacle(21, 40, 1, 8);
+				TestEqual(planner.PathDistance(left, right).value(), open.value());
+
+				//Buildings on the way, overlapping and on cluster borders, then removed again one by one
+				std::mt19937 random(15);
+				std::uniform_int_distribution<int> column(0, grid.GetWidth() - 4);
+				std::uniform_int_distribution<int> row(0, grid.GetHeight() - 4);
+				std::vector<std::pair<int, int>> buildings;
+				int mismatches = 0;
+				for (int i = 0; i < 40; ++i)
+				{
+					buildings.push_back({ column(random), row(random) });
+					planner.AddObstacle(buildings.back().first, buildings.back().second, 3, 3);
+					mismatches += MatchesReference(planner, 3, 30, 30, 30) ? 0 : 1;
+					mismatches += MatchesReference(planner, 3, 3, 50, 3) ? 0 : 1;
+				}
+				for (const std::pair<int, int>& building : buildings)
+				{
+					planner.RemoveObstacle(building.first, building.second, 3, 3);
+					mismatches += MatchesReference(planner, 3, 30, 30, 30) ? 0 : 1;
+					mismatches += MatchesReference(planner, 3, 3, 50, 3) ? 0 : 1;
+				}
+				TestEqual(mismatches, 0);
+				TestEqual(planner.PathDistance(left, right).value(), open.value());
+				Finished(true);
+			}
+
+		private:
+			//Same reachability as plain A* on the current grid, and within the optimality bound
+			static bool MatchesReference(PathPlanner& planner, int startX, int startY, int goalX, int goalY)
+			{
+				const float reference = Internal::GetReferencePathDistance(planner.GetGrid(), startX, startY, goalX, goalY);
+				const Optional<double> distance = planner.PathDistance(Internal::GetCellCenter(startX, startY), Internal::GetCellCenter(goalX, goalY));
+				if (!distance.hasValue())
+				{
+					return reference == SC2API::Internal::PathUnreachable;
+				}
+				return reference != SC2API::Internal::PathUnreachable && Internal::IsWithinOptimalityBound(distance.value(), reference);
+			}
+		};
+
+		inline void RegisterPathingTests()
+		{
+			RegisterUnitTest("PathPlanner", Creator<PathPlannerTest>());
+			RegisterUnitTest("PathPlannerObstacle", Creator<PathPlannerObstacleTest>());
+		}
+	}
+}
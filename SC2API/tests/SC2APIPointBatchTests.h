@@ -0,0 +1,236 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIPoint.h"
+#include "SC2API/include/SC2APIPointBatch.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/SC2APIBenchmarkTest.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			//Same seed every run, so every benchmark measures the same points
+			inline std::vector<Point> GetRandomPoints(size_t count, unsigned seed)
+			{
+				std::mt19937 random(seed);
+				std::uniform_real_distribution<double> coordinate(0.0, 200.0);
+				std::vector<Point> points(count);
+				for (Point& point : points)
+				{
+					point.X = coordinate(random);
+					point.Y = coordinate(random);
+				}
+				return points;
+			}
+
+			//Points per batch and origins measured per iteration
+			const size_t PointBatchCount = 4096;
+			const size_t PointBatchOrigins = 64;
+
+			/// <summary>
+			/// Measures nearest point searches from PointBatchOrigins origins over PointBatchCount points.
+			/// </summary>
+			class NearestPointBenchmarkBase : public BenchmarkTestBase
+			{
+			public:
+				float GetTimeOutDuration() const override { return 30.0f; }
+				void TeardownTest() override {}
+
+				void SetupTest() override
+				{
+					Points = GetRandomPoints(PointBatchCount, 26);
+					Origins = GetRandomPoints(PointBatchOrigins, 62);
+				}
+
+			protected:
+				std::vector<Point> Points;
+				std::vector<Point> Origins;
+				volatile size_t Sink = 0;
+			};
+		}
+
+		//Nearest point by Point::Dist, the reference for ArgMinDistDouble and ArgMinDistFloat
+		class PointDistNearestBenchmark : public Internal::NearestPointBenchmarkBase
+		{
+		public:
+			const char* GetName() const override { return "PointDistNearest"; }
+
+		protected:
+			void RunIteration() override
+			{
+				size_t sum = 0;
+				for (const Point& origin : Origins)
+				{
+					double best = std::numeric_limits<double>::infinity();
+					size_t bestIndex = 0;
+					for (size_t i = 0; i < Points.size(); ++i)
+					{
+						const double dist = Point::Dist(origin, Points[i]);
+						if (dist < best)
+						{
+							best = dist;
+							bestIndex = i;
+						}
+					}
+					sum += bestIndex;
+				}
+				Sink = sum;
+			}
+		};
+
+		template<typename T>
+		class ArgMinDistBenchmark : public Internal::NearestPointBenchmarkBase
+		{
+		public:
+			const char* GetName() const override { return std::is_same<T, float>::value ? "ArgMinDistFloat" : "ArgMinDistDouble"; }
+
+			void SetupTest() override
+			{
+				NearestPointBenchmarkBase::SetupTest();
+				Batch.Clear();
+				for (const Point& point : Points)
+				{
+					Batch.Add(point);
+				}
+			}
+
+		protected:
+			void RunIteration() override
+			{
+				size_t sum = 0;
+				for (const Point& origin : Origins)
+				{
+					sum += ArgMinDist(origin, Batch).value();
+				}
+				Sink = sum;
+			}
+
+		private:
+			PointArray<T> Batch;
+		};
+
+		//All distances by Point::Dist, the reference for DistBatchDouble
+		class PointDistAllBenchmark : public Internal::NearestPointBenchmarkBase
+		{
+		public:
+			const char* GetName() const override { return "PointDistAll"; }
+
+			void SetupTest() override
+			{
+				NearestPointBenchmarkBase::SetupTest();
+				Dists.resize(Points.size());
+			}
+
+		protected:
+			void RunIteration() override
+			{
+				for (const Point& origin : Origins)
+				{
+					for (size_t i = 0; i < Points.size(); ++i)
+					{
+						Dists[i] = Point::Dist(origin, Points[i]);
+					}
+				}
+				Sink = static_cast<size_t>(Dists.back());
+			}
+
+		private:
+			std::vector<double> Dists;
+		};
+
+		class DistBatchBenchmark : public Internal::NearestPointBenchmarkBase
+		{
+		public:
+			const char* GetName() const override { return "DistBatchDouble"; }
+
+			void SetupTest() override
+			{
+				NearestPointBenchmarkBase::SetupTest();
+				Batch.Clear();
+				for (const Point& point : Points)
+				{
+					Batch.Add(point);
+				}
+				Dists.resize(Points.size());
+			}
+
+		protected:
+			void RunIteration() override
+			{
+				for (const Point& origin : Origins)
+				{
+					DistBatch(origin, Batch, Dists.data());
+				}
+				Sink = static_cast<size_t>(Dists.back());
+			}
+
+		private:
+			PointArray<double> Batch;
+			std::vector<double> Dists;
+		};
+
+		//The kernels agree with Point::Dist, and ArgMinDist handles empty and non-finite batches
+		class PointBatchTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "PointBatch"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				//Odd count, so the scalar tail runs too
+				const std::vector<Point> points = Internal::GetRandomPoints(1001, 7);
+				const Point origin{ 100.0, 100.0 };
+				PointArray<double> batch;
+				for (const Point& point : points)
+				{
+					batch.Add(point);
+				}
+				std::vector<double> dists(points.size());
+				DistBatch(origin, batch, dists.data());
+				size_t nearest = 0;
+				size_t mismatches = 0;
+				for (size_t i = 0; i < points.size(); ++i)
+				{
+					const double dist = Point::Dist(origin, points[i]);
+					mismatches += std::abs(dists[i] - dist) > 1e-9 ? 1 : 0;
+					nearest = dist < Point::Dist(origin, points[nearest]) ? i : nearest;
+				}
+				TestEqual(mismatches, 0u);
+				TestEqual(ArgMinDist(origin, batch).value(), nearest);
+
+				const double nan = std::numeric_limits<double>::quiet_NaN();
+				const double inf = std::numeric_limits<double>::infinity();
+				PointArray<double> invalid;
+				invalid.Add(Point{ nan, 0.0 });
+				invalid.Add(Point{ inf, inf });
+				invalid.Add(Point{ 0.0, nan });
+				TestEqual(ArgMinDist(origin, invalid).value(), 0u);
+				invalid.Add(Point{ 101.0, 100.0 });
+				TestEqual(ArgMinDist(origin, invalid).value(), 3u);
+				TestEqual(ArgMinDist(origin, PointArray<double>()).hasValue(), false);
+				Finished(true);
+			}
+		};
+
+		inline void RegisterPointBatchTests()
+		{
+			RegisterUnitTest("PointBatch", Creator<PointBatchTest>());
+			RegisterUnitTest("PointDistNearest", Creator<PointDistNearestBenchmark>());
+			RegisterUnitTest("ArgMinDistDouble", Creator<ArgMinDistBenchmark<double>>());
+			RegisterUnitTest("ArgMinDistFloat", Creator<ArgMinDistBenchmark<float>>());
+			RegisterUnitTest("PointDistAll", Creator<PointDistAllBenchmark>());
+			RegisterUnitTest("DistBatchDouble", Creator<DistBatchBenchmark>());
+		}
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/SC2APIBenchmarkTest.h"
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			struct SingletonCounter : public Singleton<SingletonCounter>
+			{
+				int Value = 1;
+			};
+
+			struct StaticLocalCounter
+			{
+				int Value = 1;
+
+				static StaticLocalCounter& instance()
+				{
+					static StaticLocalCounter counter;
+					return counter;
+				}
+			};
+
+			struct ReentrantSingleton : public Singleton<ReentrantSingleton>
+			{
+				ReentrantSingleton()
+				{
+					ReentrantSingleton::instance();
+				}
+			};
+
+			//Calls of instance() per iteration
+			const int SingletonCalls = 1000000;
+		}
+
+		//Hot path of Singleton::instance, compare with StaticLocalInstance
+		class SingletonInstanceBenchmark : public BenchmarkTestBase
+		{
+		public:
+			const char* GetName() const override { return "SingletonInstance"; }
+			float GetTimeOutDuration() const override { return 30.0f; }
+			void SetupTest() override { Internal::SingletonCounter::instance(); }
+			void TeardownTest() override { Internal::SingletonCounter::freeInstance(); }
+
+		protected:
+			void RunIteration() override
+			{
+				int sum = 0;
+				for (int i = 0; i < Internal::SingletonCalls; ++i)
+				{
+					sum += ++Internal::SingletonCounter::instance().Value;
+				}
+				Sink = sum;
+			}
+
+		private:
+			volatile int Sink = 0;
+		};
+
+		//Function-local static with its initialization guard, the baseline for SingletonInstance
+		class StaticLocalInstanceBenchmark : public BenchmarkTestBase
+		{
+		public:
+			const char* GetName() const override { return "StaticLocalInstance"; }
+			float GetTimeOutDuration() const override { return 30.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+		protected:
+			void RunIteration() override
+			{
+				int sum = 0;
+				for (int i = 0; i < Internal::SingletonCalls; ++i)
+				{
+					sum += ++Internal::StaticLocalCounter::instance().Value;
+				}
+				Sink = sum;
+			}
+
+		private:
+			volatile int Sink = 0;
+		};
+
+		//A constructor using its own singleton throws instead of spinning forever
+		class SingletonReentryTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "SingletonReentry"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				bool threw = false;
+				try
+				{
+					Internal::ReentrantSingleton::instance();
+				}
+				catch (const zycore::InvalidUsage&)
+				{
+					threw = true;
+				}
+				TestEqual(threw, true);
+				TestEqual(Internal::ReentrantSingleton::hasInstance(), false);
+				Finished(true);
+			}
+		};
+
+		inline void RegisterSingletonTests()
+		{
+			RegisterUnitTest("SingletonInstance", Creator<SingletonInstanceBenchmark>());
+			RegisterUnitTest("StaticLocalInstance", Creator<StaticLocalInstanceBenchmark>());
+			RegisterUnitTest("SingletonReentry", Creator<SingletonReentryTest>());
+		}
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APITechTree.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include <memory>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		//Construction and in-place morphs driven through Headless::FinishConstruction and Headless::MorphUnit
+		class TechTreeTest : public UnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "TechTree"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void TeardownTest() override { Tree.reset(); }
+
+			void SetupTest() override
+			{
+				const int player = Headless::Settings().LocalPlayer;
+				Hatchery = Headless::SpawnUnit(Units::Hatchery, Point{ 40.0, 40.0 }, player);
+				CommandCenter = Headless::SpawnUnit(Units::CommandCenter, Point{ 60.0, 40.0 }, player);
+				Tree.reset(new TechTree());
+				Gateway = Headless::SpawnUnit(Units::Gateway, Point{ 80.0, 40.0 }, player, true);
+			}
+
+			void RunTest() override
+			{
+				TestEqual(Tree->GetCount(UnitTypeId::Hatchery), 1);
+				TestEqual(Tree->Has(UnitTypeId::Lair), false);
+				TestEqual(Tree->Has(UnitTypeId::Gateway), false);
+
+				//Hatchery to Lair to Hive: the base stays owned throughout
+				Headless::MorphUnit(Hatchery, Units::Lair);
+				Tree->Update();
+				TestEqual(Tree->GetCount(UnitTypeId::Hatchery), 0);
+				TestEqual(Tree->GetCount(UnitTypeId::Lair), 1);
+				TestEqual(Tree->Has(UnitTypeId::Hatchery), true);
+				TestEqual(Tree->Has(UnitTypeId::Lair), true);
+				Headless::MorphUnit(Hatchery, Units::Hive);
+				Tree->Update();
+				TestEqual(Tree->GetCount(UnitTypeId::Lair), 0);
+				TestEqual(Tree->GetCount(UnitTypeId::Hive), 1);
+				TestEqual(Tree->Has(UnitTypeId::Lair), true);
+				TestEqual(Tree->Has(UnitTypeId::Hive), true);
+
+				Headless::MorphUnit(CommandCenter, Units::OrbitalCommand);
+				Tree->Update();
+				TestEqual(Tree->GetCount(UnitTypeId::CommandCenter), 0);
+				TestEqual(Tree->Has(UnitTypeId::CommandCenter), true);
+				TestEqual(Tree->Has(UnitTypeId::OrbitalCommand), true);
+				TestEqual(Tree->Has(UnitTypeId::PlanetaryFortress), false);
+
+				//A structure finished after the tree was created can still morph
+				Headless::FinishConstruction(Gateway);
+				Tree->Update();
+				TestEqual(Tree->GetCount(UnitTypeId::Gateway), 1);
+				Headless::MorphUnit(Gateway, Units::WarpGate);
+				Tree->Update();
+				TestEqual(Tree->GetCount(UnitTypeId::Gateway), 0);
+				TestEqual(Tree->GetCount(UnitTypeId::WarpGate), 1);
+				TestEqual(Tree->Has(UnitTypeId::Gateway), true);
+
+				//Refresh agrees with the incremental state
+				const TechSet owned = Tree->GetOwned();
+				Tree->Refresh();
+				TestEqual(Tree->GetOwned().Contains(owned) && owned.Contains(Tree->GetOwned()), true);
+
+				Headless::KillUnit(Hatchery);
+				TestEqual(Tree->Has(UnitTypeId::Hive), false);
+				TestEqual(Tree->Has(UnitTypeId::Hatchery), false);
+				Finished(true);
+			}
+
+		private:
+			std::unique_ptr<TechTree> Tree;
+			Unit Hatchery;
+			Unit CommandCenter;
+			Unit Gateway;
+		};
+
+		inline void RegisterTechTreeTests()
+		{
+			RegisterUnitTest("TechTree", Creator<TechTreeTest>());
+		}
+	}
+}
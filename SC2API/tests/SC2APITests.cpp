@@ -0,0 +1,52 @@
+//Runs the tests and benchmarks of SC2API/tests on the headless backend, without the game:
+//
+//  g++ -std=c++14 -O2 -pthread -fpermissive -DSC2API_HEADLESS -I../.. -I../../ZyCore SC2APITests.cpp
+//      ../headless/SC2APIHeadless.cpp ../headless/SignalObject.cpp -o sc2api-tests
+//  sc2api-tests
+//
+//Prints a [PASS], [FAIL] or [TIMEOUT] line per test and a [BENCH] line per benchmark; the exit code is the number of
+//failed tests. The environment selects the tests and the reports:
+//
+//  SC2API_TEST_FILTER       Tests to run, e.g. "Pathing*:FlowField-*Benchmark", see UnitTestFilter
+//  SC2API_TEST_SHARD_INDEX  Shard to run, with SC2API_TEST_SHARD_COUNT the number of shards
+//  SC2API_TEST_JUNIT        File to write the results to as JUnit XML
+//  SC2API_TEST_JSON         File to write the results to as JSON
+
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2APILogger.h"
+#include "SC2API/include/SC2APIUnitTestReport.h"
+#include "SC2APITests.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace SC2API;
+
+int main()
+{
+	Headless::Reset();
+	SignalRegisterUnitTests().connect(&Tests::RegisterSC2APITests);
+	Headless::StartMatch();
+	const std::vector<UnitTestResult> results = Headless::RunUnitTests(UnitTestFilter::FromEnvironment());
+	Headless::EndMatch();
+
+	int failed = static_cast<int>(std::count_if(results.begin(), results.end(), [](const UnitTestResult& result)
+	{
+		return !result.Success;
+	}));
+	const char* junitPath = std::getenv("SC2API_TEST_JUNIT");
+	const char* jsonPath = std::getenv("SC2API_TEST_JSON");
+	//A report that cannot be written fails the run, or a CI server would read a stale one
+	if (junitPath != nullptr && !WriteUnitTestJUnit(junitPath, results))
+	{
+		SC2API_LOG("Could not write ", junitPath);
+		++failed;
+	}
+	if (jsonPath != nullptr && !WriteUnitTestJson(jsonPath, results))
+	{
+		SC2API_LOG("Could not write ", jsonPath);
+		++failed;
+	}
+	Logger::Get().Stop();
+	return failed;
+}
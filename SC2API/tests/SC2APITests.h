@@ -0,0 +1,55 @@
+#pragma once
+#include "SC2APISingletonTests.h"
+#include "SC2APIPointBatchTests.h"
+#include "SC2APIPathingTests.h"
+#include "SC2APIWorkerPoolTests.h"
+#include "SC2APIFlowFieldTests.h"
+#include "SC2APICombatSimulatorTests.h"
+#include "SC2APIBuildOrderTests.h"
+#include "SC2APIEventLogTests.h"
+#include "SC2APIHandleMapTests.h"
+#include "SC2APIUnitTestReportTests.h"
+
+//Tests that drive the world through SC2API/headless
+#if defined(SC2API_HEADLESS)
+#include "SC2APIInfluenceMapTests.h"
+#include "SC2APIUnitMotionTests.h"
+#include "SC2APIUnitMemoryTests.h"
+#include "SC2APITechTreeTests.h"
+#include "SC2APIEconomyTests.h"
+#include "SC2APIUnitGroupTests.h"
+#include "SC2APIUnitTestSchedulerTests.h"
+#endif
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		/// <summary>
+		/// Registers the tests and benchmarks of the API. Connect to SignalRegisterUnitTests, or run them on the headless
+		/// backend with SC2APITests.cpp; tests that need the headless backend are only registered there.
+		/// </summary>
+		inline void RegisterSC2APITests()
+		{
+			RegisterSingletonTests();
+			RegisterPointBatchTests();
+			RegisterPathingTests();
+			RegisterWorkerPoolTests();
+			RegisterFlowFieldTests();
+			RegisterCombatSimulatorTests();
+			RegisterBuildOrderTests();
+			RegisterEventLogTests();
+			RegisterHandleMapTests();
+			RegisterUnitTestReportTests();
+#if defined(SC2API_HEADLESS)
+			RegisterInfluenceMapTests();
+			RegisterUnitMotionTests();
+			RegisterUnitMemoryTests();
+			RegisterTechTreeTests();
+			RegisterEconomyTests();
+			RegisterUnitGroupTests();
+			RegisterUnitTestSchedulerTests();
+#endif
+		}
+	}
+}
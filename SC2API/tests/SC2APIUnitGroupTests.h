@@ -0,0 +1,107 @@
+#pragma once
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIUnitGroup.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		//FillUnitGroupState agrees with the per-unit getters, and leaves hidden and dead units zeroed and masked out
+		class UnitGroupStateTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "UnitGroupState"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void TeardownTest() override {}
+
+			void SetupTest() override
+			{
+				const int player = Headless::Settings().LocalPlayer;
+				const int enemy = Headless::Settings().EnemyPlayer;
+				const Point center = GetRegion().Center;
+				//More than 64 units, so the mask takes two words
+				for (int i = 0; i < 66; ++i)
+				{
+					Group.Add(Headless::SpawnUnit(Units::Marine, Point{ center.X - 5.0 + i % 10, center.Y - 5.0 + i / 10 }, player));
+				}
+				Templar = Headless::SpawnUnit(Units::HighTemplar, Point{ center.X + 5.0, center.Y - 5.0 }, player);
+				Stalker = Headless::SpawnUnit(Units::Stalker, Point{ center.X + 7.0, center.Y - 1.0 }, enemy);
+				//At the edge of the region, out of sight of the marines and of the units of other regions
+				Hidden = Headless::SpawnUnit(Units::Zergling, Point{ center.X, center.Y + GetRegion().Radius - 1.0 }, enemy);
+				Dead = Headless::SpawnUnit(Units::Marine, Point{ center.X - 3.0, center.Y + 5.0 }, player);
+				Group.Add(Templar);
+				Group.Add(Stalker);
+				Group.Add(Hidden);
+				Group.Add(Dead);
+				Headless::SetLife(Templar, 20.0);
+				Headless::KillUnit(Dead);
+			}
+
+			void RunTest() override
+			{
+				UnitGroupState state;
+				//Stale content of a larger group is replaced
+				state.Life.assign(200, 1.0f);
+				state.AccessibleMask.assign(8, ~0ULL);
+				FillUnitGroupState(Group, state);
+				TestEqual(state.Count(), 70u);
+				TestEqual(state.Life.size(), 70u);
+				TestEqual(state.AccessibleMask.size(), 2u);
+				TestEqual(state.AccessibleCount, 68u);
+
+				size_t accessible = 0;
+				for (size_t i = 0; i < state.Count(); ++i)
+				{
+					const Unit& unit = state.Units[i];
+					TestEqual(Group.Has(unit), true);
+					const Optional<double> life = unit.GetLife();
+					TestEqual(state.IsAccessible(i), life.hasValue());
+					if (!life.hasValue())
+					{
+						TestEqual(state.Life[i], 0.0f);
+						TestEqual(state.Shield[i], 0.0f);
+						TestEqual(state.Energy[i], 0.0f);
+						TestEqual(state.Owner[i], -1);
+						TestEqual(state.Positions.Get(i).X, 0.0f);
+						continue;
+					}
+					++accessible;
+					TestEqual(state.Life[i], static_cast<float>(life.value()));
+					TestEqual(state.Shield[i], static_cast<float>(unit.GetShield().value()));
+					TestEqual(state.Energy[i], static_cast<float>(unit.GetEnergy().value()));
+					TestEqual(state.Owner[i], unit.GetOwner());
+					TestEqual(state.Positions.Get(i).X, static_cast<float>(unit.GetPosition().value().X));
+					TestEqual(state.Positions.Get(i).Y, static_cast<float>(unit.GetPosition().value().Y));
+					if (unit == Templar)
+					{
+						TestEqual(state.Life[i], 20.0f);
+					}
+					if (unit == Stalker)
+					{
+						TestGreater(state.Shield[i], 0.0f);
+						TestEqual(state.Owner[i], Headless::Settings().EnemyPlayer);
+					}
+					TestEqual(unit == Hidden || unit == Dead, false);
+				}
+				TestEqual(accessible, state.AccessibleCount);
+				Finished(true);
+			}
+
+		private:
+			UnitGroup Group;
+			Unit Templar;
+			Unit Stalker;
+			Unit Hidden;
+			Unit Dead;
+		};
+
+		inline void RegisterUnitGroupTests()
+		{
+			RegisterUnitTest("UnitGroupState", Creator<UnitGroupStateTest>());
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIUnitMemory.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include <memory>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		//Enemies are remembered from entering vision, refreshed while seen, kept at their last position after leaving
+		//it until they are too old, and dropped when they die
+		class UnitMemoryTest : public UnitTestBase, public SignalObject
+		{
+		public:
+			const char* GetName() const override { return "UnitMemory"; }
+			float GetTimeOutDuration() const override { return 3.0f; }
+			void TeardownTest() override { Memory.reset(); }
+
+			void SetupTest() override
+			{
+				//Created first, so it sees the enemies enter vision
+				Memory.reset(new UnitMemory(0.25));
+				Headless::SpawnUnit(Units::Marine, Start, Headless::Settings().LocalPlayer);
+				Seen = Headless::SpawnUnit(Units::Zergling, Point{ Start.X + 4.0, Start.Y }, Headless::Settings().EnemyPlayer);
+				Doomed = Headless::SpawnUnit(Units::Roach, Point{ Start.X, Start.Y + 4.0 }, Headless::Settings().EnemyPlayer);
+				Hidden = Headless::SpawnUnit(Units::Zergling, Point{ Start.X + 30.0, Start.Y }, Headless::Settings().EnemyPlayer);
+			}
+
+			void RunTest() override
+			{
+				const UnitSnapshot* seen = Memory->Get(Seen);
+				TestEqual(seen != nullptr, true);
+				if (seen == nullptr)
+				{
+					return;
+				}
+				TestEqual(seen->Type == UnitTypeId::Zergling, true);
+				TestEqual(seen->Position.X, Start.X + 4.0);
+				TestEqual(seen->IsEnemy, true);
+				TestEqual(seen->IsVisible, true);
+				TestEqual(seen->Time, 0.0);
+				TestEqual(Memory->Get(Hidden) == nullptr, true);
+				TestEqual(Memory->GetSnapshots().Size(), 2u);
+
+				Headless::KillUnit(Doomed);
+				TestEqual(Memory->Get(Doomed) == nullptr, true);
+
+				Headless::SetPosition(Seen, LastSeen);
+				Headless::SetLife(Seen, 20.0);
+				SignalTimer(0.5, false).connect(this, &UnitMemoryTest::OnRefreshed);
+			}
+
+		private:
+			const Point Start{ 50.0, 50.0 };
+			const Point LastSeen{ 56.0, 50.0 };
+			std::unique_ptr<UnitMemory> Memory;
+			Unit Seen;
+			Unit Doomed;
+			Unit Hidden;
+
+			//Visible units follow the clock of the memory
+			void OnRefreshed()
+			{
+				const UnitSnapshot& seen = *Memory->Get(Seen);
+				TestEqual(seen.Position.X, LastSeen.X);
+				TestEqual(seen.Life, 20.0f);
+				TestGreater(seen.Time, 0.0);
+				TestGreater(Memory->GetTime(), 0.0);
+
+				//Out of sight: a plain move is not seen, so the snapshot stays where the unit was last
+				Headless::SetPosition(Seen, Point{ Start.X + 40.0, Start.Y });
+				SignalTimer(0.5, false).connect(this, &UnitMemoryTest::OnLeft);
+			}
+
+			void OnLeft()
+			{
+				const UnitSnapshot& seen = *Memory->Get(Seen);
+				TestEqual(seen.IsVisible, false);
+				TestEqual(seen.Position.X, LastSeen.X);
+				TestEqual(Memory->GetLastPosition(Seen).value().X, LastSeen.X);
+				TestGreater(Memory->GetTime(), seen.Time);
+
+				//Kept while younger than the age
+				Memory->ForgetOlderThan(2.0);
+				TestEqual(Memory->Get(Seen) != nullptr, true);
+				SignalTimer(1.0, false).connect(this, &UnitMemoryTest::OnForgotten);
+			}
+
+			void OnForgotten()
+			{
+				Memory->ForgetOlderThan(0.75);
+				TestEqual(Memory->Get(Seen) == nullptr, true);
+				TestEqual(Memory->GetLastPosition(Seen).hasValue(), false);
+				TestEqual(Memory->GetSnapshots().Size(), 0u);
+				Finished(true);
+			}
+		};
+
+		inline void RegisterUnitMemoryTests()
+		{
+			RegisterUnitTest("UnitMemory", Creator<UnitMemoryTest>());
+		}
+	}
+}
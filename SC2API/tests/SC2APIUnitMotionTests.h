@@ -0,0 +1,94 @@
+#pragma once
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIUnitGroup.h"
+#include "SC2API/include/SC2APIUnitMotion.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include <memory>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		//Velocities recovered from recorded trajectories fed through Headless::SetPosition
+		class UnitMotionTest : public UnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "UnitMotion"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void TeardownTest() override { Tracker.reset(); }
+
+			void SetupTest() override
+			{
+				//Created first, so it sees the zergling enter vision
+				Tracker.reset(new UnitMotionTracker(Tick));
+				Headless::SpawnUnit(Units::Marine, Point{ 50.0, 50.0 }, Headless::Settings().LocalPlayer);
+				Enemy = Headless::SpawnUnit(Units::Zergling, Start, Headless::Settings().EnemyPlayer);
+			}
+
+			void RunTest() override
+			{
+				TestEqual(Tracker->GetTrackedCount(), 1u);
+
+				//Straight line at (3, 1); every sample is a multiple of 1/16, so the fit is exact
+				for (int i = 1; i <= 16; ++i)
+				{
+					MoveTo(Point{ Start.X + 3.0 * Tick * i, Start.Y + 1.0 * Tick * i });
+				}
+				const Point velocity = Tracker->GetVelocity(Enemy).value();
+				TestEqual(velocity.X, 3.0);
+				TestEqual(velocity.Y, 1.0);
+				const Point predicted = Tracker->PredictPosition(Enemy, 2.0f).value();
+				TestEqual(predicted.X, Start.X + 3.0 + 6.0);
+				TestEqual(predicted.Y, Start.Y + 1.0 + 2.0);
+
+				UnitGroup group;
+				group.Add(Enemy);
+				UnitGroupState state;
+				PointArray<float> positions;
+				Tracker->PredictPositions(group, 2.0f, state, positions);
+				TestEqual(positions.Get(0).X, predicted.X);
+				TestEqual(positions.Get(0).Y, predicted.Y);
+
+				//A blink restarts the history: no velocity from a single sample, then the new one
+				const Point blink{ Start.X + 8.0, Start.Y - 2.0 };
+				MoveTo(blink);
+				TestEqual(Tracker->GetVelocity(Enemy).value().X, 0.0);
+				for (int i = 1; i <= 4; ++i)
+				{
+					MoveTo(Point{ blink.X - 2.0 * Tick * i, blink.Y + 0.5 * Tick * i });
+				}
+				TestEqual(Tracker->GetVelocity(Enemy).value().X, -2.0);
+				TestEqual(Tracker->GetVelocity(Enemy).value().Y, 0.5);
+
+				//Standing still
+				for (int i = 0; i < 8; ++i)
+				{
+					Tracker->Sample(Tick);
+				}
+				TestEqual(Tracker->GetVelocity(Enemy).value().X, 0.0);
+				TestEqual(Tracker->GetVelocity(Enemy).value().Y, 0.0);
+				Finished(true);
+			}
+
+		private:
+			const double Tick = 1.0 / 16.0;
+			const Point Start{ 46.0, 50.0 };
+			std::unique_ptr<UnitMotionTracker> Tracker;
+			Unit Enemy;
+
+			//Records one sample at the new position, as the clock of the tracker would
+			void MoveTo(const Point& position)
+			{
+				Headless::SetPosition(Enemy, position);
+				Tracker->Sample(Tick);
+			}
+		};
+
+		inline void RegisterUnitMotionTests()
+		{
+			RegisterUnitTest("UnitMotion", Creator<UnitMotionTest>());
+		}
+	}
+}
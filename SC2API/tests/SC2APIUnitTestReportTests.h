@@ -0,0 +1,177 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/SC2APIUnitTestReport.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			inline UnitTestFilter GetUnitTestFilter(const char* pattern, int shardIndex = 0, int shardCount = 1)
+			{
+				UnitTestFilter filter;
+				filter.Pattern = pattern;
+				filter.ShardIndex = shardIndex;
+				filter.ShardCount = shardCount;
+				return filter;
+			}
+
+			inline std::string ReadUnitTestReport(const std::string& path)
+			{
+				std::ifstream file(path);
+				std::ostringstream text;
+				text << file.rdbuf();
+				return text.str();
+			}
+		}
+
+		//Wildcards, negative patterns and shards select the tests
+		class UnitTestFilterTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "UnitTestFilter"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				const UnitTestFilter all;
+				TestEqual(all.Matches("PathPlanner"), true);
+				TestEqual(all.Matches(""), true);
+
+				const UnitTestFilter wildcard = Internal::GetUnitTestFilter("Path*");
+				TestEqual(wildcard.Matches("PathPlanner"), true);
+				TestEqual(wildcard.Matches("Path"), true);
+				TestEqual(wildcard.Matches("FlowField"), false);
+				TestEqual(wildcard.Matches("PrePathPlanner"), false);
+				//'*' backtracks past an earlier partial match, '?' takes exactly one character
+				TestEqual(Internal::GetUnitTestFilter("*Plan*Obstacle").Matches("PathPlannerPlanObstacle"), true);
+				TestEqual(Internal::GetUnitTestFilter("Point?ist*").Matches("PointDistAll"), true);
+				TestEqual(Internal::GetUnitTestFilter("Point?ist*").Matches("PointistAll"), false);
+				TestEqual(Internal::GetUnitTestFilter("EventLog").Matches("EventLogs"), false);
+
+				const UnitTestFilter several = Internal::GetUnitTestFilter("EventLog:Flow*");
+				TestEqual(several.Matches("EventLog"), true);
+				TestEqual(several.Matches("FlowFieldBuild"), true);
+				TestEqual(several.Matches("BuildOrder"), false);
+
+				//Negative patterns alone run everything else; with positive ones they remove from the selection
+				const UnitTestFilter negative = Internal::GetUnitTestFilter("-*Build*:PointDist?ll");
+				TestEqual(negative.Matches("FlowFieldBuild"), false);
+				TestEqual(negative.Matches("PointDistAll"), false);
+				TestEqual(negative.Matches("PathPlanner"), true);
+				const UnitTestFilter both = Internal::GetUnitTestFilter("Flow*:BuildOrder*-*Pool:*Search");
+				TestEqual(both.Matches("FlowField"), true);
+				TestEqual(both.Matches("BuildOrderDeterminism"), true);
+				TestEqual(both.Matches("FlowFieldBuildPool"), false);
+				TestEqual(both.Matches("BuildOrderSearch"), false);
+				TestEqual(both.Matches("PathPlanner"), false);
+
+				//Every test falls in exactly one shard, and shards are not all empty
+				const std::vector<std::string> names = {
+					"SingletonInstance", "PointBatch", "PathPlanner", "PathPlannerObstacle", "WorkerPool", "FlowField",
+					"CombatSimulator", "BuildOrder", "BuildOrderSearch", "EventLog", "UnitTestFilter", "UnitTestReport" };
+				const int shardCount = 3;
+				std::vector<int> shardSizes(shardCount, 0);
+				int wrong = 0;
+				for (const std::string& name : names)
+				{
+					int shards = 0;
+					for (int shard = 0; shard < shardCount; ++shard)
+					{
+						if (Internal::GetUnitTestFilter("", shard, shardCount).Matches(name))
+						{
+							++shards;
+							++shardSizes[shard];
+						}
+					}
+					wrong += shards != 1 ? 1 : 0;
+				}
+				TestEqual(wrong, 0);
+				for (const int size : shardSizes)
+				{
+					TestGreater(size, 0);
+				}
+
+				//Patterns apply before shards
+				int selected = 0;
+				for (int shard = 0; shard < shardCount; ++shard)
+				{
+					const UnitTestFilter filter = Internal::GetUnitTestFilter("Path*", shard, shardCount);
+					selected += filter.Matches("PathPlanner") ? 1 : 0;
+					TestEqual(filter.Matches("EventLog"), false);
+				}
+				TestEqual(selected, 1);
+				Finished(true);
+			}
+		};
+
+		//Names and messages with markup, quotes and control characters are escaped in both report formats
+		class UnitTestReportTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "UnitTestReport"; }
+			float GetTimeOutDuration() const override { return 1.0f; }
+			void SetupTest() override {}
+
+			void TeardownTest() override
+			{
+				std::remove(JUnitPath);
+				std::remove(JsonPath);
+			}
+
+			void RunTest() override
+			{
+				std::vector<UnitTestResult> results(2);
+				results[0].Name = "Passes<int, \"a\" & 'b'>";
+				results[0].Success = true;
+				results[1].Name = "Path\\To\tFailure";
+				results[1].Failures.push_back("1 < 2\nbut \"x\" \x01is 3");
+
+				TestEqual(WriteUnitTestJUnit(JUnitPath, results, "Suite&Co"), true);
+				const std::string junit = Internal::ReadUnitTestReport(JUnitPath);
+				TestEqual(Contains(junit, "<testsuite name=\"Suite&amp;Co\" tests=\"2\" failures=\"1\""), true);
+				TestEqual(Contains(junit, "name=\"Passes&lt;int, &quot;a&quot; &amp; &apos;b&apos;&gt;\""), true);
+				TestEqual(Contains(junit, "name=\"Path\\To\tFailure\""), true);
+				//Control characters other than tab and newlines are dropped, not written as references
+				TestEqual(Contains(junit, "message=\"1 &lt; 2\nbut &quot;x&quot; is 3\""), true);
+				TestEqual(Contains(junit, "\x01"), false);
+				TestEqual(Contains(junit, "<int"), false);
+
+				TestEqual(WriteUnitTestJson(JsonPath, results, "Suite\"Co"), true);
+				const std::string json = Internal::ReadUnitTestReport(JsonPath);
+				TestEqual(Contains(json, "\"suite\": \"Suite\\\"Co\""), true);
+				TestEqual(Contains(json, "\"failures\": 1,"), true);
+				TestEqual(Contains(json, "\"name\": \"Passes<int, \\\"a\\\" & 'b'>\", \"success\": true"), true);
+				TestEqual(Contains(json, "\"name\": \"Path\\\\To\\u0009Failure\", \"success\": false"), true);
+				TestEqual(Contains(json, "\"failures\": [\"1 < 2\\u000abut \\\"x\\\" \\u0001is 3\"]"), true);
+				TestEqual(Contains(json, "\t"), false);
+				Finished(true);
+			}
+
+		private:
+			const char* const JUnitPath = "SC2APIUnitTestReport.xml";
+			const char* const JsonPath = "SC2APIUnitTestReport.json";
+
+			static bool Contains(const std::string& text, const std::string& part)
+			{
+				return text.find(part) != std::string::npos;
+			}
+		};
+
+		inline void RegisterUnitTestReportTests()
+		{
+			RegisterUnitTest("UnitTestFilter", Creator<UnitTestFilterTest>());
+			RegisterUnitTest("UnitTestReport", Creator<UnitTestReportTest>());
+		}
+	}
+}
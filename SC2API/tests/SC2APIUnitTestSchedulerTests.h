@@ -0,0 +1,207 @@
+#pragma once
+#include "SC2API/headless/SC2APIHeadless.h"
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIGameData.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include "SC2API/include/Creator.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		namespace Internal
+		{
+			//When a probe ran, and the units it left behind
+			struct SchedulerProbeRecord
+			{
+				std::string Name;
+				double Start = 0.0;
+				double End = 0.0;
+				std::vector<Unit> LeftUnits;
+				int AliveAtTeardown = 0;
+			};
+
+			inline Point GetSchedulerProbePosition(const RegionalUnitTestBase& test)
+			{
+				return test.GetRegion().Center;
+			}
+
+			inline Point GetSchedulerProbePosition(const UnitTestBase& /*test*/)
+			{
+				return GetTownCandidatePositionStandard();
+			}
+
+			/// <summary>
+			/// Passes after the given game time, or never if it is negative, leaving marines behind in its region.
+			/// Regional with RegionalUnitTestBase as base, run alone with UnitTestBase.
+			/// </summary>
+			template<class BaseT>
+			class SchedulerProbeTest : public BaseT, public SignalObject
+			{
+			public:
+				SchedulerProbeTest(std::vector<SchedulerProbeRecord>* records, std::string name, double duration, int leftUnits)
+					: Records(records)
+					, Duration(duration)
+					, LeftUnits(leftUnits)
+				{
+					Record.Name = std::move(name);
+				}
+
+				const char* GetName() const override { return Record.Name.c_str(); }
+				float GetTimeOutDuration() const override { return 1.5f; }
+
+				void SetupTest() override
+				{
+					Record.Start = Headless::GetTime();
+					for (int i = 0; i < LeftUnits; ++i)
+					{
+						const Point position = GetSchedulerProbePosition(*this);
+						Record.LeftUnits.push_back(Headless::SpawnUnit(Units::Marine, Point{ position.X + i, position.Y }, Headless::Settings().LocalPlayer));
+					}
+				}
+
+				void RunTest() override
+				{
+					if (Duration >= 0.0)
+					{
+						SignalTimer(Duration, false).connect(this, &SchedulerProbeTest::OnTimer);
+					}
+				}
+
+				//The scheduler removes the units after this
+				void TeardownTest() override
+				{
+					Record.End = Headless::GetTime();
+					for (const Unit& unit : Record.LeftUnits)
+					{
+						Record.AliveAtTeardown += unit.IsAccessible() ? 1 : 0;
+					}
+					Records->push_back(Record);
+				}
+
+			private:
+				std::vector<SchedulerProbeRecord>* Records;
+				SchedulerProbeRecord Record;
+				double Duration;
+				int LeftUnits;
+
+				void OnTimer()
+				{
+					this->Finished(true);
+				}
+			};
+
+			using RegionalSchedulerProbe = SchedulerProbeTest<RegionalUnitTestBase>;
+			using ExclusiveSchedulerProbe = SchedulerProbeTest<UnitTestBase>;
+		}
+
+		//Regional tests share the regions, a test that is not regional waits for and holds back the others, a test
+		//that never reports times out, and units the tests leave behind are removed
+		class UnitTestSchedulerTest : public UnitTestBase, public SignalObject
+		{
+		public:
+			const char* GetName() const override { return "UnitTestScheduler"; }
+			float GetTimeOutDuration() const override { return 10.0f; }
+			void TeardownTest() override { Scheduler.reset(); }
+
+			void SetupTest() override
+			{
+				Scheduler.reset(new UnitTestScheduler(GetUnitTestRegionGrid(GetTownCandidatePositionStandard(), 2, 1, 40.0)));
+				const auto addRegional = [this](const char* name, double duration, int leftUnits)
+				{
+					Scheduler->Add(name, InlineCreator<Internal::RegionalSchedulerProbe>(&Records, name, duration, leftUnits));
+				};
+				addRegional("UnitTestScheduler/Long", 1.0, 0);
+				addRegional("UnitTestScheduler/Short", 0.5, 2);
+				addRegional("UnitTestScheduler/Next", 0.25, 1);
+				Scheduler->Add("UnitTestScheduler/Alone", InlineCreator<Internal::ExclusiveSchedulerProbe>(&Records, "UnitTestScheduler/Alone", 0.25, 1));
+				addRegional("UnitTestScheduler/After", 0.25, 0);
+				addRegional("UnitTestScheduler/Stuck", -1.0, 1);
+				addRegional("UnitTestScheduler/Last", 0.25, 0);
+				Scheduler->AllFinished.connect(this, &UnitTestSchedulerTest::OnAllFinished);
+			}
+
+			void RunTest() override
+			{
+				Scheduler->Run();
+			}
+
+		private:
+			std::unique_ptr<UnitTestScheduler> Scheduler;
+			std::vector<Internal::SchedulerProbeRecord> Records;
+
+			const Internal::SchedulerProbeRecord& GetRecord(const std::string& name) const
+			{
+				static const Internal::SchedulerProbeRecord missing;
+				const auto record = std::find_if(Records.begin(), Records.end(), [&name](const Internal::SchedulerProbeRecord& other)
+				{
+					return other.Name == name;
+				});
+				return record != Records.end() ? *record : missing;
+			}
+
+			void OnAllFinished(int failedCount)
+			{
+				TestEqual(failedCount, 1);
+				TestEqual(Records.size(), 7u);
+				const std::vector<UnitTestResult>& results = Scheduler->GetResults();
+				TestEqual(results.size(), 7u);
+				for (const UnitTestResult& result : results)
+				{
+					const bool stuck = result.Name == "UnitTestScheduler/Stuck";
+					TestEqual(result.Success, !stuck);
+					TestEqual(result.TimedOut, stuck);
+				}
+
+				//Two slots: the first tests start together, the next one as soon as a slot is free
+				const Internal::SchedulerProbeRecord& longTest = GetRecord("UnitTestScheduler/Long");
+				const Internal::SchedulerProbeRecord& shortTest = GetRecord("UnitTestScheduler/Short");
+				const Internal::SchedulerProbeRecord& next = GetRecord("UnitTestScheduler/Next");
+				TestEqual(shortTest.Start, longTest.Start);
+				TestGreater(longTest.End, next.Start);
+				TestGreater(next.Start, shortTest.Start);
+
+				//The test that is not regional overlaps no other
+				const Internal::SchedulerProbeRecord& alone = GetRecord("UnitTestScheduler/Alone");
+				for (const Internal::SchedulerProbeRecord& record : Records)
+				{
+					if (&record != &alone)
+					{
+						TestEqual(record.End <= alone.Start || record.Start >= alone.End, true);
+					}
+				}
+				TestGreater(GetRecord("UnitTestScheduler/After").Start, alone.Start);
+
+				//Timed out after its duration, while the test after it ran
+				const Internal::SchedulerProbeRecord& stuck = GetRecord("UnitTestScheduler/Stuck");
+				TestGreater(stuck.End - stuck.Start + 1e-6, 1.5);
+				TestGreater(stuck.End, GetRecord("UnitTestScheduler/Last").Start);
+
+				//Alive until the teardown of their test, removed right after it
+				int aliveAtTeardown = 0;
+				int alive = 0;
+				for (const Internal::SchedulerProbeRecord& record : Records)
+				{
+					aliveAtTeardown += record.AliveAtTeardown;
+					for (const Unit& unit : record.LeftUnits)
+					{
+						alive += unit.IsAccessible() ? 1 : 0;
+					}
+				}
+				TestEqual(aliveAtTeardown, 5);
+				TestEqual(alive, 0);
+				Finished(true);
+			}
+		};
+
+		inline void RegisterUnitTestSchedulerTests()
+		{
+			RegisterUnitTest("UnitTestScheduler", Creator<UnitTestSchedulerTest>());
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "SC2API/include/SC2API.h"
+#include "SC2API/include/SC2APIWorkerPool.h"
+#include "SC2API/include/SC2APIUnitTestSystem.h"
+#include "SC2API/include/SC2APIUnitTestScheduler.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace SC2API
+{
+	namespace Tests
+	{
+		//Every task runs once, exceptions reach the caller after the loop ended, and nested loops run inline
+		class WorkerPoolTest : public RegionalUnitTestBase
+		{
+		public:
+			const char* GetName() const override { return "WorkerPool"; }
+			float GetTimeOutDuration() const override { return 5.0f; }
+			void SetupTest() override {}
+			void TeardownTest() override {}
+
+			void RunTest() override
+			{
+				for (const unsigned threads : { 1u, 4u })
+				{
+					WorkerPool pool(threads);
+					TestEqual(pool.GetThreadCount(), threads);
+					std::vector<int> runs(1000, 0);
+					pool.ParallelFor(runs.size(), [&runs](size_t task) { ++runs[task]; });
+					int wrong = 0;
+					for (const int count : runs)
+					{
+						wrong += count != 1 ? 1 : 0;
+					}
+					TestEqual(wrong, 0);
+
+					//Thrown by the first task, which the calling thread takes, then by a later one, which a worker may take
+					for (const size_t failing : { size_t(0), size_t(700) })
+					{
+						std::atomic<int> started{ 0 };
+						bool caught = false;
+						try
+						{
+							pool.ParallelFor(1000, [&started, failing](size_t task)
+							{
+								++started;
+								if (task == failing)
+								{
+									throw std::runtime_error("task failed");
+								}
+							});
+						}
+						catch (const std::runtime_error&)
+						{
+							caught = true;
+						}
+						TestEqual(caught, true);
+						TestGreater(started.load(), static_cast<int>(failing));
+					}
+
+					//Still usable, and loops started from a body finish instead of waiting for the busy threads
+					std::atomic<int> inner{ 0 };
+					pool.ParallelFor(8, [&pool, &inner](size_t)
+					{
+						pool.ParallelFor(10, [&inner](size_t) { ++inner; });
+					});
+					TestEqual(inner.load(), 80);
+				}
+				Finished(true);
+			}
+		};
+
+		inline void RegisterWorkerPoolTests()
+		{
+			RegisterUnitTest("WorkerPool", Creator<WorkerPoolTest>());
+		}
+	}
+}
@@ -30,6 +30,7 @@
 
 #include "zycore/ReflectableObject.hpp"
 #include "zycore/Exceptions.hpp"
+#include "zycore/PropertyTable.hpp"
 
 #include <string>
 #include <unordered_map>
@@ -148,8 +149,10 @@ public:
      * @param   owner   The owner object of this property. May NOT be @c nullptr.
      * @param   name    The name of the property.
      * @param   member  The variable to represent with this property.
-     * @param   getter  The getter called to obtain the value. See @c defaultGetter.
-     * @param   setter  The setter called to set the value. See @c defaultSetter.
+     * @param   getter  The getter called to obtain the value. If empty, the member is read
+     *                  directly (see @c defaultGetter).
+     * @param   setter  The setter called to set the value. If empty, the member is assigned
+     *                  directly (see @c defaultSetter).
      */
     PropertyTemplatedBase(ReflectableObject* owner, const std::string& name, T& member, 
         Getter getter, Setter setter);
@@ -219,13 +222,20 @@ inline const T& PropertyTemplatedBase<T>::defaultGetter() const
 template<typename T>
 void PropertyTemplatedBase<T>::set(const T& newValue)
 {
-    m_setter(newValue);
+    if (m_setter)
+    {
+        m_setter(newValue);
+    }
+    else
+    {
+        defaultSetter(newValue);
+    }
 }
 
 template<typename T>
 const T& PropertyTemplatedBase<T>::get() const
 {
-    return m_getter();
+    return m_getter ? m_getter() : defaultGetter();
 }
 
 template<typename T>
@@ -290,23 +300,19 @@ public:
 
 template<typename T>
 inline Property<T>::Property(ReflectableObject* owner, const std::string& name, T& member)
-    : PropertyImplementation<T>(owner, name, member, 
-        std::bind(&PropertyTemplatedBase<T>::defaultGetter, this), 
-        std::bind(&PropertyTemplatedBase<T>::defaultSetter, this, std::placeholders::_1))
+    : PropertyImplementation<T>(owner, name, member, nullptr, nullptr)
 {}
 
 template<typename T>
 inline Property<T>::Property(ReflectableObject* owner, const std::string& name, T& member, 
         typename PropertyTemplatedBase<T>::Getter getter)
-    : PropertyImplementation<T>(owner, name, member, getter, 
-        std::bind(&PropertyTemplatedBase<T>::defaultSetter, this, std::placeholders::_1))
+    : PropertyImplementation<T>(owner, name, member, getter, nullptr)
 {}
 
 template<typename T>
 inline Property<T>::Property(ReflectableObject* owner, const std::string& name, T& member, 
         typename PropertyTemplatedBase<T>::Setter setter)
-    : PropertyImplementation<T>(owner, name, member, 
-        std::bind(&PropertyTemplatedBase<T>::defaultGetter, this), setter)
+    : PropertyImplementation<T>(owner, name, member, nullptr, setter)
 {}
 
 template<typename T>
@@ -320,7 +326,7 @@ inline Property<T>::Property(ReflectableObject* owner, const std::string& name,
 // [Basic property types]                                                                         //
 // ============================================================================================== //
 
-#define ZYCORE_NUMERIC_PROPERTY(type, converter)                                                   \
+#define ZYCORE_TRAITS_PROPERTY(type)                                                               \
     template<>                                                                                     \
     class PropertyImplementation<type> : public PropertyTemplatedBase<type>                        \
     {                                                                                              \
@@ -331,92 +337,36 @@ inline Property<T>::Property(ReflectableObject* owner, const std::string& name,
     public:                                                                                        \
         void fromString(const std::string& val) override                                           \
         {                                                                                          \
-            try                                                                                    \
-            {                                                                                      \
-                m_setter(converter(val));                                                          \
-            } catch (const std::exception&)                                                        \
-            {                                                                                      \
-                throw InvalidUsage("invalid value provided");                                      \
-            }                                                                                      \
+            set(PropertyTraits<type>::fromString(val));                                            \
         }                                                                                          \
                                                                                                    \
         std::string toString() const override                                                      \
         {                                                                                          \
-            return std::to_string(m_getter());                                                     \
+            return PropertyTraits<type>::toString(get());                                          \
         }                                                                                          \
                                                                                                    \
         const std::string& typeName() const override                                               \
         {                                                                                          \
-            static const std::string typeName(#type);                                              \
-            return typeName;                                                                       \
+            return PropertyTraits<type>::typeName();                                               \
         }                                                                                          \
     };
 
-ZYCORE_NUMERIC_PROPERTY(int, std::stoi);
-ZYCORE_NUMERIC_PROPERTY(unsigned int, std::stoul);
-ZYCORE_NUMERIC_PROPERTY(short, (short)std::stoi);
-ZYCORE_NUMERIC_PROPERTY(unsigned short, (unsigned short)std::stoul);
-ZYCORE_NUMERIC_PROPERTY(long, std::stol);
-ZYCORE_NUMERIC_PROPERTY(unsigned long, std::stoul);
-ZYCORE_NUMERIC_PROPERTY(long long, std::stoll);
-ZYCORE_NUMERIC_PROPERTY(unsigned long long, std::stoull);
-ZYCORE_NUMERIC_PROPERTY(float, std::stof);
-ZYCORE_NUMERIC_PROPERTY(double, std::stod);
-ZYCORE_NUMERIC_PROPERTY(long double, std::stold);
-ZYCORE_NUMERIC_PROPERTY(unsigned char, (unsigned char)std::stoul);
-
-#undef ZYCORE_NUMERIC_PROPERTY
-
-template<>
-class PropertyImplementation<bool> : public PropertyTemplatedBase<bool>
-{
-public:
-    PropertyImplementation(ReflectableObject* owner, const std::string& name, bool& member, 
-        Getter getter, Setter setter) : PropertyTemplatedBase<bool>(owner, name, member, getter,
-        setter) {}
-public:
-    void fromString(const std::string& val) override
-    {
-        m_setter(!(val == "false" || val == "0"));
-    }
-
-    std::string toString() const override
-    {
-        return m_getter() ? "true" : "false";
-    }
-
-    const std::string& typeName() const override
-    {
-        static const std::string typeName("bool");
-        return typeName;
-    }
-};
-
-template<>
-class PropertyImplementation<std::string> 
-    : public PropertyTemplatedBase<std::string>
-{
-public:
-    PropertyImplementation(ReflectableObject* owner, const std::string& name, 
-            std::string& member, Getter getter, Setter setter) 
-        : PropertyTemplatedBase<std::string>(owner, name, member, getter, setter) {}
-public:
-    void fromString(const std::string& val) override
-    {
-        m_setter(val);
-    }
-
-    std::string toString() const override
-    {
-        return m_getter();
-    }
-
-    const std::string& typeName() const override
-    {
-        static const std::string typeName("std::string");
-        return typeName;
-    }
-};
+ZYCORE_TRAITS_PROPERTY(int);
+ZYCORE_TRAITS_PROPERTY(unsigned int);
+ZYCORE_TRAITS_PROPERTY(short);
+ZYCORE_TRAITS_PROPERTY(unsigned short);
+ZYCORE_TRAITS_PROPERTY(long);
+ZYCORE_TRAITS_PROPERTY(unsigned long);
+ZYCORE_TRAITS_PROPERTY(long long);
+ZYCORE_TRAITS_PROPERTY(unsigned long long);
+ZYCORE_TRAITS_PROPERTY(float);
+ZYCORE_TRAITS_PROPERTY(double);
+ZYCORE_TRAITS_PROPERTY(long double);
+ZYCORE_TRAITS_PROPERTY(unsigned char);
+ZYCORE_TRAITS_PROPERTY(bool);
+ZYCORE_TRAITS_PROPERTY(std::string);
+
+#undef ZYCORE_TRAITS_PROPERTY
 
 // ============================================================================================== //
 // Macro magic for easy creation of enum properties                                               //
@@ -471,12 +421,12 @@ namespace internal
             auto valIt = m_nameToValMap.find(val);                                                 \
             if (valIt == m_nameToValMap.end())                                                     \
                 throw InvalidUsage("invalid enum value");                                          \
-            m_setter(valIt->second);                                                               \
+            set(valIt->second);                                                                    \
         }                                                                                          \
                                                                                                    \
         std::string toString() const override                                                      \
         {                                                                                          \
-            auto nameIt = m_valToNameMap.find(m_getter());                                         \
+            auto nameIt = m_valToNameMap.find(get());                                              \
             assert(nameIt != m_valToNameMap.end());                                                \
             return nameIt->second;                                                                 \
         }                                                                                          \
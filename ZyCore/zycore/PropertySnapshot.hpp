@@ -0,0 +1,576 @@
+/**
+ * This file is part of the zyan core library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Höner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _ZYCORE_PROPERTYSNAPSHOT_HPP_
+#define _ZYCORE_PROPERTYSNAPSHOT_HPP_
+
+#ifdef ZYCORE_HEADER_ONLY
+#   error "This file cannot be used in header-only mode."
+#endif // ZYCORE_HEADER_ONLY
+
+#include "zycore/Property.hpp"
+#include "zycore/BinaryStream.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef ZYCORE_WINDOWS
+#   include <Windows.h>
+#else
+#   include <sys/stat.h>
+#endif
+
+namespace zycore
+{
+
+// ============================================================================================== //
+// [Property snapshots]                                                                           //
+// ============================================================================================== //
+
+/**
+ * Snapshot layout (native byte order, meant for the machine that wrote it):
+ * @code
+ *      uint32_t    magic       'ZYPS'
+ *      uint32_t    version     kPropertySnapshotVersion
+ *      uint32_t    count
+ *      count times:
+ *          uint16_t    nameLen
+ *          char        name[nameLen]
+ *          uint32_t    valueLen
+ *          uint8_t     value[valueLen]     see PropertyBinaryCodec
+ * @endcode
+ */
+const uint32_t kPropertySnapshotMagic = 0x5350595A;
+const uint32_t kPropertySnapshotVersion = 1;
+
+/**
+ * @brief   Binary form of property values.
+ * @tparam  T   The value type.
+ *
+ * Trivially copyable types are stored as their raw bytes, strings as their characters. Other
+ * types have no binary form.
+ */
+template<typename T, typename=void>
+struct PropertyBinaryCodec
+{
+    static const bool kHasBinaryForm = false;
+};
+
+template<typename T>
+struct PropertyBinaryCodec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>>
+{
+    static const bool kHasBinaryForm = true;
+
+    static void write(const T& value, OBinaryStream& stream)
+    {
+        stream.rawWrite(stream.wpos(), sizeof(T), reinterpret_cast<const uint8_t*>(&value));
+        stream.wpos(stream.wpos() + sizeof(T));
+    }
+
+    static bool accepts(size_t len)
+    {
+        return len == sizeof(T);
+    }
+
+    static T read(const uint8_t* data, size_t /*len*/)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+};
+
+template<>
+struct PropertyBinaryCodec<std::string>
+{
+    static const bool kHasBinaryForm = true;
+
+    static void write(const std::string& value, OBinaryStream& stream)
+    {
+        stream.rawWrite(stream.wpos(), value.size(),
+            reinterpret_cast<const uint8_t*>(value.data()));
+        stream.wpos(stream.wpos() + value.size());
+    }
+
+    static bool accepts(size_t /*len*/)
+    {
+        return true;
+    }
+
+    static std::string read(const uint8_t* data, size_t len)
+    {
+        return std::string(reinterpret_cast<const char*>(data), len);
+    }
+};
+
+/**
+ * @brief   The value types whose properties are written to snapshots: the basic property types.
+ *
+ * @c PropertyBase is part of the prebuilt library, so the codec is not reached through new
+ * virtual methods but by casting a property to @c PropertyTemplatedBase of each of these types.
+ * Properties of other types, e.g. enum properties, are not written.
+ */
+using PropertySnapshotTypes = std::tuple<int, unsigned int, short, unsigned short, long,
+    unsigned long, long long, unsigned long long, float, double, long double, unsigned char, bool,
+    std::string>;
+
+/**
+ * @brief   Writes the value of a property in binary form.
+ * @param   prop    The property.
+ * @param   stream  The stream to append to.
+ * @return  @c true if the value was written, @c false if the property has no binary form.
+ */
+bool writePropertyBinary(const PropertyBase& prop, OBinaryStream& stream);
+
+/**
+ * @brief   Determines whether a value of the given length written by @c writePropertyBinary
+ *          can be read back into a property.
+ * @param   prop    The property.
+ * @param   len     The length of the binary value.
+ * @return  @c true if @c readPropertyBinary would accept the value, else @c false.
+ */
+bool acceptsPropertyBinary(const PropertyBase& prop, size_t len);
+
+/**
+ * @brief   Sets a property from a value written by @c writePropertyBinary.
+ * @param   prop    The property.
+ * @param   data    The binary value.
+ * @param   len     The length of the binary value. Must be accepted by @c acceptsPropertyBinary.
+ * @throws  NotImplemented if the property has no binary form.
+ */
+void readPropertyBinary(PropertyBase& prop, const uint8_t* data, size_t len);
+
+/**
+ * @brief   Writes all properties of an object that have a binary form to a stream.
+ * @param   obj     The object whose properties to write.
+ * @param   stream  The stream to append the snapshot to, at its write offset.
+ * @return  The number of properties written.
+ */
+size_t savePropertySnapshot(const ReflectableObject& obj, OBinaryStream& stream);
+
+/**
+ * @overload
+ * @return  A buffer holding the snapshot.
+ */
+BaseBinaryStream::Buffer savePropertySnapshot(const ReflectableObject& obj);
+
+/**
+ * @brief   Applies a snapshot written by @c savePropertySnapshot to an object.
+ * @param   obj     The object whose properties to set.
+ * @param   stream  The stream to read the snapshot from, at its read offset.
+ * @return  The number of properties set.
+ * @throws  InvalidUsage if the snapshot is malformed, or one of its values does not fit the
+ *                       property of the same name. Nothing is modified in that case.
+ *
+ * Properties are matched by name. Entries without a matching property are skipped and
+ * properties without an entry keep their value.
+ */
+size_t loadPropertySnapshot(ReflectableObject& obj, IBinaryStream& stream);
+
+// ============================================================================================== //
+// [PropertySnapshotFile]                                                                         //
+// ============================================================================================== //
+
+/**
+ * @brief   Binds an object's properties to a snapshot file and reloads them when it changes.
+ *
+ * The file is only looked at in @c poll, so calling it between game ticks guarantees the
+ * properties never change in the middle of one. A file that cannot be loaded (e.g. because it
+ * is still being written) leaves the properties untouched and is retried on the next poll.
+ *
+ * Changes are detected by a hash of the contents. The file is only read when its modification
+ * time or size changed, or while its modification time is too recent to tell apart from a
+ * rewrite: file systems stamp files with a coarse clock, so two writes milliseconds apart may
+ * carry the same time.
+ */
+class PropertySnapshotFile : public NonCopyable
+{
+    ReflectableObject& m_obj;
+    std::string m_path;
+    long long m_lastMTime = -1;
+    long long m_lastSize = -1;
+    uint64_t m_lastHash = 0;
+    bool m_racy = true;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   obj     The object whose properties to bind. Must outlive the binding.
+     * @param   path    The path of the snapshot file.
+     */
+    PropertySnapshotFile(ReflectableObject& obj, std::string path);
+public:
+    /**
+     * @brief   Reloads the properties if the file changed since the last successful load.
+     * @return  @c true if the properties were reloaded, else @c false.
+     */
+    bool poll();
+    /**
+     * @brief   Writes the current properties to the file. The file is replaced as a whole, so
+     *          a concurrent @c poll never observes a partially written snapshot.
+     * @return  @c true on success, else @c false.
+     */
+    bool save();
+    /**
+     * @brief   Gets the path of the snapshot file.
+     * @return  The path.
+     */
+    const std::string& path() const;
+private:
+    /**
+     * @brief   Gets the modification time in nanoseconds since the Unix epoch and the size of
+     *          the file.
+     */
+    bool statFile(long long& mtime, long long& size) const;
+    /**
+     * @brief   Remembers the state of the file as seen now.
+     * @param   mtime   The modification time returned by @c statFile.
+     * @param   size    The size returned by @c statFile.
+     * @param   hash    The hash of the contents.
+     */
+    void remember(long long mtime, long long size, uint64_t hash);
+    static uint64_t hashContents(const BaseBinaryStream::Buffer& buffer);
+};
+
+// ============================================================================================== //
+// Implementation of inline functions [Property snapshots]                                        //
+// ============================================================================================== //
+
+namespace internal
+{
+
+/**
+ * @brief   Calls @c func with the property cast to @c PropertyTemplatedBase of the first type of
+ *          @c PropertySnapshotTypes it has a binary form for.
+ * @return  @c true if one of the types matched, else @c false.
+ */
+template<size_t I = 0, typename PropT, typename FuncT>
+inline std::enable_if_t<I == std::tuple_size<PropertySnapshotTypes>::value, bool>
+    visitPropertyBinary(PropT& /*prop*/, FuncT&& /*func*/)
+{
+    return false;
+}
+
+template<size_t I = 0, typename PropT, typename FuncT>
+inline std::enable_if_t<I < std::tuple_size<PropertySnapshotTypes>::value, bool>
+    visitPropertyBinary(PropT& prop, FuncT&& func)
+{
+    using ValueT = std::tuple_element_t<I, PropertySnapshotTypes>;
+    using CastT = std::conditional_t<std::is_const<PropT>::value,
+        const PropertyTemplatedBase<ValueT>, PropertyTemplatedBase<ValueT>>;
+    static_assert(PropertyBinaryCodec<ValueT>::kHasBinaryForm,
+        "snapshot types need a binary form");
+
+    auto typed = dynamic_cast<CastT*>(&prop);
+    if (!typed)
+    {
+        return visitPropertyBinary<I + 1>(prop, std::forward<FuncT>(func));
+    }
+    func(*typed, PropertyBinaryCodec<ValueT>());
+    return true;
+}
+
+} // namespace internal
+
+inline bool writePropertyBinary(const PropertyBase& prop, OBinaryStream& stream)
+{
+    return internal::visitPropertyBinary(prop, [&](const auto& typed, auto codec)
+    {
+        decltype(codec)::write(typed.get(), stream);
+    });
+}
+
+inline bool acceptsPropertyBinary(const PropertyBase& prop, size_t len)
+{
+    bool accepted = false;
+    internal::visitPropertyBinary(prop, [&](const auto& /*typed*/, auto codec)
+    {
+        accepted = decltype(codec)::accepts(len);
+    });
+    return accepted;
+}
+
+inline void readPropertyBinary(PropertyBase& prop, const uint8_t* data, size_t len)
+{
+    if (!internal::visitPropertyBinary(prop, [&](auto& typed, auto codec)
+        {
+            typed.set(decltype(codec)::read(data, len));
+        }))
+    {
+        throw NotImplemented("property has no binary form");
+    }
+}
+
+inline size_t savePropertySnapshot(const ReflectableObject& obj, OBinaryStream& stream)
+{
+    const auto& props = obj.properties();
+    const auto countPos = stream.wpos() + 2 * sizeof(uint32_t);
+    uint32_t count = 0;
+    stream << kPropertySnapshotMagic << kPropertySnapshotVersion << count;
+
+    for (const PropertyBase* prop : props)
+    {
+        const auto recordPos = stream.wpos();
+        const std::string& name = prop->name();
+        stream << static_cast<uint16_t>(name.size());
+        stream.rawWrite(stream.wpos(), name.size(), reinterpret_cast<const uint8_t*>(name.data()));
+        stream.wpos(stream.wpos() + name.size());
+
+        const auto valueLenPos = stream.wpos();
+        stream << uint32_t{0};
+        if (!writePropertyBinary(*prop, stream))
+        {
+            // No binary form, drop the partial record.
+            stream.wpos(recordPos);
+            continue;
+        }
+        stream.rawWrite(valueLenPos,
+            static_cast<uint32_t>(stream.wpos() - valueLenPos - sizeof(uint32_t)));
+        ++count;
+    }
+
+    stream.rawWrite(countPos, count);
+    return count;
+}
+
+inline BaseBinaryStream::Buffer savePropertySnapshot(const ReflectableObject& obj)
+{
+    BaseBinaryStream::Buffer buffer;
+    OBinaryStream stream(&buffer);
+    savePropertySnapshot(obj, stream);
+    // Dropped records may leave bytes past the final write offset.
+    buffer.resize(stream.wpos());
+    return buffer;
+}
+
+inline size_t loadPropertySnapshot(ReflectableObject& obj, IBinaryStream& stream)
+{
+    uint32_t magic, version, count;
+    try
+    {
+        stream >> magic >> version >> count;
+    }
+    catch (const OutOfBounds&)
+    {
+        throw InvalidUsage("truncated property snapshot");
+    }
+    if (magic != kPropertySnapshotMagic || version != kPropertySnapshotVersion)
+    {
+        throw InvalidUsage("not a property snapshot");
+    }
+
+    // Decode and validate everything first so a bad snapshot cannot leave the object half set.
+    auto& props = obj.properties();
+    std::vector<std::pair<PropertyBase*, BaseBinaryStream::Buffer>> staged;
+    try
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint16_t nameLen;
+            stream >> nameLen;
+            std::string name(nameLen, '\0');
+            stream.rawRead(stream.rpos(), nameLen, reinterpret_cast<uint8_t*>(&name[0]));
+            stream.rpos(stream.rpos() + nameLen);
+
+            uint32_t valueLen;
+            stream >> valueLen;
+            auto value = stream.sub(stream.rpos(), valueLen);
+            stream.rpos(stream.rpos() + valueLen);
+
+            auto propIt = std::find_if(props.begin(), props.end(),
+                [&](const PropertyBase* prop) { return prop->name() == name; });
+            if (propIt == props.end())
+            {
+                continue;
+            }
+            if (!acceptsPropertyBinary(**propIt, value.size()))
+            {
+                throw InvalidUsage("snapshot value does not fit property " + name);
+            }
+            staged.emplace_back(*propIt, std::move(value));
+        }
+    }
+    catch (const OutOfBounds&)
+    {
+        throw InvalidUsage("truncated property snapshot");
+    }
+
+    for (auto& entry : staged)
+    {
+        readPropertyBinary(*entry.first, entry.second.data(), entry.second.size());
+    }
+    return staged.size();
+}
+
+// ============================================================================================== //
+// Implementation of inline methods [PropertySnapshotFile]                                        //
+// ============================================================================================== //
+
+inline PropertySnapshotFile::PropertySnapshotFile(ReflectableObject& obj, std::string path)
+    : m_obj(obj)
+    , m_path(std::move(path))
+{}
+
+inline const std::string& PropertySnapshotFile::path() const
+{
+    return m_path;
+}
+
+inline bool PropertySnapshotFile::statFile(long long& mtime, long long& size) const
+{
+#ifdef ZYCORE_WINDOWS
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(m_path.c_str(), GetFileExInfoStandard, &info))
+    {
+        return false;
+    }
+    // FILETIME counts 100 ns intervals since 1601.
+    mtime = (static_cast<long long>(
+        (static_cast<unsigned long long>(info.ftLastWriteTime.dwHighDateTime) << 32)
+        | info.ftLastWriteTime.dwLowDateTime) - 116444736000000000LL) * 100;
+    size = static_cast<long long>(
+        (static_cast<unsigned long long>(info.nFileSizeHigh) << 32) | info.nFileSizeLow);
+#else
+    struct stat info;
+    if (stat(m_path.c_str(), &info) != 0)
+    {
+        return false;
+    }
+#   ifdef ZYCORE_APPLE
+    const struct timespec& time = info.st_mtimespec;
+#   else
+    const struct timespec& time = info.st_mtim;
+#   endif
+    mtime = static_cast<long long>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    size = static_cast<long long>(info.st_size);
+#endif
+    return true;
+}
+
+inline uint64_t PropertySnapshotFile::hashContents(const BaseBinaryStream::Buffer& buffer)
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (const uint8_t byte : buffer)
+    {
+        hash = (hash ^ byte) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline void PropertySnapshotFile::remember(long long mtime, long long size, uint64_t hash)
+{
+    // Covers the 2 second resolution of FAT; anything written since may still share the time.
+    const long long kRacyMargin = 2000000000LL;
+    const long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    m_lastMTime = mtime;
+    m_lastSize = size;
+    m_lastHash = hash;
+    m_racy = now - mtime < kRacyMargin;
+}
+
+inline bool PropertySnapshotFile::poll()
+{
+    long long mtime, size;
+    if (!statFile(mtime, size) || (!m_racy && mtime == m_lastMTime && size == m_lastSize))
+    {
+        return false;
+    }
+
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    BaseBinaryStream::Buffer buffer(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const auto hash = hashContents(buffer);
+    if (m_lastMTime != -1 && hash == m_lastHash)
+    {
+        // Touched or rewritten with the same contents, e.g. by our own save.
+        remember(mtime, size, hash);
+        return false;
+    }
+
+    try
+    {
+        IBinaryStream stream(&buffer);
+        loadPropertySnapshot(m_obj, stream);
+    }
+    catch (const InvalidUsage&)
+    {
+        return false;
+    }
+
+    remember(mtime, size, hash);
+    return true;
+}
+
+inline bool PropertySnapshotFile::save()
+{
+    const auto buffer = savePropertySnapshot(m_obj);
+    const std::string tempPath = m_path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        if (!file)
+        {
+            return false;
+        }
+    }
+
+#ifdef ZYCORE_WINDOWS
+    if (!MoveFileExA(tempPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        return false;
+    }
+#else
+    if (std::rename(tempPath.c_str(), m_path.c_str()) != 0)
+    {
+        return false;
+    }
+#endif
+
+    // Our own write is not a change to reload. The file was just written, so it stays racy and
+    // an external write in the same clock tick is still caught by its hash.
+    long long mtime, size;
+    if (statFile(mtime, size))
+    {
+        remember(mtime, size, hashContents(buffer));
+    }
+    return true;
+}
+
+// ============================================================================================== //
+
+} // namespace zycore
+
+#endif // _ZYCORE_PROPERTYSNAPSHOT_HPP_
@@ -0,0 +1,489 @@
+/**
+ * This file is part of the zyan core library (zyantific.com).
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015 Joel Höner (athre0z)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _ZYCORE_PROPERTYTABLE_HPP_
+#define _ZYCORE_PROPERTYTABLE_HPP_
+
+#include "zycore/Utils.hpp"
+#include "zycore/Exceptions.hpp"
+#include "zycore/Optional.hpp"
+
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace zycore
+{
+
+// ============================================================================================== //
+// [PropertyTraits]                                                                               //
+// ============================================================================================== //
+
+/**
+ * @brief   String conversion and type information for property value types.
+ * @tparam  T   The value type.
+ *
+ * Shared by the runtime @c Property implementation and the compile-time @c PropertyTable.
+ */
+template<typename T>
+struct PropertyTraits
+{
+    static_assert(BlackBoxConsts<T>::kFalse,
+        "no property traits found for given type");
+};
+
+#define ZYCORE_NUMERIC_PROPERTY_TRAITS(type, converter)                                            \
+    template<>                                                                                     \
+    struct PropertyTraits<type>                                                                    \
+    {                                                                                              \
+        static type fromString(const std::string& val)                                             \
+        {                                                                                          \
+            try                                                                                    \
+            {                                                                                      \
+                return converter(val);                                                             \
+            } catch (const std::exception&)                                                        \
+            {                                                                                      \
+                throw InvalidUsage("invalid value provided");                                      \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        static std::string toString(const type& val)                                               \
+        {                                                                                          \
+            return std::to_string(val);                                                            \
+        }                                                                                          \
+                                                                                                   \
+        static const std::string& typeName()                                                       \
+        {                                                                                          \
+            static const std::string typeName(#type);                                              \
+            return typeName;                                                                       \
+        }                                                                                          \
+    };
+
+ZYCORE_NUMERIC_PROPERTY_TRAITS(int, std::stoi);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(unsigned int, std::stoul);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(short, (short)std::stoi);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(unsigned short, (unsigned short)std::stoul);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(long, std::stol);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(unsigned long, std::stoul);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(long long, std::stoll);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(unsigned long long, std::stoull);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(float, std::stof);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(double, std::stod);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(long double, std::stold);
+ZYCORE_NUMERIC_PROPERTY_TRAITS(unsigned char, (unsigned char)std::stoul);
+
+#undef ZYCORE_NUMERIC_PROPERTY_TRAITS
+
+template<>
+struct PropertyTraits<bool>
+{
+    static bool fromString(const std::string& val)
+    {
+        return !(val == "false" || val == "0");
+    }
+
+    static std::string toString(const bool& val)
+    {
+        return val ? "true" : "false";
+    }
+
+    static const std::string& typeName()
+    {
+        static const std::string typeName("bool");
+        return typeName;
+    }
+};
+
+template<>
+struct PropertyTraits<std::string>
+{
+    static std::string fromString(const std::string& val)
+    {
+        return val;
+    }
+
+    static std::string toString(const std::string& val)
+    {
+        return val;
+    }
+
+    static const std::string& typeName()
+    {
+        static const std::string typeName("std::string");
+        return typeName;
+    }
+};
+
+// ============================================================================================== //
+// [PropertyDescriptor]                                                                           //
+// ============================================================================================== //
+
+/**
+ * @brief   Compile-time description of a data member exposed as a property.
+ * @tparam  ObjT    The owning class.
+ * @tparam  T       The member's value type.
+ *
+ * Unlike @c Property, a descriptor is not stored in the object and holds no type-erased
+ * accessors: when used from a @c constexpr table, @c get resolves to a plain member access.
+ */
+template<typename ObjT, typename T>
+struct PropertyDescriptor
+{
+    using ObjectType = ObjT;
+    using ValueType = T;
+    using Member = T ObjT::*;
+    using Setter = void (ObjT::*)(const T&);
+
+    const char* name;
+    Member member;
+    Setter setter;
+
+    /**
+     * @brief   Gets the current value of the member.
+     * @param   obj The object to read from.
+     * @return  A constant reference to the member.
+     */
+    constexpr const T& get(const ObjT& obj) const
+    {
+        return obj.*member;
+    }
+
+    /**
+     * @brief   Sets a new value, through the setter if the descriptor has one.
+     * @param   obj         The object to modify.
+     * @param   newValue    The new value.
+     */
+    void set(ObjT& obj, const T& newValue) const
+    {
+        if (setter)
+        {
+            (obj.*setter)(newValue);
+        }
+        else
+        {
+            obj.*member = newValue;
+        }
+    }
+
+    /**
+     * @brief   Gets the type of the property.
+     * @return  The property type.
+     */
+    const std::string& typeName() const
+    {
+        return PropertyTraits<T>::typeName();
+    }
+};
+
+/**
+ * @brief   Creates a descriptor for a data member.
+ * @param   name    The name of the property. Must outlive the descriptor (use literals).
+ * @param   member  The member to represent with this property.
+ * @return  The descriptor.
+ */
+template<typename ObjT, typename T>
+constexpr PropertyDescriptor<ObjT, T> makeProperty(const char* name, T ObjT::* member)
+{
+    return PropertyDescriptor<ObjT, T>{name, member, nullptr};
+}
+
+/**
+ * @overload
+ * @param   setter  Member function called on writes instead of assigning the member, e.g. to
+ *                  validate or clamp the new value. Reads still access the member directly.
+ */
+template<typename ObjT, typename T>
+constexpr PropertyDescriptor<ObjT, T> makeProperty(const char* name, T ObjT::* member,
+    void (ObjT::*setter)(const T&))
+{
+    return PropertyDescriptor<ObjT, T>{name, member, setter};
+}
+
+// ============================================================================================== //
+// [PropertyTable]                                                                                //
+// ============================================================================================== //
+
+/**
+ * @brief   Compile-time table of property descriptors of one class.
+ * @tparam  DescriptorsT    The @c PropertyDescriptor types.
+ *
+ * A class exposes its table through a static @c properties() function:
+ * @code
+ *      class Tuning
+ *      {
+ *          double m_aggression = 1.0;
+ *          int m_maxWorkers = 70;
+ *      public:
+ *          static constexpr auto properties()
+ *          {
+ *              return zycore::makePropertyTable(
+ *                  zycore::makeProperty("aggression", &Tuning::m_aggression),
+ *                  zycore::makeProperty("maxWorkers", &Tuning::m_maxWorkers));
+ *          }
+ *      };
+ * @endcode
+ *
+ * Hot code reads through @c get<I>, which compiles to a direct member access; tooling uses the
+ * by-name interface (@c toString, @c fromString, ...), which scans the names linearly. Objects
+ * carry no per-property state, so constructing them does not allocate.
+ */
+template<typename... DescriptorsT>
+class PropertyTable
+{
+    std::tuple<DescriptorsT...> m_descriptors;
+public:
+    /**
+     * @brief   Constructor.
+     * @param   descriptors The property descriptors.
+     */
+    constexpr explicit PropertyTable(DescriptorsT... descriptors);
+public:
+    /**
+     * @brief   Gets the number of properties in the table.
+     * @return  The number of properties.
+     */
+    static constexpr size_t size();
+    /**
+     * @brief   Gets the descriptor at the given index.
+     * @tparam  I   The index.
+     * @return  The descriptor.
+     */
+    template<size_t I>
+    constexpr const std::tuple_element_t<I, std::tuple<DescriptorsT...>>& descriptor() const;
+    /**
+     * @brief   Gets the value of the property at the given index.
+     * @tparam  I   The index.
+     * @param   obj The object to read from.
+     * @return  A constant reference to the value.
+     */
+    template<size_t I, typename ObjT>
+    constexpr decltype(auto) get(const ObjT& obj) const;
+    /**
+     * @brief   Sets the value of the property at the given index.
+     * @tparam  I           The index.
+     * @param   obj         The object to modify.
+     * @param   newValue    The new value.
+     */
+    template<size_t I, typename ObjT, typename T>
+    void set(ObjT& obj, const T& newValue) const;
+    /**
+     * @brief   Calls a functor with each descriptor, in declaration order.
+     * @param   func    Generic callable accepting any @c PropertyDescriptor.
+     */
+    template<typename FuncT>
+    void forEach(FuncT&& func) const;
+public: // By-name reflection for tooling.
+    /**
+     * @brief   Determines whether a property with the given name exists.
+     * @param   name    The property name.
+     * @return  @c true if found, else @c false.
+     */
+    bool contains(const std::string& name) const;
+    /**
+     * @brief   Gets the names of all properties, in declaration order.
+     * @return  The property names.
+     */
+    std::vector<std::string> names() const;
+    /**
+     * @brief   Obtains the string representation of a property.
+     * @param   obj     The object to read from.
+     * @param   name    The property name.
+     * @return  The property value as string.
+     * @throws  InvalidUsage if no property with the given name exists.
+     */
+    template<typename ObjT>
+    std::string toString(const ObjT& obj, const std::string& name) const;
+    /**
+     * @brief   Sets a property using a string.
+     * @param   obj     The object to modify.
+     * @param   name    The property name.
+     * @param   val     The new value as string.
+     * @throws  InvalidUsage if no property with the given name exists or the value is invalid.
+     */
+    template<typename ObjT>
+    void fromString(ObjT& obj, const std::string& name, const std::string& val) const;
+    /**
+     * @brief   Gets the type of a property.
+     * @param   name    The property name.
+     * @return  The property type.
+     * @throws  InvalidUsage if no property with the given name exists.
+     */
+    const std::string& typeName(const std::string& name) const;
+private:
+    template<typename FuncT, size_t... I>
+    void forEachImpl(FuncT& func, std::index_sequence<I...>) const;
+};
+
+/**
+ * @brief   Creates a property table from descriptors.
+ * @param   descriptors The descriptors, see @c makeProperty.
+ * @return  The table.
+ */
+template<typename... DescriptorsT>
+constexpr PropertyTable<DescriptorsT...> makePropertyTable(DescriptorsT... descriptors)
+{
+    return PropertyTable<DescriptorsT...>(descriptors...);
+}
+
+// ============================================================================================== //
+// Implementation of inline methods [PropertyTable]                                               //
+// ============================================================================================== //
+
+template<typename... DescriptorsT>
+inline constexpr PropertyTable<DescriptorsT...>::PropertyTable(DescriptorsT... descriptors)
+    : m_descriptors(descriptors...)
+{}
+
+template<typename... DescriptorsT>
+inline constexpr size_t PropertyTable<DescriptorsT...>::size()
+{
+    return sizeof...(DescriptorsT);
+}
+
+template<typename... DescriptorsT>
+template<size_t I>
+inline constexpr const std::tuple_element_t<I, std::tuple<DescriptorsT...>>&
+    PropertyTable<DescriptorsT...>::descriptor() const
+{
+    return std::get<I>(m_descriptors);
+}
+
+template<typename... DescriptorsT>
+template<size_t I, typename ObjT>
+inline constexpr decltype(auto) PropertyTable<DescriptorsT...>::get(const ObjT& obj) const
+{
+    return std::get<I>(m_descriptors).get(obj);
+}
+
+template<typename... DescriptorsT>
+template<size_t I, typename ObjT, typename T>
+inline void PropertyTable<DescriptorsT...>::set(ObjT& obj, const T& newValue) const
+{
+    std::get<I>(m_descriptors).set(obj, newValue);
+}
+
+template<typename... DescriptorsT>
+template<typename FuncT, size_t... I>
+inline void PropertyTable<DescriptorsT...>::forEachImpl(
+    FuncT& func, std::index_sequence<I...>) const
+{
+    using Expander = int[];
+    (void)Expander{0, (func(std::get<I>(m_descriptors)), 0)...};
+}
+
+template<typename... DescriptorsT>
+template<typename FuncT>
+inline void PropertyTable<DescriptorsT...>::forEach(FuncT&& func) const
+{
+    forEachImpl(func, std::index_sequence_for<DescriptorsT...>());
+}
+
+template<typename... DescriptorsT>
+inline bool PropertyTable<DescriptorsT...>::contains(const std::string& name) const
+{
+    bool found = false;
+    forEach([&](const auto& desc)
+    {
+        found |= name == desc.name;
+    });
+    return found;
+}
+
+template<typename... DescriptorsT>
+inline std::vector<std::string> PropertyTable<DescriptorsT...>::names() const
+{
+    std::vector<std::string> result;
+    result.reserve(size());
+    forEach([&](const auto& desc)
+    {
+        result.emplace_back(desc.name);
+    });
+    return result;
+}
+
+template<typename... DescriptorsT>
+template<typename ObjT>
+inline std::string PropertyTable<DescriptorsT...>::toString(
+    const ObjT& obj, const std::string& name) const
+{
+    Optional<std::string> result;
+    forEach([&](const auto& desc)
+    {
+        using ValueType = typename std::decay_t<decltype(desc)>::ValueType;
+        if (!result.hasValue() && name == desc.name)
+        {
+            result = PropertyTraits<ValueType>::toString(desc.get(obj));
+        }
+    });
+    if (!result.hasValue())
+    {
+        throw InvalidUsage("unknown property");
+    }
+    return result.release();
+}
+
+template<typename... DescriptorsT>
+template<typename ObjT>
+inline void PropertyTable<DescriptorsT...>::fromString(
+    ObjT& obj, const std::string& name, const std::string& val) const
+{
+    bool found = false;
+    forEach([&](const auto& desc)
+    {
+        using ValueType = typename std::decay_t<decltype(desc)>::ValueType;
+        if (!found && name == desc.name)
+        {
+            found = true;
+            desc.set(obj, PropertyTraits<ValueType>::fromString(val));
+        }
+    });
+    if (!found)
+    {
+        throw InvalidUsage("unknown property");
+    }
+}
+
+template<typename... DescriptorsT>
+inline const std::string& PropertyTable<DescriptorsT...>::typeName(const std::string& name) const
+{
+    const std::string* result = nullptr;
+    forEach([&](const auto& desc)
+    {
+        if (!result && name == desc.name)
+        {
+            result = &desc.typeName();
+        }
+    });
+    if (!result)
+    {
+        throw InvalidUsage("unknown property");
+    }
+    return *result;
+}
+
+// ============================================================================================== //
+
+} // namespace zycore
+
+#endif // _ZYCORE_PROPERTYTABLE_HPP_
@@ -62,6 +62,48 @@ namespace internal
     };
 } // namespace internal
 
+#ifdef ZYCORE_SIGNAL_PROFILING
+
+// ============================================================================================== //
+// [SlotProfiler]                                                                                 //
+// ============================================================================================== //
+
+/**
+ * @brief   Interface notified around every slot call of every signal, used to time slots.
+ *
+ * Only available with @c ZYCORE_SIGNAL_PROFILING defined, which must be the same for all code
+ * including this header. Without it, @c Signal::emit carries no profiling code at all.
+ */
+class SlotProfiler
+{
+public:
+    virtual ~SlotProfiler() = default;
+    /**
+     * @brief   Called right before a slot is called.
+     * @param   signal  The emitting signal.
+     * @param   handle  The handle of the slot's connection.
+     */
+    virtual void onSlotBegin(const internal::SignalBase* signal, SlotHandle handle) = 0;
+    /**
+     * @brief   Called right after a slot returned.
+     * @param   signal  The emitting signal.
+     * @param   handle  The handle of the slot's connection.
+     */
+    virtual void onSlotEnd(const internal::SignalBase* signal, SlotHandle handle) = 0;
+};
+
+/**
+ * @brief   Gets the installed slot profiler.
+ * @return  Reference to the profiler pointer; @c nullptr if none is installed.
+ */
+inline SlotProfiler*& slotProfiler()
+{
+    static SlotProfiler* profiler = nullptr;
+    return profiler;
+}
+
+#endif // ZYCORE_SIGNAL_PROFILING
+
 // ============================================================================================== //
 // [ConnectionBase]                                                                               //
 // ============================================================================================== //
@@ -426,6 +468,19 @@ template<typename... ArgsT>
 inline void Signal<ArgsT...>::emit(ArgsT... args) const
 {
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
+#ifdef ZYCORE_SIGNAL_PROFILING
+    SlotProfiler* profiler = slotProfiler();
+    if (profiler)
+    {
+        for (const auto &cur : m_slots)
+        {
+            profiler->onSlotBegin(this, cur.first);
+            cur.second->call(args...);
+            profiler->onSlotEnd(this, cur.first);
+        }
+        return;
+    }
+#endif
     for (const auto &cur : m_slots)
     {
         cur.second->call(args...);
@@ -25,6 +25,11 @@
 #define _ZYCORE_SINGLETON_HPP_
 
 #include "zycore/Utils.hpp"
+#include "zycore/Exceptions.hpp"
+
+#include <atomic>
+#include <new>
+#include <thread>
 
 namespace zycore
 {
@@ -35,12 +40,31 @@ namespace zycore
 
 /**
  * @brief   Singleton template
- * @todo    Should we free the instance on static shutdown rather than leaking it.
+ *
+ * The instance lives in static storage and goes through explicit lifetime phases:
+ * empty -> constructing -> alive -> destroying -> empty. @c instance constructs it on first use
+ * (thread-safe, at most once per phase cycle) and afterwards costs a single acquire load.
+ * @c freeInstance and @c reset end the current instance, e.g. at the end of a match; callers
+ * must ensure no other thread is still using it at that point. An instance still alive at static
+ * shutdown is destroyed then.
+ *
+ * The constructor and destructor of the instance must not use the singleton themselves; doing so
+ * throws @c InvalidUsage instead of waiting forever for the phase to end.
  */
 template<typename ObjTypeT>
 class Singleton : public NonCopyable
 {
-    static ObjTypeT *m_obj;
+    enum Phase : int
+    {
+        kEmpty,
+        kConstructing,
+        kAlive,
+        kDestroying
+    };
+
+    static std::atomic<int> m_phase;
+    // The thread constructing or destroying the instance, to detect re-entry from there.
+    static std::atomic<std::thread::id> m_transitionThread;
 protected:
     /**
      * @brief   Default constructor.
@@ -52,19 +76,28 @@ public:
      */
     virtual ~Singleton() = default;
     /**
-     * @brief   Gets the instance.
+     * @brief   Gets the instance, constructing it if required.
      * @return  The instance.
      */
     static ObjTypeT& instance();
     /**
-     * @brief   Frees the instance.
+     * @brief   Frees the instance. Does nothing if there is none.
      */
     static void freeInstance();
+    /**
+     * @brief   Replaces the instance by a freshly constructed one.
+     * @return  The new instance.
+     */
+    static ObjTypeT& reset();
     /**
      * @brief   Queries if the singleton has already been instanciated.
      * @return  @c true if instanciated, @c false if not.
      */
     static bool hasInstance();
+private:
+    static ObjTypeT* storage();
+    static ObjTypeT& constructInstance();
+    static void waitForTransition();
 };
 
 // ============================================================================================== //
@@ -72,33 +105,110 @@ public:
 // ============================================================================================== //
 
 template<typename ObjTypeT>
-ObjTypeT *Singleton<ObjTypeT>::m_obj = nullptr;
+std::atomic<int> Singleton<ObjTypeT>::m_phase{kEmpty};
+
+template<typename ObjTypeT>
+std::atomic<std::thread::id> Singleton<ObjTypeT>::m_transitionThread{std::thread::id()};
+
+template<typename ObjTypeT>
+inline ObjTypeT* Singleton<ObjTypeT>::storage()
+{
+    // Trivial type: zero-initialized at load time, no initialization guard involved.
+    alignas(ObjTypeT) static unsigned char storage[sizeof(ObjTypeT)];
+    return reinterpret_cast<ObjTypeT*>(storage);
+}
 
 template<typename ObjTypeT>
 inline ObjTypeT& Singleton<ObjTypeT>::instance()
 {
-    if (!m_obj)
+    if (m_phase.load(std::memory_order_acquire) == kAlive)
+    {
+        return *storage();
+    }
+    return constructInstance();
+}
+
+template<typename ObjTypeT>
+ObjTypeT& Singleton<ObjTypeT>::constructInstance()
+{
+    for (;;)
     {
-        m_obj = new ObjTypeT;
+        int phase = kEmpty;
+        if (m_phase.compare_exchange_strong(phase, kConstructing, std::memory_order_acquire))
+        {
+            m_transitionThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+            try
+            {
+                new (storage()) ObjTypeT;
+            }
+            catch (...)
+            {
+                m_transitionThread.store(std::thread::id(), std::memory_order_relaxed);
+                m_phase.store(kEmpty, std::memory_order_release);
+                throw;
+            }
+            m_transitionThread.store(std::thread::id(), std::memory_order_relaxed);
+
+            // Frees an instance left alive at static shutdown.
+            static const StaticInitializer shutdownGuard(nullptr, &Singleton::freeInstance);
+            (void)shutdownGuard;
+
+            m_phase.store(kAlive, std::memory_order_release);
+            return *storage();
+        }
+        if (phase == kAlive)
+        {
+            return *storage();
+        }
+        waitForTransition();
     }
+}
 
-    return *m_obj;
+template<typename ObjTypeT>
+inline void Singleton<ObjTypeT>::waitForTransition()
+{
+    // Only the transitioning thread itself can observe its own id here.
+    if (m_transitionThread.load(std::memory_order_relaxed) == std::this_thread::get_id())
+    {
+        throw InvalidUsage("singleton used from the constructor or destructor of its instance");
+    }
+    // Another thread is constructing or destroying the instance.
+    std::this_thread::yield();
 }
 
 template<typename ObjTypeT>
 inline void Singleton<ObjTypeT>::freeInstance()
 {
-    if (m_obj)
+    for (;;)
     {
-        delete m_obj;
-        m_obj = nullptr;
+        int phase = kAlive;
+        if (m_phase.compare_exchange_strong(phase, kDestroying, std::memory_order_acquire))
+        {
+            m_transitionThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+            storage()->~ObjTypeT();
+            m_transitionThread.store(std::thread::id(), std::memory_order_relaxed);
+            m_phase.store(kEmpty, std::memory_order_release);
+            return;
+        }
+        if (phase == kEmpty)
+        {
+            return;
+        }
+        waitForTransition();
     }
 }
 
+template<typename ObjTypeT>
+inline ObjTypeT& Singleton<ObjTypeT>::reset()
+{
+    freeInstance();
+    return instance();
+}
+
 template<typename ObjTypeT>
 inline bool Singleton<ObjTypeT>::hasInstance()
 {
-    return m_obj != nullptr;
+    return m_phase.load(std::memory_order_acquire) == kAlive;
 }
 
 // ============================================================================================== //